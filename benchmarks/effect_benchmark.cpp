@@ -0,0 +1,107 @@
+// Compares the native ports of the bundled effects against their Lua
+// scripts. Run from the repository root so scripts/effects resolves.
+
+#include "furious/core/tempo.hpp"
+#include "furious/scripting/script_cache.hpp"
+#include "furious/scripting/script_engine.hpp"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace furious;
+
+namespace {
+
+constexpr int SAMPLES = 200000;
+
+// The engine ignores scripts whose id a native effect already claims, so
+// the scripts are copied under a suffixed id.
+bool copy_script_as(const std::filesystem::path& from, const std::filesystem::path& dir,
+                    const std::string& id, const std::string& new_id) {
+    std::ifstream in(from);
+    if (!in) return false;
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string text = buffer.str();
+
+    std::string needle = "id = \"" + id + "\"";
+    auto pos = text.find(needle);
+    if (pos == std::string::npos) return false;
+    text.replace(pos, needle.size(), "id = \"" + new_id + "\"");
+
+    std::ofstream(dir / (new_id + ".lua")) << text;
+    return true;
+}
+
+double nanoseconds_per_call(ScriptEngine& engine, const TimelineClip& clip, const Tempo& tempo) {
+    EffectContext context;
+    context.clip = &clip;
+    context.tempo = &tempo;
+
+    double checksum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < SAMPLES; ++i) {
+        context.clip_local_beats = i * (1.0 / 16.0);
+        context.current_beats = clip.start_beat + context.clip_local_beats;
+        EffectResult result = engine.evaluate_effects(clip.effects, context);
+        checksum += result.scale_x.value_or(0.0f);
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+
+    // Keeps the loop from being optimised away.
+    if (checksum == 0.123) std::printf(" ");
+    return elapsed.count() / SAMPLES;
+}
+
+} // namespace
+
+int main() {
+    auto dir = std::filesystem::temp_directory_path() / "furious_effect_benchmark";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    const char* ids[] = {"auto_ytpmv", "lerp_transform"};
+    for (const char* id : ids) {
+        if (!copy_script_as(std::filesystem::path("scripts/effects") / (std::string(id) + ".lua"),
+                            dir, id, std::string(id) + "_lua")) {
+            std::fprintf(stderr, "Cannot read scripts/effects/%s.lua\n", id);
+            return 1;
+        }
+    }
+
+    ScriptEngine engine;
+    engine.initialize();
+    engine.script_cache().set_enabled(false);
+    engine.add_effect_directory(dir.string());
+    engine.scan_effect_directories();
+    engine.set_instruction_budget(0);
+
+    Tempo tempo(140.0);
+    std::printf("%-16s %12s %12s %8s\n", "effect", "lua ns/call", "native ns/call", "speedup");
+    for (const char* id : ids) {
+        TimelineClip native_clip;
+        native_clip.id = "clip";
+        ClipEffect effect;
+        effect.effect_id = id;
+        effect.parameters["Flip Horizontal"] = "true";
+        effect.parameters["Easing"] = "ease_in_out_cubic";
+        effect.parameters["Loop"] = "true";
+        native_clip.effects.push_back(effect);
+
+        TimelineClip lua_clip = native_clip;
+        lua_clip.effects[0].effect_id = std::string(id) + "_lua";
+
+        double lua_ns = nanoseconds_per_call(engine, lua_clip, tempo);
+        double native_ns = nanoseconds_per_call(engine, native_clip, tempo);
+        std::printf("%-16s %12.1f %12.1f %7.1fx\n", id, lua_ns, native_ns, lua_ns / native_ns);
+    }
+
+    if (!engine.last_error().empty()) {
+        std::fprintf(stderr, "Last script error: %s\n", engine.last_error().c_str());
+    }
+    std::filesystem::remove_all(dir);
+    return 0;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "furious/ui/main_window.hpp"
+#include <chrono>
 #include <memory>
 
 struct GLFWwindow;
@@ -9,6 +10,14 @@ namespace furious {
 
 class Application {
 public:
+    // Longest an idle editor sleeps before running a frame anyway, so script
+    // hot reload and similar polling still happen.
+    static constexpr double IDLE_WAIT_SECONDS = 0.5;
+
+    // Frames rendered after an event before the loop goes back to waiting;
+    // ImGui needs a few to settle hover and focus changes.
+    static constexpr int IDLE_SETTLE_FRAMES = 3;
+
     Application();
     ~Application();
 
@@ -27,13 +36,20 @@ public:
 
 private:
     GLFWwindow* window_ = nullptr;
+    GLFWwindow* render_context_ = nullptr;  // hidden; shares objects with window_
     std::unique_ptr<MainWindow> main_window_;
     std::string initial_project_;
 
+    std::chrono::duration<double> frame_interval_{1.0 / 60.0};
+    std::chrono::steady_clock::time_point frame_deadline_;
+    int settle_frames_ = IDLE_SETTLE_FRAMES;
+
     bool init_glfw();
     bool init_imgui();
     void begin_frame();
     void end_frame();
+    void wait_for_events();
+    void pace_frame();
 };
 
 } // namespace furious
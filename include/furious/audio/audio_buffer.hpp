@@ -1,29 +1,64 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <expected>
+#include <memory>
 #include <span>
+#include <string>
 #include <vector>
 
 namespace furious {
 
+// In-memory storage format for decoded PCM. Float32 is lossless; Int16 and
+// Float16 halve memory use and are decoded on the fly by the mixer.
+enum class SampleFormat {
+    Float32,
+    Int16,
+    Float16
+};
+
+[[nodiscard]] size_t bytes_per_sample(SampleFormat format);
+
 class AudioBuffer {
 public:
     AudioBuffer() = default;
-    AudioBuffer(std::vector<float> samples, uint32_t sample_rate, uint32_t channels);
+    AudioBuffer(std::vector<float> samples, uint32_t sample_rate, uint32_t channels,
+                SampleFormat format = SampleFormat::Float32);
+
+    // Maps a PCM file written by write_file() read-only; pages are loaded on demand.
+    [[nodiscard]] static std::expected<AudioBuffer, std::string> map_file(const std::string& filepath);
+    std::expected<void, std::string> write_file(const std::string& filepath) const;
 
+    // Float32 buffers only; compact buffers return an empty span.
     [[nodiscard]] std::span<const float> samples() const;
+    [[nodiscard]] SampleFormat format() const { return format_; }
     [[nodiscard]] uint32_t sample_rate() const { return sample_rate_; }
     [[nodiscard]] uint32_t channels() const { return channels_; }
     [[nodiscard]] uint64_t frame_count() const;
     [[nodiscard]] double duration_seconds() const;
-    [[nodiscard]] bool empty() const { return samples_.empty(); }
+    [[nodiscard]] bool empty() const { return sample_count() == 0; }
+    [[nodiscard]] size_t sample_count() const;
+    [[nodiscard]] size_t size_bytes() const;
+    [[nodiscard]] bool is_mapped() const;
 
     [[nodiscard]] float sample_at(uint64_t frame, uint32_t channel) const;
 
+    // Adds frame_count frames starting at start_frame into an interleaved
+    // stereo destination. Mono sources are duplicated to both channels.
+    void mix_stereo(uint64_t start_frame, uint64_t frame_count, float gain, float* out) const;
+
+    [[nodiscard]] AudioBuffer converted(SampleFormat format) const;
+
 private:
-    std::vector<float> samples_;
+    struct Storage;
+
+    std::shared_ptr<const Storage> storage_;
+    SampleFormat format_ = SampleFormat::Float32;
     uint32_t sample_rate_ = 44100;
     uint32_t channels_ = 2;
+
+    [[nodiscard]] const std::byte* data() const;
 };
 
 }
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "furious/audio/audio_buffer.hpp"
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace furious {
+
+// On-disk cache of decoded source audio. Entries are raw PCM files keyed by
+// source path, size, modification time and sample format, and are memory
+// mapped on load so re-opening a project skips decoding entirely.
+class AudioCache {
+public:
+    AudioCache();
+    explicit AudioCache(std::filesystem::path directory);
+
+    [[nodiscard]] const std::filesystem::path& directory() const { return directory_; }
+    void set_directory(std::filesystem::path directory) { directory_ = std::move(directory); }
+
+    [[nodiscard]] bool enabled() const { return enabled_; }
+    void set_enabled(bool enabled) { enabled_ = enabled; }
+
+    // Empty when the source file cannot be stat'ed.
+    [[nodiscard]] std::filesystem::path entry_path(const std::string& source_path, SampleFormat format,
+                                                   uint32_t sample_rate, uint32_t channels) const;
+
+    [[nodiscard]] std::shared_ptr<const AudioBuffer> load(const std::string& source_path, SampleFormat format,
+                                                          uint32_t sample_rate, uint32_t channels) const;
+
+    // Writes the buffer and returns the mapped copy, or nullptr if the entry
+    // could not be written.
+    std::shared_ptr<const AudioBuffer> store(const std::string& source_path, const AudioBuffer& buffer) const;
+
+    static std::filesystem::path default_directory();
+
+private:
+    std::filesystem::path directory_;
+    bool enabled_ = true;
+};
+
+} // namespace furious
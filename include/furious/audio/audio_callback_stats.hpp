@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace furious {
+
+// Timing of the real-time audio callback. record() is wait-free and only
+// touches relaxed atomics, so it is safe to call from the device thread;
+// snapshot() runs on the UI thread and copies whatever has been published.
+class AudioCallbackStats {
+public:
+    static constexpr size_t CAPACITY = 512;
+
+    struct Snapshot {
+        std::array<float, CAPACITY> load_history{};  // elapsed / period, oldest first
+        size_t history_count = 0;
+        float last_load = 0.0f;
+        float p50_us = 0.0f;
+        float p99_us = 0.0f;
+        float max_us = 0.0f;
+        float period_us = 0.0f;
+        uint64_t callbacks = 0;
+        uint64_t late_callbacks = 0;
+        uint64_t xruns = 0;
+        uint32_t active_clips = 0;
+    };
+
+    // start_us is the callback entry time on a monotonic clock. A gap between
+    // successive entries well beyond one period means the device starved.
+    void record(int64_t start_us, float elapsed_us, float period_us, uint32_t active_clips);
+    void reset();
+
+    [[nodiscard]] Snapshot snapshot() const;
+
+    [[nodiscard]] uint64_t callbacks() const { return callbacks_.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t late_callbacks() const { return late_callbacks_.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t xruns() const { return xruns_.load(std::memory_order_relaxed); }
+
+private:
+    std::array<std::atomic<float>, CAPACITY> elapsed_us_{};
+    std::array<std::atomic<float>, CAPACITY> period_us_{};
+    std::atomic<uint64_t> callbacks_{0};
+    std::atomic<uint64_t> late_callbacks_{0};
+    std::atomic<uint64_t> xruns_{0};
+    std::atomic<uint32_t> active_clips_{0};
+    std::atomic<int64_t> last_start_us_{-1};
+    std::atomic<float> last_period_us_{0.0f};
+};
+
+} // namespace furious
@@ -1,40 +1,55 @@
 #pragma once
 
 #include <string>
-#include <vector>
+#include <memory>
 #include <cstdint>
 
 namespace furious {
 
+// Backing track streamed from disk. A reader thread decodes ahead of the
+// playhead into a fixed-size ring buffer, so loading is immediate and memory
+// use does not grow with the length of the file.
 class AudioClip {
 public:
-    AudioClip() = default;
-    ~AudioClip() = default;
+    static constexpr uint32_t OUTPUT_SAMPLE_RATE = 44100;
+    static constexpr uint32_t OUTPUT_CHANNELS = 2;
+    static constexpr double READ_AHEAD_SECONDS = 2.0;
+
+    AudioClip();
+    ~AudioClip();
 
     AudioClip(const AudioClip&) = delete;
     AudioClip& operator=(const AudioClip&) = delete;
-    AudioClip(AudioClip&&) noexcept = default;
-    AudioClip& operator=(AudioClip&&) noexcept = default;
 
     bool load(const std::string& filepath);
     void unload();
 
-    [[nodiscard]] bool is_loaded() const { return !samples_.empty(); }
+    [[nodiscard]] bool is_loaded() const { return stream_ != nullptr; }
     [[nodiscard]] const std::string& filepath() const { return filepath_; }
     [[nodiscard]] uint32_t sample_rate() const { return sample_rate_; }
     [[nodiscard]] uint32_t channels() const { return channels_; }
-    [[nodiscard]] uint64_t total_frames() const { return total_frames_; }
+    // Starts as the container's estimate, which VBR files and files with
+    // no reliable duration get wrong; corrected once the reader reaches the
+    // end of the stream.
+    [[nodiscard]] uint64_t total_frames() const;
+    [[nodiscard]] bool length_is_exact() const;
     [[nodiscard]] double duration_seconds() const;
 
-    [[nodiscard]] const float* data() const { return samples_.data(); }
-    [[nodiscard]] size_t sample_count() const { return samples_.size(); }
+    // Called from the audio thread. Adds up to frame_count stereo frames
+    // starting at source frame `frame` into out and returns how many were
+    // available. A position outside the buffered window schedules a seek and
+    // yields silence until the reader catches up.
+    uint32_t mix_into(uint64_t frame, uint32_t frame_count, float* out) const;
+
+    [[nodiscard]] uint64_t buffered_frames() const;
 
 private:
+    struct Stream;
+    std::unique_ptr<Stream> stream_;
+
     std::string filepath_;
-    std::vector<float> samples_;
     uint32_t sample_rate_ = 0;
     uint32_t channels_ = 0;
-    uint64_t total_frames_ = 0;
 };
 
 } // namespace furious
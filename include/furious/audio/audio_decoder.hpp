@@ -24,8 +24,21 @@ public:
     [[nodiscard]] bool has_audio_stream() const;
     [[nodiscard]] double duration_seconds() const;
 
+    // Files longer than ~30 s are split into seekable segments decoded in
+    // parallel; max_threads = 0 uses every hardware thread, 1 forces a
+    // single sequential pass.
     std::expected<AudioBuffer, std::string> extract_all(uint32_t target_sample_rate = 44100,
-                                                         uint32_t target_channels = 2);
+                                                         uint32_t target_channels = 2,
+                                                         SampleFormat format = SampleFormat::Float32,
+                                                         unsigned max_threads = 0);
+
+    // Sequential decoding for streaming playback. prepare_stream() sets the
+    // output format; read_frames() then yields interleaved float frames from
+    // the current position and returns fewer than requested only at the end.
+    std::expected<void, std::string> prepare_stream(uint32_t target_sample_rate = 44100,
+                                                    uint32_t target_channels = 2);
+    size_t read_frames(float* out, size_t frame_count);
+    bool seek_frame(uint64_t frame);
 
 private:
     struct Impl;
@@ -2,6 +2,7 @@
 
 #include "furious/audio/audio_clip.hpp"
 #include "furious/audio/audio_buffer.hpp"
+#include "furious/audio/audio_callback_stats.hpp"
 #include <memory>
 #include <atomic>
 #include <mutex>
@@ -58,7 +59,9 @@ public:
     void set_clip_start_seconds(double seconds);
     void set_clip_end_seconds(double seconds);
     [[nodiscard]] double clip_start_seconds() const { return clip_start_seconds_; }
-    [[nodiscard]] double clip_end_seconds() const { return clip_end_seconds_; }
+    // An end at or past the clip's length follows it as the length estimate
+    // is corrected.
+    [[nodiscard]] double clip_end_seconds() const;
     [[nodiscard]] double trimmed_duration_seconds() const;
     void reset_clip_bounds();
 
@@ -74,6 +77,9 @@ public:
     void swap_active_clips_if_pending();
     [[nodiscard]] const std::vector<ClipAudioState>& active_clips() const { return active_clips_front_; }
 
+    [[nodiscard]] AudioCallbackStats& callback_stats() { return callback_stats_; }
+    [[nodiscard]] const AudioCallbackStats& callback_stats() const { return callback_stats_; }
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
@@ -89,12 +95,15 @@ private:
     uint32_t sample_rate_ = 44100;
     std::atomic<double> clip_start_seconds_{0.0};
     std::atomic<double> clip_end_seconds_{0.0};
+    std::atomic<bool> clip_end_at_length_{false};
 
     std::vector<ClipAudioState> active_clips_front_;
     std::vector<ClipAudioState> active_clips_back_;
     std::atomic<bool> clips_swap_pending_{false};
     mutable std::mutex clips_mutex_;
 
+    AudioCallbackStats callback_stats_;
+
     void generate_click_sounds();
 };
 
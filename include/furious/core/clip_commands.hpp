@@ -67,15 +67,11 @@ public:
         , action_name_(std::move(action_name)) {}
 
     void execute() override {
-        if (TimelineClip* clip = data_.find_clip(clip_id_)) {
-            *clip = new_state_;
-        }
+        data_.update_clip(clip_id_, new_state_);
     }
 
     void undo() override {
-        if (TimelineClip* clip = data_.find_clip(clip_id_)) {
-            *clip = old_state_;
-        }
+        data_.update_clip(clip_id_, old_state_);
     }
 
     [[nodiscard]] std::string description() const override {
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace furious {
@@ -14,6 +15,25 @@ public:
     [[nodiscard]] virtual std::string description() const = 0;
 };
 
+// Several commands applied and undone as one history entry. Undo walks the
+// parts in reverse.
+class CompoundCommand : public Command {
+public:
+    explicit CompoundCommand(std::string description) : description_(std::move(description)) {}
+
+    void add(std::unique_ptr<Command> cmd) { commands_.push_back(std::move(cmd)); }
+    [[nodiscard]] bool empty() const { return commands_.empty(); }
+    [[nodiscard]] size_t size() const { return commands_.size(); }
+
+    void execute() override;
+    void undo() override;
+    [[nodiscard]] std::string description() const override { return description_; }
+
+private:
+    std::string description_;
+    std::vector<std::unique_ptr<Command>> commands_;
+};
+
 class CommandHistory {
 public:
     void execute(std::unique_ptr<Command> cmd);
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace furious {
+
+// Dense integer stand-in for a string id. The index addresses per-handle
+// tables directly; the generation is drawn fresh each time an index is
+// issued, so handles kept past a release, a clear() or from another table
+// never resolve.
+template<typename Tag>
+struct Handle {
+    static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+    uint32_t index = INVALID_INDEX;
+    uint32_t generation = 0;
+
+    [[nodiscard]] bool is_valid() const { return index != INVALID_INDEX; }
+    bool operator==(const Handle&) const = default;
+};
+
+struct ClipTag;
+struct SourceTag;
+struct PatternTag;
+
+using ClipHandle = Handle<ClipTag>;
+using SourceHandle = Handle<SourceTag>;
+using PatternHandle = Handle<PatternTag>;
+
+// Interns string ids and maps each handle to the slot its owner stores the
+// object in. Owners rebind every live object after a removal and then call
+// release_unbound(), which frees the indices of ids left without a slot for
+// reuse; state cached per handle elsewhere goes stale with them and should
+// be pruned against the owner.
+template<typename Tag>
+class HandleTable {
+public:
+    using HandleType = Handle<Tag>;
+
+    static constexpr size_t NO_SLOT = std::numeric_limits<size_t>::max();
+
+    HandleType intern(std::string_view id) {
+        auto it = ids_.find(id);
+        if (it != ids_.end()) {
+            return {it->second, entries_[it->second].generation};
+        }
+        uint32_t index;
+        if (!free_.empty()) {
+            index = free_.back();
+            free_.pop_back();
+        } else {
+            index = static_cast<uint32_t>(entries_.size());
+            entries_.emplace_back();
+        }
+        entries_[index] = Entry{NO_SLOT, next_generation()};
+        ids_.emplace(std::string(id), index);
+        return {index, entries_[index].generation};
+    }
+
+    [[nodiscard]] HandleType find(std::string_view id) const {
+        auto it = ids_.find(id);
+        if (it == ids_.end()) return {};
+        return {it->second, entries_[it->second].generation};
+    }
+
+    [[nodiscard]] bool is_current(HandleType handle) const {
+        return handle.index < entries_.size() && handle.generation != 0 &&
+               entries_[handle.index].generation == handle.generation;
+    }
+
+    [[nodiscard]] size_t slot(HandleType handle) const {
+        return is_current(handle) ? entries_[handle.index].slot : NO_SLOT;
+    }
+
+    void bind(HandleType handle, size_t slot) {
+        if (is_current(handle)) {
+            entries_[handle.index].slot = slot;
+        }
+    }
+
+    void unbind_all() {
+        for (auto& entry : entries_) {
+            entry.slot = NO_SLOT;
+        }
+    }
+
+    void release_unbound() {
+        for (auto it = ids_.begin(); it != ids_.end();) {
+            Entry& entry = entries_[it->second];
+            if (entry.slot != NO_SLOT) {
+                ++it;
+                continue;
+            }
+            entry.generation = 0;
+            free_.push_back(it->second);
+            it = ids_.erase(it);
+        }
+    }
+
+    void clear() {
+        ids_.clear();
+        entries_.clear();
+        free_.clear();
+    }
+
+    // Indices issued so far, live or free; per-handle tables need this many slots.
+    [[nodiscard]] size_t size() const { return entries_.size(); }
+    [[nodiscard]] size_t live_count() const { return ids_.size(); }
+
+private:
+    struct IdHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view id) const { return std::hash<std::string_view>{}(id); }
+    };
+
+    struct Entry {
+        size_t slot = NO_SLOT;
+        uint32_t generation = 0;  // 0 while the index is free
+    };
+
+    std::vector<Entry> entries_;
+    std::vector<uint32_t> free_;
+    std::unordered_map<std::string, uint32_t, IdHash, std::equal_to<>> ids_;
+
+    static uint32_t next_generation() {
+        static std::atomic<uint32_t> counter{1};
+        uint32_t generation = counter.fetch_add(1, std::memory_order_relaxed);
+        return generation != 0 ? generation : counter.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+// Per-handle storage indexed by handle.index. Entries written under an older
+// generation are treated as absent and get replaced on the next insert;
+// prune() drops them eagerly once their handles are released.
+template<typename Tag, typename T>
+class HandleMap {
+public:
+    using HandleType = Handle<Tag>;
+
+    [[nodiscard]] T* find(HandleType handle) {
+        if (!handle.is_valid() || handle.index >= slots_.size()) return nullptr;
+        auto& slot = slots_[handle.index];
+        if (!slot.value || slot.generation != handle.generation) return nullptr;
+        return &*slot.value;
+    }
+
+    [[nodiscard]] const T* find(HandleType handle) const {
+        return const_cast<HandleMap*>(this)->find(handle);
+    }
+
+    [[nodiscard]] bool contains(HandleType handle) const { return find(handle) != nullptr; }
+
+    // Returns whatever previously occupied the index so owners can release it.
+    std::optional<T> replace(HandleType handle, T value) {
+        if (!handle.is_valid()) return std::nullopt;
+        if (handle.index >= slots_.size()) {
+            slots_.resize(handle.index + 1);
+        }
+        auto& slot = slots_[handle.index];
+        std::optional<T> previous = std::exchange(slot.value, std::move(value));
+        slot.generation = handle.generation;
+        if (!previous) ++count_;
+        return previous;
+    }
+
+    T& operator[](HandleType handle) {
+        if (T* existing = find(handle)) return *existing;
+        replace(handle, T{});
+        return *find(handle);
+    }
+
+    void erase(HandleType handle) {
+        if (find(handle)) {
+            slots_[handle.index].value.reset();
+            --count_;
+        }
+    }
+
+    template<typename Fn>
+    void for_each(Fn&& fn) {
+        for (auto& slot : slots_) {
+            if (slot.value) fn(*slot.value);
+        }
+    }
+
+    template<typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const auto& slot : slots_) {
+            if (slot.value) fn(*slot.value);
+        }
+    }
+
+    template<typename Pred>
+    void erase_if(Pred&& pred) {
+        for (auto& slot : slots_) {
+            if (slot.value && pred(*slot.value)) {
+                slot.value.reset();
+                --count_;
+            }
+        }
+    }
+
+    // Erases every entry whose handle is_live rejects, passing its value to
+    // release first, and trims trailing empty slots.
+    template<typename Live, typename Release>
+    void prune(Live&& is_live, Release&& release) {
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            auto& slot = slots_[i];
+            if (slot.value && !is_live(HandleType{static_cast<uint32_t>(i), slot.generation})) {
+                release(*slot.value);
+                slot.value.reset();
+                --count_;
+            }
+        }
+        while (!slots_.empty() && !slots_.back().value) {
+            slots_.pop_back();
+        }
+    }
+
+    template<typename Live>
+    void prune(Live&& is_live) {
+        prune(std::forward<Live>(is_live), [](T&) {});
+    }
+
+    void clear() {
+        slots_.clear();
+        count_ = 0;
+    }
+
+    [[nodiscard]] size_t size() const { return count_; }
+    [[nodiscard]] bool empty() const { return count_ == 0; }
+
+private:
+    struct Slot {
+        uint32_t generation = 0;
+        std::optional<T> value;
+    };
+
+    std::vector<Slot> slots_;
+    size_t count_ = 0;
+};
+
+} // namespace furious
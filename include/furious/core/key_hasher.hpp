@@ -0,0 +1,55 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace furious {
+
+// FNV-1a over the values that make up a cache key. Strings are terminated so
+// adjacent fields cannot run into each other.
+class KeyHasher {
+public:
+    void add(std::string_view text) {
+        for (char c : text) {
+            mix(static_cast<uint8_t>(c));
+        }
+        mix(0);
+    }
+
+    void add(uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            mix(static_cast<uint8_t>(value >> (i * 8)));
+        }
+    }
+
+    void add(double value) { add(std::bit_cast<uint64_t>(value)); }
+    void add(float value) { add(static_cast<uint64_t>(std::bit_cast<uint32_t>(value))); }
+
+    // Each entry is hashed on its own and the results summed, so two maps
+    // with the same contents hash alike whatever their iteration order.
+    void add(const std::unordered_map<std::string, std::string>& entries) {
+        uint64_t sum = 0;
+        for (const auto& [name, value] : entries) {
+            KeyHasher entry;
+            entry.add(name);
+            entry.add(value);
+            sum += entry.value();
+        }
+        add(sum);
+    }
+
+    [[nodiscard]] uint64_t value() const { return hash_; }
+
+private:
+    uint64_t hash_ = 14695981039346656037ull;
+
+    void mix(uint8_t byte) {
+        hash_ ^= byte;
+        hash_ *= 1099511628211ull;
+    }
+};
+
+} // namespace furious
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace furious {
+
+// Fixed-capacity map that evicts the least recently used entry once full.
+// find() counts as a use. Not thread-safe.
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+    explicit LruCache(size_t capacity) : capacity_(capacity) {}
+
+    [[nodiscard]] Value* find(const Key& key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) return nullptr;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return &it->second->second;
+    }
+
+    Value& insert(const Key& key, Value value) {
+        if (auto it = index_.find(key); it != index_.end()) {
+            entries_.splice(entries_.begin(), entries_, it->second);
+            it->second->second = std::move(value);
+            return it->second->second;
+        }
+
+        if (capacity_ > 0 && entries_.size() >= capacity_) {
+            // Reuse the evicted node rather than freeing and reallocating it.
+            index_.erase(entries_.back().first);
+            entries_.splice(entries_.begin(), entries_, std::prev(entries_.end()));
+            entries_.front() = {key, std::move(value)};
+        } else {
+            entries_.emplace_front(key, std::move(value));
+        }
+        index_.emplace(key, entries_.begin());
+        return entries_.front().second;
+    }
+
+    void clear() {
+        entries_.clear();
+        index_.clear();
+    }
+
+    [[nodiscard]] size_t size() const { return entries_.size(); }
+    [[nodiscard]] size_t capacity() const { return capacity_; }
+
+private:
+    using Entry = std::pair<Key, Value>;
+
+    size_t capacity_;
+    std::list<Entry> entries_;
+    std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> index_;
+};
+
+} // namespace furious
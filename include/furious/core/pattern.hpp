@@ -1,5 +1,9 @@
 #pragma once
 
+#include "furious/core/handle.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <vector>
@@ -16,12 +20,16 @@ enum class PatternTargetProperty {
     FlipV
 };
 
+constexpr size_t PATTERN_PROPERTY_COUNT = 7;
+
 struct PatternTrigger {
     int subdivision_index = 0;
     PatternTargetProperty target = PatternTargetProperty::ScaleX;
     float value = 1.0f;
 };
 
+struct CompiledPattern;
+
 struct PatternPropertySettings {
     bool restart_on_trigger = false;
 };
@@ -43,12 +51,39 @@ struct Pattern {
     [[nodiscard]] PatternPropertySettings& settings_for(PatternTargetProperty prop);
     [[nodiscard]] const PatternPropertySettings& settings_for(PatternTargetProperty prop) const;
     [[nodiscard]] std::optional<float> value_at(int subdivision, PatternTargetProperty prop) const;
+
+    [[nodiscard]] CompiledPattern compile() const;
+};
+
+// Lookup tables built from a Pattern so evaluation is a few array loads per
+// subdivision instead of scans over the triggers.
+struct CompiledPattern {
+    int length_subdivisions = 0;
+    std::array<bool, PATTERN_PROPERTY_COUNT> has_property{};
+
+    // Held value per [subdivision * PATTERN_PROPERTY_COUNT + property].
+    std::vector<float> held_values;
+
+    // Per subdivision: a restart trigger fires here, and the restart
+    // interval the subdivision falls in.
+    bool has_restarts = false;
+    std::vector<uint8_t> restarts;
+    std::vector<int> loop_start;
+    std::vector<int> loop_interval;
+
+    [[nodiscard]] bool empty() const { return length_subdivisions <= 0; }
+    [[nodiscard]] const float* held_at(int subdivision) const {
+        return held_values.data() + static_cast<size_t>(subdivision) * PATTERN_PROPERTY_COUNT;
+    }
 };
 
 struct ClipPatternReference {
     std::string pattern_id;
     bool enabled = true;
     int offset_subdivisions = 0;
+
+    // Lookup cache for pattern_id; not serialized, revalidated by PatternLibrary.
+    mutable PatternHandle pattern_handle;
 };
 
 } // namespace furious
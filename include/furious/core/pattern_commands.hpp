@@ -68,15 +68,11 @@ public:
         , action_name_(std::move(action_name)) {}
 
     void execute() override {
-        if (Pattern* pattern = library_.find_pattern(pattern_id_)) {
-            *pattern = new_state_;
-        }
+        library_.update_pattern(pattern_id_, new_state_);
     }
 
     void undo() override {
-        if (Pattern* pattern = library_.find_pattern(pattern_id_)) {
-            *pattern = old_state_;
-        }
+        library_.update_pattern(pattern_id_, old_state_);
     }
 
     [[nodiscard]] std::string description() const override {
@@ -111,6 +107,7 @@ public:
                     return r.pattern_id == pattern_id_;
                 });
             }
+            data_.mark_modified();
         }
     }
 
@@ -125,6 +122,7 @@ public:
                 ref.pattern_id = pattern_id_;
                 clip->patterns.push_back(ref);
             }
+            data_.mark_modified();
         }
     }
 
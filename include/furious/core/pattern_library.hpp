@@ -1,6 +1,9 @@
 #pragma once
 
+#include "furious/core/handle.hpp"
 #include "furious/core/pattern.hpp"
+#include <cstdint>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -17,9 +20,27 @@ public:
 
     [[nodiscard]] Pattern* find_pattern(std::string_view pattern_id);
     [[nodiscard]] const Pattern* find_pattern(std::string_view pattern_id) const;
+    [[nodiscard]] Pattern* find_pattern(PatternHandle handle);
+    [[nodiscard]] const Pattern* find_pattern(PatternHandle handle) const;
+
+    [[nodiscard]] PatternHandle handle_of(std::string_view pattern_id) const { return handles_.find(pattern_id); }
+
+    // Lookups have no side effects. Anything that edits a pattern in place
+    // calls mark_pattern_modified() afterwards; update_pattern() replaces
+    // one wholesale and does so itself.
+    void update_pattern(std::string_view pattern_id, const Pattern& state);
+    void mark_pattern_modified(std::string_view pattern_id);
+
+    // Resolves through the handle cached on the reference.
+    [[nodiscard]] const Pattern* find_pattern(const ClipPatternReference& ref) const;
+
+    // Compiled on first use and kept until the pattern is marked modified.
+    [[nodiscard]] const CompiledPattern* compiled_pattern(const ClipPatternReference& ref) const;
+
+    // Changes whenever the referenced pattern may have changed; 0 if missing.
+    [[nodiscard]] uint64_t pattern_revision(const ClipPatternReference& ref) const;
 
     [[nodiscard]] const std::vector<Pattern>& patterns() const { return patterns_; }
-    [[nodiscard]] std::vector<Pattern>& patterns() { return patterns_; }
     [[nodiscard]] size_t pattern_count() const { return patterns_.size(); }
 
     void clear();
@@ -30,6 +51,13 @@ public:
 
 private:
     std::vector<Pattern> patterns_;
+    HandleTable<PatternTag> handles_;
+    mutable std::vector<std::optional<CompiledPattern>> compiled_;  // parallel to patterns_
+    std::vector<uint64_t> revisions_;                                // parallel to patterns_
+    uint64_t next_revision_ = 1;
+
+    void bind_handle(size_t pattern);
+    void rebind_handles();
 };
 
 } // namespace furious
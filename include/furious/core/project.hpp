@@ -22,6 +22,11 @@ public:
     [[nodiscard]] double fps() const { return fps_; }
     void set_fps(double fps) { fps_ = fps; }
 
+    // Output resolution in pixels; clip positions are in this space.
+    [[nodiscard]] int width() const { return width_; }
+    [[nodiscard]] int height() const { return height_; }
+    void set_resolution(int width, int height);
+
     [[nodiscard]] bool snap_enabled() const { return snap_enabled_; }
     void set_snap_enabled(bool enabled) { snap_enabled_ = enabled; }
 
@@ -30,6 +35,8 @@ private:
     Tempo tempo_;
     NoteSubdivision grid_subdivision_ = NoteSubdivision::Quarter;
     double fps_ = 30.0;
+    int width_ = 1920;
+    int height_ = 1080;
     bool snap_enabled_ = true;
 };
 
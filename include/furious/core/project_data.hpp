@@ -1,5 +1,6 @@
 #pragma once
 
+#include "furious/audio/audio_buffer.hpp"
 #include "furious/core/media_source.hpp"
 #include "furious/core/pattern.hpp"
 #include "furious/core/tempo.hpp"
@@ -15,6 +16,8 @@ struct ProjectData {
     double bpm = 120.0;
     NoteSubdivision grid_subdivision = NoteSubdivision::Quarter;
     double fps = 30.0;
+    int output_width = 1920;
+    int output_height = 1080;
     bool metronome_enabled = false;
     bool follow_playhead = true;
     bool loop_enabled = false;
@@ -29,6 +32,7 @@ struct ProjectData {
     std::string audio_filepath;
     double clip_start_seconds = 0.0;
     double clip_end_seconds = 0.0;
+    SampleFormat audio_sample_format = SampleFormat::Float32;
 
     std::vector<MediaSource> sources;
     std::vector<Track> tracks;
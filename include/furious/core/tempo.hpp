@@ -16,6 +16,7 @@ public:
 
     void set_bpm(double bpm);
     [[nodiscard]] double bpm() const;
+    [[nodiscard]] uint64_t generation() const { return generation_; }  // bumped when the BPM changes
 
     [[nodiscard]] double beat_duration_seconds() const;
     [[nodiscard]] double subdivision_duration_seconds(NoteSubdivision subdivision) const;
@@ -27,6 +28,7 @@ public:
 
 private:
     double bpm_;
+    uint64_t generation_ = 0;
 };
 
 } // namespace furious
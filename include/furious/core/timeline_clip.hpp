@@ -1,5 +1,6 @@
 #pragma once
 
+#include "furious/core/handle.hpp"
 #include "furious/core/pattern.hpp"
 #include <string>
 #include <vector>
@@ -31,6 +32,9 @@ struct TimelineClip {
     std::vector<ClipEffect> effects;
     std::vector<ClipPatternReference> patterns;
 
+    // Lookup cache for source_id; not serialized, revalidated by SourceLibrary.
+    mutable SourceHandle source_handle;
+
     [[nodiscard]] double end_beat() const { return start_beat + duration_beats; }
 
     [[nodiscard]] bool contains_beat(double beat) const {
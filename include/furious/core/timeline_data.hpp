@@ -1,8 +1,13 @@
 #pragma once
 
+#include "furious/core/handle.hpp"
 #include "furious/core/track.hpp"
 #include "furious/core/timeline_clip.hpp"
 #include "furious/core/media_source.hpp"
+#include "furious/core/timeline_snapshot.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
 #include <string_view>
@@ -26,17 +31,49 @@ public:
     [[nodiscard]] bool has_clips_using_source(std::string_view source_id) const;
     [[nodiscard]] TimelineClip* find_clip(std::string_view clip_id);
     [[nodiscard]] const TimelineClip* find_clip(std::string_view clip_id) const;
+    [[nodiscard]] TimelineClip* find_clip(ClipHandle handle);
+    [[nodiscard]] const TimelineClip* find_clip(ClipHandle handle) const;
 
+    // Handles are interned per clip id and released when the clip is
+    // removed; a clip re-added by undo gets a fresh one. Copies of a clip
+    // resolve to the same handle.
+    [[nodiscard]] ClipHandle handle_of(const TimelineClip& clip) const;
+
+    // Start, duration and track are indexed, so they change only through
+    // these; writing them through a clip pointer leaves the index stale.
+    void set_clip_span(std::string_view clip_id, double start_beat, double duration_beats,
+                       size_t track_index);
+    void update_clip(std::string_view clip_id, const TimelineClip& state);
+
+    // Queries go through a per-track index of clips sorted by start with a
+    // running maximum of end beats. A binary search finds the last clip that
+    // starts in range and the scan back stops once no earlier clip can still
+    // reach it; one long clip early on keeps that scan going, so the worst
+    // case is linear per track. Bulk edits outside the setters above must
+    // call invalidate_index().
     [[nodiscard]] std::vector<TimelineClip*> clips_at_beat(double beat);
+    [[nodiscard]] std::vector<TimelineClip*> clips_in_range(double start_beat, double end_beat);
     [[nodiscard]] std::vector<TimelineClip*> clips_starting_between(double start_beat, double end_beat);
     [[nodiscard]] std::vector<TimelineClip*> clips_on_track(size_t track_index);
     [[nodiscard]] std::vector<const TimelineClip*> clips_on_track(size_t track_index) const;
     [[nodiscard]] size_t find_available_track(double start_beat, double duration_beats) const;
 
     [[nodiscard]] const std::vector<TimelineClip>& clips() const { return clips_; }
-    [[nodiscard]] std::vector<TimelineClip>& clips() { return clips_; }
 
     void for_each_clip(std::function<void(TimelineClip&)> fn);
+    void invalidate_index() { index_dirty_ = true; ++generation_; }
+
+    // Bumped by every structural change and span edit. Edits to a clip's
+    // other fields in place are only seen once mark_modified() is called.
+    [[nodiscard]] uint64_t generation() const { return generation_; }
+    void mark_modified() { ++generation_; }
+
+    // Publishes an immutable copy of the timeline for other threads if the
+    // generation moved since the last call. Call from the editing thread
+    // once edits settle, e.g. after a command; snapshot() is safe from any
+    // thread and returns null until the first publish.
+    void publish_snapshot();
+    [[nodiscard]] std::shared_ptr<const TimelineSnapshot> snapshot() const;
 
     void set_tracks(const std::vector<Track>& tracks);
     void set_clips(const std::vector<TimelineClip>& clips);
@@ -48,8 +85,42 @@ public:
     static std::string generate_id();
 
 private:
+    struct IndexEntry {
+        double start = 0.0;
+        double end = 0.0;
+        size_t clip = 0;
+    };
+
+    struct TrackIndex {
+        std::vector<IndexEntry> entries;  // sorted by start
+        std::vector<double> max_end;      // max end over entries[0..i]
+    };
+
     std::vector<Track> tracks_;
     std::vector<TimelineClip> clips_;
+
+    HandleTable<ClipTag> handles_;
+    std::vector<ClipHandle> clip_handles_;  // parallel to clips_
+
+    mutable std::vector<TrackIndex> track_index_;
+    mutable std::vector<IndexEntry> indexed_spans_;  // per clip, as last indexed
+    mutable std::vector<size_t> indexed_tracks_;
+    mutable bool index_dirty_ = true;
+    uint64_t generation_ = 0;
+
+    std::atomic<std::shared_ptr<const TimelineSnapshot>> snapshot_;
+
+    void ensure_index() const;
+    void rebuild_index() const;
+    void index_insert(size_t clip) const;
+    void index_remove(size_t clip) const;
+    void reindex(size_t clip);
+    void bind_handle(size_t clip);
+    void rebind_handles();
+
+    // Entries [0, upper) whose end is past min_end, latest start first.
+    template<typename Fn>
+    static void visit_candidates(const TrackIndex& track, size_t upper, double min_end, Fn&& fn);
 };
 
 } // namespace furious
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "furious/core/handle.hpp"
+#include "furious/core/track.hpp"
+#include "furious/core/timeline_clip.hpp"
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace furious {
+
+// Immutable copy of a TimelineData at one generation, safe to read from any
+// thread while the UI keeps editing. Clips and the track list are shared
+// with the previous snapshot where they did not change, so publishing after
+// an edit only copies what the edit touched.
+//
+// The mutable lookup caches on clips (source and pattern handles) must not
+// be refreshed from worker threads; resolve those by id there.
+class TimelineSnapshot {
+public:
+    using ClipPtr = std::shared_ptr<const TimelineClip>;
+
+    // Builds a snapshot, reusing anything in previous that still matches.
+    [[nodiscard]] static std::shared_ptr<const TimelineSnapshot> create(
+        uint64_t generation, const std::vector<Track>& tracks,
+        const std::vector<TimelineClip>& clips, const std::vector<ClipHandle>& handles,
+        const TimelineSnapshot* previous);
+
+    [[nodiscard]] uint64_t generation() const { return generation_; }
+
+    [[nodiscard]] const std::vector<Track>& tracks() const { return *tracks_; }
+    [[nodiscard]] size_t track_count() const { return tracks_->size(); }
+
+    // In TimelineData order; handles are parallel to clips.
+    [[nodiscard]] const std::vector<ClipPtr>& clips() const { return clips_; }
+    [[nodiscard]] const std::vector<ClipHandle>& handles() const { return handles_; }
+
+    [[nodiscard]] const TimelineClip* find_clip(std::string_view clip_id) const;
+    [[nodiscard]] const TimelineClip* find_clip(ClipHandle handle) const;
+
+    // Ordered by track, then start, like TimelineData. Linear in the clip
+    // count; snapshots trade the interval index for cheap publishing.
+    [[nodiscard]] std::vector<const TimelineClip*> clips_at_beat(double beat) const;
+    [[nodiscard]] std::vector<const TimelineClip*> clips_in_range(double start_beat, double end_beat) const;
+
+private:
+    uint64_t generation_ = 0;
+    std::shared_ptr<const std::vector<Track>> tracks_;
+    std::vector<ClipPtr> clips_;
+    std::vector<ClipHandle> handles_;
+    std::vector<size_t> by_track_;  // clips_ indices sorted by track, then start
+};
+
+} // namespace furious
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "furious/core/handle.hpp"
+#include "furious/core/pattern_evaluator.hpp"
+#include "furious/core/timeline_clip.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace furious {
+
+class PatternLibrary;
+class ScriptEngine;
+class Tempo;
+class TimelineData;
+
+// Resolved clip state at one subdivision: transform with pattern and effect
+// overrides applied, and the source time the viewport would show.
+struct AutomationSample {
+    float position_x = 0.0f;
+    float position_y = 0.0f;
+    float scale_x = 1.0f;
+    float scale_y = 1.0f;
+    float rotation = 0.0f;
+    float source_seconds = 0.0f;
+    bool flip_h = false;
+    bool flip_v = false;
+    bool restart = false;
+    bool looped = false;
+};
+
+struct BakedClipAutomation {
+    double start_beat = 0.0;
+    std::vector<AutomationSample> samples;  // one per subdivision from start_beat
+
+    [[nodiscard]] const AutomationSample* sample_at(double beat) const;
+};
+
+// Bakes every clip's full span at pattern subdivision resolution. Results are
+// cached per clip until the clip, one of its patterns or the BPM changes.
+class AutomationBaker {
+public:
+    static constexpr int SUBDIVISIONS_PER_BEAT = 4;
+
+    AutomationBaker() = default;
+
+    void set_timeline_data(TimelineData* data) { timeline_data_ = data; }
+    void set_pattern_library(PatternLibrary* library);
+    void set_script_engine(ScriptEngine* engine) { script_engine_ = engine; }
+    void set_tempo(const Tempo* tempo) { tempo_ = tempo; }
+
+    // Brings every clip overlapping [start_beat, end_beat) up to date and
+    // returns how many had to be re-baked. Effects are batched through the
+    // script engine's state pool; pattern evaluation and merging are spread
+    // across worker threads. Entries of removed clips are dropped first.
+    size_t bake_range(double start_beat, double end_beat);
+
+    [[nodiscard]] const BakedClipAutomation* find(ClipHandle clip) const;
+
+    void clear() { cache_.clear(); }
+
+private:
+    struct Entry {
+        uint64_t key = 0;
+        BakedClipAutomation baked;
+    };
+
+    TimelineData* timeline_data_ = nullptr;
+    PatternLibrary* pattern_library_ = nullptr;
+    ScriptEngine* script_engine_ = nullptr;
+    const Tempo* tempo_ = nullptr;
+    PatternEvaluator pattern_evaluator_;
+
+    HandleMap<ClipTag, Entry> cache_;
+    uint64_t pruned_generation_ = 0;  // timeline generation cache_ was last pruned at
+
+    [[nodiscard]] uint64_t cache_key(const TimelineClip& clip) const;
+};
+
+} // namespace furious
@@ -7,8 +7,13 @@ namespace furious {
 class Project;
 class TimelineData;
 
+enum class ProjectAccess {
+    ReadOnly,
+    ReadWrite,
+};
+
 void register_lua_bindings(lua_State* L);
-void bind_project(lua_State* L, Project* project);
+void bind_project(lua_State* L, Project* project, ProjectAccess access);
 void bind_timeline_data(lua_State* L, TimelineData* data);
 
 } // namespace furious
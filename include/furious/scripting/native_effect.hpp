@@ -0,0 +1,27 @@
+#pragma once
+
+#include "furious/scripting/script_engine.hpp"
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace furious {
+
+// An effect compiled into the application. It follows the same contract as a
+// Lua script: params arrive parsed against info().parameters, in declaration
+// order, with "@clip.<field>" references already resolved. evaluate() may be
+// called from several threads at once.
+class NativeEffect {
+public:
+    virtual ~NativeEffect() = default;
+
+    [[nodiscard]] virtual const EffectInfo& info() const = 0;
+    [[nodiscard]] virtual EffectResult evaluate(const EffectContext& context,
+                                                std::span<const EffectParameterValue> params) const = 0;
+};
+
+// C++ ports of the bundled auto_ytpmv and lerp_transform scripts, registered
+// under the same ids so saved projects resolve to either.
+[[nodiscard]] std::vector<std::unique_ptr<NativeEffect>> builtin_native_effects();
+
+} // namespace furious
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace furious {
+
+// On-disk cache of compiled Lua chunks. Entries are keyed by a hash of the
+// script's source text and the interpreter's bytecode format, so an edited
+// script or a Lua upgrade simply misses instead of loading stale bytecode.
+class ScriptCache {
+public:
+    ScriptCache();
+    explicit ScriptCache(std::filesystem::path directory);
+
+    [[nodiscard]] const std::filesystem::path& directory() const { return directory_; }
+    void set_directory(std::filesystem::path directory) { directory_ = std::move(directory); }
+
+    [[nodiscard]] bool enabled() const { return enabled_; }
+    void set_enabled(bool enabled) { enabled_ = enabled; }
+
+    // Identifies the bytecode format, e.g. the Lua release string.
+    void set_format(std::string format) { format_ = std::move(format); }
+
+    [[nodiscard]] std::filesystem::path entry_path(std::string_view source) const;
+
+    [[nodiscard]] std::optional<std::string> load(std::string_view source) const;
+    bool store(std::string_view source, std::string_view bytecode) const;
+
+    static std::filesystem::path default_directory();
+
+private:
+    std::filesystem::path directory_;
+    std::string format_;
+    bool enabled_ = true;
+};
+
+} // namespace furious
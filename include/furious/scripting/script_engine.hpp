@@ -1,29 +1,58 @@
 #pragma once
 
 #include "furious/core/timeline_clip.hpp"
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 
 namespace furious {
 
 class Project;
+class ScriptCache;
 class TimelineData;
 class Tempo;
 
+enum class EffectParameterType {
+    String,
+    Number,
+    Bool,
+    Enum
+};
+
 struct EffectParameter {
     std::string name;
     std::string type;
     std::string default_value;
     std::vector<std::string> enum_values;
+    EffectParameterType kind = EffectParameterType::String;
 };
 
+// A stored parameter string parsed against its declaration. Scripts receive
+// numbers and booleans as such and enums as 1-based ordinals into the
+// declared values. Number parameters may hold "@clip.<field>", which is read
+// from the clip's base transform on every evaluation.
+struct EffectParameterValue {
+    EffectParameterType type = EffectParameterType::String;
+    double number = 0.0;
+    bool flag = false;
+    int ordinal = 0;
+    std::string text;
+    std::optional<PatternTargetProperty> clip_reference;
+};
+
+[[nodiscard]] EffectParameterValue parse_effect_parameter(const EffectParameter& param, std::string_view raw);
+
 struct EffectInfo {
     std::string id;
     std::string name;
     std::string script_path;
     std::vector<EffectParameter> parameters;
+    bool slow = false;  // a call has been aborted for running over budget
+    bool native = false;  // compiled in rather than loaded from script_path
+    bool pure = false;  // result depends only on the beat, params and clip transform
 };
 
 struct EffectResult {
@@ -60,8 +89,36 @@ struct EffectContext {
     AccumulatedTransform accumulated;
 };
 
+// One chain evaluation. With clip_local_beats set, the chain is evaluated at
+// each of those beats instead of context.clip_local_beats, shifting
+// current_beats to match, and yields one result per beat. Effects that
+// define evaluate_batch(context, params, beats) then fill context.results[i]
+// for the whole span in a single call.
+struct EffectJob {
+    const std::vector<ClipEffect>* effects = nullptr;
+    EffectContext context;
+    std::vector<double> clip_local_beats;
+};
+
+struct EffectTiming {
+    std::string effect_id;
+    double total_ms = 0.0;
+    uint32_t calls = 0;
+    uint32_t aborted = 0;
+    uint32_t memo_hits = 0;  // served from the pure-effect cache, not in calls
+};
+
+struct ScriptGcStats {
+    double collect_ms = 0.0;
+    size_t heap_bytes = 0;  // across every Lua state
+    uint32_t steps = 0;
+    bool full_collection = false;
+};
+
 class ScriptEngine {
 public:
+    static constexpr uint32_t DEFAULT_INSTRUCTION_BUDGET = 200000;
+
     ScriptEngine();
     ~ScriptEngine();
 
@@ -73,12 +130,26 @@ public:
 
     void scan_effect_directories();
     void add_effect_directory(const std::string& path);
+
+    // Reloads only the scripts added, edited or removed since they were last
+    // loaded. Returns true if any effect changed.
+    bool reload_changed_effects();
+
+    // Cheap enough to call every frame: reloads changed scripts once the
+    // directory watcher has seen activity in an effect directory.
+    bool poll_effect_changes();
+
+    [[nodiscard]] ScriptCache& script_cache();
     [[nodiscard]] const std::vector<EffectInfo>& available_effects() const;
     [[nodiscard]] const EffectInfo* find_effect(const std::string& effect_id) const;
 
     void set_project(Project* project);
     void set_timeline_data(TimelineData* data);
 
+    // Effects that declare pure = true are evaluated once per project frame:
+    // the beat is snapped to the start of its frame and the result is kept
+    // per clip, effect and inputs in a bounded cache per Lua state.
+    // Cached results are dropped whenever scripts are reloaded.
     EffectResult evaluate_effect(
         const ClipEffect& effect,
         const EffectContext& context
@@ -89,6 +160,31 @@ public:
         const EffectContext& context
     );
 
+    // Evaluates every job's effect chain into results, in job order and one
+    // result per evaluated beat. Each clip always runs in the same one of a
+    // pool of independent Lua states, picked by its handle; large batches run
+    // the states on persistent threads. The clips, tempo and timeline must
+    // not change until it returns.
+    void evaluate_effects_batch(
+        const std::vector<EffectJob>& jobs,
+        std::vector<EffectResult>& results
+    );
+
+    // The Lua states run the generational collector with automatic
+    // collection stopped; call this once per frame. It runs minor steps
+    // until budget_ms is spent. Full collections wait for idle frames unless
+    // the heap is running away.
+    ScriptGcStats collect_garbage(double budget_ms, bool idle);
+
+    // Lua instructions a single evaluate() call may run. A call that runs
+    // over is aborted, its effect is marked slow and the instance's last
+    // good result is used in its place. Zero disables the limit.
+    void set_instruction_budget(uint32_t instructions);
+    [[nodiscard]] uint32_t instruction_budget() const;
+
+    // Per-effect cost accumulated since the previous call, slowest first.
+    std::vector<EffectTiming> take_effect_timings();
+
     [[nodiscard]] bool is_initialized() const;
     [[nodiscard]] const std::string& last_error() const;
 
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "furious/core/command.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace furious {
+
+class Project;
+class TimelineData;
+
+// What the editor hands a job when it starts.
+struct ScriptJobContext {
+    double playhead_beats = 0.0;
+    std::string selected_clip_id;
+};
+
+enum class ScriptJobStatus {
+    Idle,
+    Running,
+    Finished,
+    Failed
+};
+
+// Runs generator scripts that edit the timeline in bulk. A job script
+// defines 'job = { name = ... }' and 'function run(context)'; run() goes
+// through the 'timeline' table to add, modify and remove clips. The script
+// runs as a coroutine that yields whenever the frame's budget is spent, so a
+// job may take many frames. Its edits are staged until run() returns, then
+// handed over as one compound command, which makes the whole job one undo
+// step. Reads see the timeline plus the job's own staged edits.
+class ScriptJobRunner {
+public:
+    // Lua instructions between checks of the frame deadline.
+    static constexpr int YIELD_CHECK_INTERVAL = 1000;
+
+    ScriptJobRunner();
+    ~ScriptJobRunner();
+
+    ScriptJobRunner(const ScriptJobRunner&) = delete;
+    ScriptJobRunner& operator=(const ScriptJobRunner&) = delete;
+
+    void set_project(Project* project);
+    void set_timeline_data(TimelineData* data);
+
+    void add_job_directory(const std::string& path);
+    [[nodiscard]] std::vector<std::string> job_scripts() const;
+
+    // Loads the script and prepares its coroutine; nothing runs until
+    // resume(). Fails if a job is already running.
+    bool start(const std::string& path, const ScriptJobContext& context);
+
+    // Runs the job until it finishes or budget_ms is spent.
+    ScriptJobStatus resume(double budget_ms);
+
+    // Drops a running job and everything it staged.
+    void cancel();
+
+    // The finished job's edits, once; null if it made none.
+    std::unique_ptr<Command> take_command();
+
+    [[nodiscard]] ScriptJobStatus status() const;
+    [[nodiscard]] bool is_running() const { return status() == ScriptJobStatus::Running; }
+    [[nodiscard]] const std::string& job_name() const;
+    [[nodiscard]] size_t staged_edits() const;
+    [[nodiscard]] double progress() const;  // as last reported by the script, 0..1
+    [[nodiscard]] const std::string& last_error() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace furious
@@ -12,9 +12,15 @@
 #include "furious/ui/patterns_window.hpp"
 #include "furious/audio/audio_engine.hpp"
 #include "furious/video/video_engine.hpp"
+#include "furious/video/render_thread.hpp"
 #include "furious/video/source_library.hpp"
 #include "furious/scripting/script_engine.hpp"
+#include "furious/scripting/script_job.hpp"
+#include "furious/scripting/automation_baker.hpp"
+#include <atomic>
 #include <memory>
+#include <optional>
+#include <vector>
 
 struct GLFWwindow;
 
@@ -55,6 +61,10 @@ public:
 
     void set_glfw_window(GLFWwindow* window) { glfw_window_ = window; }
 
+    // Starts preview rendering on its own thread with context, a hidden
+    // window sharing objects with the UI's.
+    bool start_render_thread(GLFWwindow* context);
+
 private:
     GLFWwindow* glfw_window_ = nullptr;
     Project project_;
@@ -66,10 +76,15 @@ private:
     TransportControls transport_controls_;
     AudioEngine audio_engine_;
     VideoEngine video_engine_;
+    RenderThread render_thread_{video_engine_};
+    int preview_width_ = 0;
+    int preview_height_ = 0;
     ScriptEngine script_engine_;
+    ScriptJobRunner script_jobs_;
     ProfilerWindow profiler_;
     PatternsWindow patterns_window_;
     PatternEvaluator pattern_evaluator_;
+    AutomationBaker automation_baker_;
     CommandHistory command_history_;
 
     bool first_frame_ = true;
@@ -78,26 +93,77 @@ private:
     std::string current_project_path_;
     bool dirty_ = false;
     std::string pending_source_removal_;
+    std::vector<std::string> job_scripts_;
 
     bool cache_building_ = false;
     size_t cache_current_clip_ = 0;
     size_t cache_total_clips_ = 0;
+    // Counted by the render thread as each clip's cache finishes. Every
+    // build gets its own counter, so steps left over from a previous
+    // project cannot count towards it.
+    std::shared_ptr<std::atomic<size_t>> cache_finished_clips_;
 
     enum class EditMode { None, Transform, Effect };
     EditMode edit_mode_ = EditMode::None;
     TimelineClip property_edit_initial_state_;
 
+    // Everything the video and audio sync need for one clip at the playhead,
+    // evaluated once per frame so patterns and scripts run a single time.
+    struct ResolvedClipState {
+        TimelineClip* clip = nullptr;
+        ClipHandle clip_handle;
+        SourceHandle source_handle;
+        double clip_local_beats = 0.0;
+        uint64_t fingerprint = 0;
+
+        std::optional<ClipTransformOverride> transform;
+
+        bool use_looped_frame = false;
+        double loop_start_seconds = 0.0;
+        double loop_duration_seconds = 0.0;
+        double position_in_loop_seconds = 0.0;
+
+        bool use_looped_audio = false;
+        double audio_loop_start_seconds = 0.0;
+        double audio_loop_duration_seconds = 0.0;
+    };
+    std::vector<ResolvedClipState> resolved_clips_;
+    std::vector<ResolvedClipState> previous_clips_;
+    std::vector<size_t> pending_clips_;  // resolved_clips_ entries to evaluate this frame
+    std::vector<EffectJob> effect_jobs_;
+    std::vector<EffectResult> effect_results_;
+
+    // What every resolved clip depends on besides its own fields; any change
+    // re-resolves all of them.
+    struct SyncInputs {
+        double playhead_beats = -1.0;
+        uint64_t timeline_generation = 0;
+        uint64_t tempo_generation = 0;
+        uint64_t effects_generation = 0;
+        bool dragging = false;
+
+        bool operator==(const SyncInputs&) const = default;
+    };
+    SyncInputs sync_inputs_;
+    uint64_t effects_generation_ = 0;
+    uint64_t retained_generation_ = 0;  // timeline generation the engine's clips were last pruned at
+
     void setup_dockspace();
     void build_default_layout(unsigned int dockspace_id);
     void render_audio_panel();
     void render_sources_panel();
     void render_effects_panel();
+    void render_scripts_panel();
+    void run_script_jobs();
     void render_loading_modal();
+    // Returns false when nothing at the playhead changed since last frame.
+    bool resolve_active_clips();
     void sync_video_to_playhead();
     void sync_audio_to_playhead();
     void cache_all_clips();
     void start_cache_building();
     bool cache_next_clip();
+    void cache_clip(const TimelineClip& clip);
     void handle_keyboard_shortcuts();
 };
 
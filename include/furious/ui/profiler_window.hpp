@@ -1,10 +1,13 @@
 #pragma once
 
+#include "furious/audio/audio_callback_stats.hpp"
+#include "furious/scripting/script_engine.hpp"
 #include <array>
 #include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <string>
+#include <vector>
 
 namespace furious {
 
@@ -33,6 +36,20 @@ public:
     void toggle_visible() { visible_ = !visible_; }
 
     void set_video_decoder_info(const std::string& info) { video_decoder_info_ = info; }
+    void set_preview_render_ms(float ms, int draw_calls) {
+        preview_render_ms_ = ms;
+        preview_draw_calls_ = draw_calls;
+    }
+    void set_audio_stats(const AudioCallbackStats* stats) { audio_stats_ = stats; }
+    void set_script_stats(float ms, uint32_t calls) {
+        script_ms_ = ms;
+        script_calls_ = calls;
+    }
+    void set_script_gc_stats(float ms, size_t heap_bytes) {
+        script_gc_ms_ = ms;
+        script_heap_bytes_ = heap_bytes;
+    }
+    void set_effect_timings(std::vector<EffectTiming> timings) { effect_timings_ = std::move(timings); }
 
 private:
     bool visible_ = false;
@@ -43,6 +60,8 @@ private:
     std::array<float, HISTORY_SIZE> memory_history_{};
     std::array<float, HISTORY_SIZE> frame_time_history_{};
     std::array<float, HISTORY_SIZE> alloc_history_{};
+    std::array<float, HISTORY_SIZE> script_history_{};
+    std::array<float, HISTORY_SIZE> script_gc_history_{};
     size_t history_index_ = 0;
 
     std::chrono::steady_clock::time_point last_update_;
@@ -55,13 +74,24 @@ private:
     float peak_memory_mb_ = 0.0f;
     float avg_frame_time_ms_ = 0.0f;
     uint64_t last_frame_allocs_ = 0;
+    float script_ms_ = 0.0f;
+    uint32_t script_calls_ = 0;
+    float script_gc_ms_ = 0.0f;
+    size_t script_heap_bytes_ = 0;
+    std::vector<EffectTiming> effect_timings_;
 
     unsigned long last_cpu_total_ = 0;
     unsigned long last_cpu_idle_ = 0;
 
     std::string video_decoder_info_ = "None";
+    float preview_render_ms_ = 0.0f;
+    int preview_draw_calls_ = 0;
+
+    const AudioCallbackStats* audio_stats_ = nullptr;
+    AudioCallbackStats::Snapshot audio_snapshot_;
 
     void sample_metrics();
+    void render_audio_stats();
     float get_process_memory_mb();
     float get_cpu_usage();
 };
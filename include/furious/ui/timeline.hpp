@@ -3,6 +3,7 @@
 #include "furious/core/project.hpp"
 #include "furious/core/timeline_data.hpp"
 #include "furious/video/source_library.hpp"
+#include "furious/scripting/automation_baker.hpp"
 #include <optional>
 #include <string>
 
@@ -18,6 +19,7 @@ public:
 
     void set_timeline_data(TimelineData* data) { timeline_data_ = data; }
     void set_source_library(SourceLibrary* library) { source_library_ = library; }
+    void set_automation_baker(AutomationBaker* baker) { automation_baker_ = baker; }
 
     [[nodiscard]] const std::string& selected_clip_id() const { return selected_clip_id_; }
     void set_selected_clip_id(const std::string& id) { selected_clip_id_ = id; }
@@ -65,6 +67,7 @@ private:
     Project& project_;
     TimelineData* timeline_data_ = nullptr;
     SourceLibrary* source_library_ = nullptr;
+    AutomationBaker* automation_baker_ = nullptr;
 
     double playhead_beats_ = 0.0;
     float zoom_ = 1.0f;
@@ -108,6 +111,8 @@ private:
     void render_track_headers(ImVec2 canvas_pos, float canvas_height);
     void render_tracks(ImVec2 canvas_pos, float canvas_width, float canvas_height);
     void render_clips(ImVec2 canvas_pos, float canvas_width, float canvas_height);
+    void render_clip_automation(const TimelineClip& clip, float clip_x, float clip_end_x,
+                                float visible_top, float visible_bottom, float origin_x);
     void render_grid(ImVec2 canvas_pos, float canvas_width, float canvas_height);
     void render_clip_region(ImVec2 canvas_pos, float canvas_width, float canvas_height);
     void render_playhead(ImVec2 canvas_pos, float canvas_width, float canvas_height);
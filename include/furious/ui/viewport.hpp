@@ -1,13 +1,12 @@
 #pragma once
 
+#include "furious/core/handle.hpp"
 #include "furious/core/timeline_data.hpp"
 #include "furious/core/timeline_clip.hpp"
-#include "furious/video/video_engine.hpp"
-#include "furious/video/source_library.hpp"
+#include "furious/video/render_thread.hpp"
 #include <cstdint>
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <optional>
 #include <utility>
 
@@ -34,20 +33,18 @@ public:
     [[nodiscard]] float height() const;
     [[nodiscard]] bool consume_play_toggle_request();
 
-    void set_video_engine(VideoEngine* engine) { video_engine_ = engine; }
     void set_timeline_data(TimelineData* data) { timeline_data_ = data; }
-    void set_source_library(SourceLibrary* library) { source_library_ = library; }
+
+    // The composited frame to show, scaled to fit; clip outlines and
+    // picking follow where the clips landed in it. Must outlive the next
+    // render().
+    void set_preview(const PreviewImage* image) { preview_ = image; }
 
     void set_active_clips(const std::vector<const TimelineClip*>& clips) { active_clips_ = clips; }
 
     void set_selected_clip_id(const std::string& id) { selected_clip_id_ = id; }
     [[nodiscard]] const std::string& selected_clip_id() const { return selected_clip_id_; }
 
-    void set_clip_transform_override(const std::string& clip_id, const ClipTransformOverride& override) {
-        transform_overrides_[clip_id] = override;
-    }
-    void clear_transform_overrides() { transform_overrides_.clear(); }
-
     [[nodiscard]] bool consume_clip_modification(TimelineClip& old_state, TimelineClip& new_state);
 
 private:
@@ -55,9 +52,8 @@ private:
     float height_ = 720.0f;
     bool play_toggle_requested_ = false;
 
-    VideoEngine* video_engine_ = nullptr;
     TimelineData* timeline_data_ = nullptr;
-    SourceLibrary* source_library_ = nullptr;
+    const PreviewImage* preview_ = nullptr;
 
     std::vector<const TimelineClip*> active_clips_;
     std::string selected_clip_id_;
@@ -67,7 +63,7 @@ private:
     TimelineClip drag_initial_clip_state_;
     std::optional<std::pair<TimelineClip, TimelineClip>> pending_clip_modification_;
 
-    std::unordered_map<std::string, ClipTransformOverride> transform_overrides_;
+    [[nodiscard]] const TimelineClip* active_clip(ClipHandle handle) const;
 };
 
 } // namespace furious
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace furious {
+
+// A clip's transform as resolved for one frame, in output pixels with y
+// down; rotation is in degrees about the clip's centre.
+struct ClipPlacement {
+    float position_x = 0.0f;
+    float position_y = 0.0f;
+    float scale_x = 1.0f;
+    float scale_y = 1.0f;
+    float rotation = 0.0f;
+    bool flip_h = false;
+    bool flip_v = false;
+};
+
+struct QuadPoint {
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+// Corners and texture coordinates in the order top-left, top-right,
+// bottom-right, bottom-left.
+struct ClipQuad {
+    std::array<QuadPoint, 4> corners;
+    std::array<QuadPoint, 4> uvs;
+
+    [[nodiscard]] bool contains(float x, float y) const;
+};
+
+[[nodiscard]] ClipQuad place_clip(const ClipPlacement& placement, int texture_width, int texture_height);
+
+struct CompositeLayer {
+    uint32_t texture = 0;  // GL_TEXTURE_2D, RGBA8
+    int width = 0;
+    int height = 0;
+    ClipQuad quad;
+};
+
+// Draws clip textures into an offscreen framebuffer at the output
+// resolution, so the preview and an export can share it. Layers are drawn
+// as instances of a single quad placed from a uniform buffer, with each
+// clip's texture bound to its own unit: one draw call per batch of as many
+// layers as the fragment stage has texture units, up to 32. Needs a
+// current GL context for everything but construction.
+class Compositor {
+public:
+    Compositor();
+    ~Compositor();
+
+    Compositor(const Compositor&) = delete;
+    Compositor& operator=(const Compositor&) = delete;
+
+    bool initialize();
+    void shutdown();
+
+    // Clears the target and draws layers back to front.
+    void draw(uint32_t framebuffer, int width, int height, const std::vector<CompositeLayer>& layers);
+
+    // Draw calls issued by the last draw().
+    [[nodiscard]] int draw_calls() const { return draw_calls_; }
+
+    // Layers drawn per call, fixed by initialize().
+    [[nodiscard]] int batch_size() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+    int draw_calls_ = 0;
+};
+
+} // namespace furious
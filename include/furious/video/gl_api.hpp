@@ -0,0 +1,109 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_WIN32)
+#define FURIOUS_GLAPI __stdcall
+#else
+#define FURIOUS_GLAPI
+#endif
+
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER 0x8D40
+#endif
+#ifndef GL_COLOR_ATTACHMENT0
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#endif
+#ifndef GL_FRAMEBUFFER_COMPLETE
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#endif
+#ifndef GL_VERTEX_SHADER
+#define GL_VERTEX_SHADER 0x8B31
+#endif
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER 0x8B30
+#endif
+#ifndef GL_COMPILE_STATUS
+#define GL_COMPILE_STATUS 0x8B81
+#endif
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS 0x8B82
+#endif
+#ifndef GL_UNIFORM_BUFFER
+#define GL_UNIFORM_BUFFER 0x8A11
+#endif
+#ifndef GL_INVALID_INDEX
+#define GL_INVALID_INDEX 0xFFFFFFFFu
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+#ifndef GL_TEXTURE0
+#define GL_TEXTURE0 0x84C0
+#endif
+#ifndef GL_MAX_TEXTURE_IMAGE_UNITS
+#define GL_MAX_TEXTURE_IMAGE_UNITS 0x8872
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_TIMEOUT_IGNORED
+#define GL_TIMEOUT_IGNORED 0xFFFFFFFFFFFFFFFFull
+#endif
+
+namespace furious {
+
+// The GL 3.3 entry points the preview path needs beyond what the platform
+// headers export, resolved through GLFW. Sync objects are kept as void* so
+// this does not depend on the platform's glext.h.
+struct GlApi {
+    void (FURIOUS_GLAPI* GenFramebuffers)(GLsizei, GLuint*) = nullptr;
+    void (FURIOUS_GLAPI* DeleteFramebuffers)(GLsizei, const GLuint*) = nullptr;
+    void (FURIOUS_GLAPI* BindFramebuffer)(GLenum, GLuint) = nullptr;
+    void (FURIOUS_GLAPI* FramebufferTexture2D)(GLenum, GLenum, GLenum, GLuint, GLint) = nullptr;
+    GLenum (FURIOUS_GLAPI* CheckFramebufferStatus)(GLenum) = nullptr;
+
+    GLuint (FURIOUS_GLAPI* CreateShader)(GLenum) = nullptr;
+    void (FURIOUS_GLAPI* ShaderSource)(GLuint, GLsizei, const char* const*, const GLint*) = nullptr;
+    void (FURIOUS_GLAPI* CompileShader)(GLuint) = nullptr;
+    void (FURIOUS_GLAPI* GetShaderiv)(GLuint, GLenum, GLint*) = nullptr;
+    void (FURIOUS_GLAPI* GetShaderInfoLog)(GLuint, GLsizei, GLsizei*, char*) = nullptr;
+    void (FURIOUS_GLAPI* DeleteShader)(GLuint) = nullptr;
+    GLuint (FURIOUS_GLAPI* CreateProgram)() = nullptr;
+    void (FURIOUS_GLAPI* AttachShader)(GLuint, GLuint) = nullptr;
+    void (FURIOUS_GLAPI* LinkProgram)(GLuint) = nullptr;
+    void (FURIOUS_GLAPI* GetProgramiv)(GLuint, GLenum, GLint*) = nullptr;
+    void (FURIOUS_GLAPI* GetProgramInfoLog)(GLuint, GLsizei, GLsizei*, char*) = nullptr;
+    void (FURIOUS_GLAPI* DeleteProgram)(GLuint) = nullptr;
+    void (FURIOUS_GLAPI* UseProgram)(GLuint) = nullptr;
+    GLint (FURIOUS_GLAPI* GetUniformLocation)(GLuint, const char*) = nullptr;
+    void (FURIOUS_GLAPI* Uniform1i)(GLint, GLint) = nullptr;
+    void (FURIOUS_GLAPI* Uniform2f)(GLint, GLfloat, GLfloat) = nullptr;
+    GLuint (FURIOUS_GLAPI* GetUniformBlockIndex)(GLuint, const char*) = nullptr;
+    void (FURIOUS_GLAPI* UniformBlockBinding)(GLuint, GLuint, GLuint) = nullptr;
+
+    void (FURIOUS_GLAPI* GenVertexArrays)(GLsizei, GLuint*) = nullptr;
+    void (FURIOUS_GLAPI* DeleteVertexArrays)(GLsizei, const GLuint*) = nullptr;
+    void (FURIOUS_GLAPI* BindVertexArray)(GLuint) = nullptr;
+    void (FURIOUS_GLAPI* GenBuffers)(GLsizei, GLuint*) = nullptr;
+    void (FURIOUS_GLAPI* DeleteBuffers)(GLsizei, const GLuint*) = nullptr;
+    void (FURIOUS_GLAPI* BindBuffer)(GLenum, GLuint) = nullptr;
+    void (FURIOUS_GLAPI* BindBufferBase)(GLenum, GLuint, GLuint) = nullptr;
+    void (FURIOUS_GLAPI* BufferData)(GLenum, std::ptrdiff_t, const void*, GLenum) = nullptr;
+    void (FURIOUS_GLAPI* ActiveTexture)(GLenum) = nullptr;
+    void (FURIOUS_GLAPI* DrawArraysInstanced)(GLenum, GLint, GLsizei, GLsizei) = nullptr;
+
+    void* (FURIOUS_GLAPI* FenceSync)(GLenum, GLbitfield) = nullptr;
+    void (FURIOUS_GLAPI* DeleteSync)(void*) = nullptr;
+    void (FURIOUS_GLAPI* WaitSync)(void*, GLbitfield, uint64_t) = nullptr;
+};
+
+// Resolves every entry point; needs a current context. Returns false if
+// any is missing.
+bool load_gl_api();
+
+[[nodiscard]] const GlApi& gl_api();
+
+} // namespace furious
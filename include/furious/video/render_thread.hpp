@@ -0,0 +1,103 @@
+#pragma once
+
+#include "furious/core/handle.hpp"
+#include "furious/video/compositor.hpp"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct GLFWwindow;
+
+namespace furious {
+
+class VideoEngine;
+
+// One clip of a preview frame, as resolved on the UI thread.
+struct PreviewClip {
+    ClipHandle clip_handle;
+    SourceHandle source_handle;
+    ClipPlacement placement;
+
+    double source_seconds = 0.0;  // plain playback; clamped to the source on the render thread
+
+    bool looped = false;
+    double loop_start_seconds = 0.0;
+    double loop_duration_seconds = 0.0;
+    double position_in_loop_seconds = 0.0;
+};
+
+struct PreviewFrame {
+    int width = 0;
+    int height = 0;
+    std::vector<PreviewClip> clips;  // back to front
+};
+
+// A finished frame, and where each clip landed in it. The texture is
+// stored bottom-up, as GL renders it.
+struct PreviewImage {
+    uint32_t texture = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<std::pair<ClipHandle, ClipQuad>> quads;  // back to front
+};
+
+// Decodes, uploads and composites the preview on its own thread and GL
+// context, so a slow panel does not stall playback and a slow decode does
+// not stall the UI. The UI thread submits the clips to show; the thread
+// renders the newest submission at most at the project fps, and keeps
+// re-rendering while loop caches fill. Finished frames go through three
+// shared textures with fences, so the UI always shows a complete one.
+//
+// While running, the thread owns the VideoEngine. Calls that touch GL go
+// through post(); others may run on the UI thread under lock_engine().
+class RenderThread {
+public:
+    explicit RenderThread(VideoEngine& engine);
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // context must share objects with the UI's context and not be current
+    // on any thread. The window stays owned by the caller.
+    bool start(GLFWwindow* context);
+
+    // Joins the thread and shuts the engine down on it.
+    void stop();
+
+    [[nodiscard]] bool is_running() const;
+
+    void set_fps(double fps);
+
+    // Replaces whatever was submitted before and has not been rendered.
+    void submit(PreviewFrame frame);
+
+    // Runs task on the render thread before its next frame, or right away
+    // if the thread is not running.
+    void post(std::function<void(VideoEngine&)> task);
+
+    // Runs step on the render thread until it returns true, in the time
+    // between frames and taking turns with other steps. The engine lock is
+    // held for one call at a time, so long work split into steps never
+    // keeps lock_engine() waiting for more than a single step.
+    void post_steps(std::function<bool(VideoEngine&)> step);
+
+    [[nodiscard]] std::unique_lock<std::mutex> lock_engine();
+
+    // UI thread, with the UI context current. The newest finished frame,
+    // or an empty image before the first; valid until the next call.
+    const PreviewImage& acquire();
+
+    [[nodiscard]] float last_render_ms() const;
+    [[nodiscard]] int last_draw_calls() const;
+    [[nodiscard]] std::string decoder_info() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace furious
@@ -1,6 +1,10 @@
 #pragma once
 
+#include "furious/core/handle.hpp"
 #include "furious/core/media_source.hpp"
+#include "furious/core/timeline_clip.hpp"
+#include "furious/audio/audio_buffer.hpp"
+#include "furious/audio/audio_cache.hpp"
 #include <vector>
 #include <string>
 #include <string_view>
@@ -19,14 +23,51 @@ public:
 
     [[nodiscard]] MediaSource* find_source(std::string_view source_id);
     [[nodiscard]] const MediaSource* find_source(std::string_view source_id) const;
+    [[nodiscard]] MediaSource* find_source(SourceHandle handle);
+    [[nodiscard]] const MediaSource* find_source(SourceHandle handle) const;
+
+    [[nodiscard]] SourceHandle handle_of(std::string_view source_id) const { return handles_.find(source_id); }
+
+    // Resolves through the handle cached on the clip, so repeated lookups
+    // for the same clip skip the id hash.
+    [[nodiscard]] SourceHandle source_handle(const TimelineClip& clip) const;
+    [[nodiscard]] const MediaSource* find_source(const TimelineClip& clip) const;
 
     [[nodiscard]] const std::vector<MediaSource>& sources() const { return sources_; }
     [[nodiscard]] size_t source_count() const { return sources_.size(); }
 
     void clear();
 
+    // Re-encodes already loaded source audio on a background thread when the
+    // format changes; sources keep their old buffers until the new ones are
+    // swapped in by poll_reencoded_audio(). A newer change cancels the
+    // pending one.
+    void set_sample_format(SampleFormat format);
+    [[nodiscard]] SampleFormat sample_format() const { return sample_format_; }
+
+    // Swaps in the buffers of a finished re-encode and returns true if any
+    // source changed. With wait set, blocks until the re-encode is done.
+    bool poll_reencoded_audio(bool wait = false);
+    [[nodiscard]] bool reencoding() const { return reencode_ != nullptr; }
+
+    [[nodiscard]] AudioCache& audio_cache() { return audio_cache_; }
+    [[nodiscard]] const AudioCache& audio_cache() const { return audio_cache_; }
+
 private:
     std::vector<MediaSource> sources_;
+    HandleTable<SourceTag> handles_;
+    SampleFormat sample_format_ = SampleFormat::Float32;
+    AudioCache audio_cache_;
+
+    struct Reencode;
+    std::unique_ptr<Reencode> reencode_;
+
+    void bind_handle(size_t source);
+    void rebind_handles();
+
+    std::shared_ptr<const AudioBuffer> extract_audio(const std::string& filepath) const;
+    static std::shared_ptr<const AudioBuffer> extract_audio(const AudioCache& cache, const std::string& filepath,
+                                                            SampleFormat format);
 
     static std::string generate_id();
     static std::string extract_filename(const std::string& filepath);
@@ -1,8 +1,10 @@
 #pragma once
 
+#include "furious/core/handle.hpp"
 #include "furious/core/media_source.hpp"
 #include <atomic>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -19,32 +21,44 @@ public:
     bool initialize();
     void shutdown();
 
-    void register_source(const MediaSource& source);
-    void unregister_source(const std::string& source_id);
+    void register_source(SourceHandle handle, const MediaSource& source);
+    void unregister_source(SourceHandle handle);
+
+    // Frees the textures and caches of clips is_live rejects, e.g. after
+    // they were removed from the timeline.
+    void retain_clips(const std::function<bool(ClipHandle)>& is_live);
+
+    // Closes the decoders of sources is_live rejects, along with their clips,
+    // e.g. after the source library was cleared and refilled.
+    void retain_sources(const std::function<bool(SourceHandle)>& is_live);
 
     void begin_frame();
 
-    void request_frame(const std::string& clip_id, const std::string& source_id, double local_seconds);
+    void request_frame(ClipHandle clip_handle, SourceHandle source_handle, double local_seconds);
 
-    void request_looped_frame(const std::string& clip_id, const std::string& source_id,
+    void request_looped_frame(ClipHandle clip_handle, SourceHandle source_handle,
                               double source_start_seconds, double loop_duration_seconds,
                               double position_in_loop);
 
-    void prefetch_clip(const std::string& clip_id, const std::string& source_id, double start_seconds);
+    void prefetch_clip(ClipHandle clip_handle, SourceHandle source_handle, double start_seconds);
 
-    void prebuild_loop_cache(const std::string& clip_id, const std::string& source_id,
-                             double source_start_seconds, double loop_duration_seconds);
+    // Decodes up to max_frames more frames of the clip's loop cache,
+    // starting it over if the loop moved. Returns true once it is complete
+    // or cannot be built, so long loops can be filled a slice at a time.
+    bool prebuild_loop_cache(ClipHandle clip_handle, SourceHandle source_handle,
+                             double source_start_seconds, double loop_duration_seconds,
+                             size_t max_frames);
 
-    [[nodiscard]] bool is_clip_cached(const std::string& clip_id) const;
+    [[nodiscard]] bool is_clip_cached(ClipHandle clip_handle) const;
 
-    [[nodiscard]] bool is_loop_cache_complete(const std::string& clip_id) const;
+    [[nodiscard]] bool is_loop_cache_complete(ClipHandle clip_handle) const;
 
-    [[nodiscard]] uint32_t get_texture(const std::string& clip_id) const;
-    [[nodiscard]] int get_texture_width(const std::string& source_id) const;
-    [[nodiscard]] int get_texture_height(const std::string& source_id) const;
+    [[nodiscard]] uint32_t get_texture(ClipHandle clip_handle) const;
+    [[nodiscard]] int get_texture_width(SourceHandle source_handle) const;
+    [[nodiscard]] int get_texture_height(SourceHandle source_handle) const;
 
-    [[nodiscard]] double get_source_duration(const std::string& source_id) const;
-    [[nodiscard]] double get_source_fps(const std::string& source_id) const;
+    [[nodiscard]] double get_source_duration(SourceHandle source_handle) const;
+    [[nodiscard]] double get_source_fps(SourceHandle source_handle) const;
 
     void set_playing(bool playing);
     [[nodiscard]] bool is_playing() const { return is_playing_; }
@@ -54,6 +68,10 @@ public:
 
     void update();
 
+    // False while a clip requested this frame still needs more requests to
+    // show the right frame, e.g. a loop cache that is still filling.
+    [[nodiscard]] bool is_settled() const;
+
     [[nodiscard]] std::string get_active_decoder_info() const;
 
 private:
@@ -1,6 +1,10 @@
+-- Reference script for the built-in native effect of the same id. The engine
+-- uses the native port and skips this file; copy it under a new id to tweak it.
+
 effect = {
     id = "auto_ytpmv",
     name = "Auto YTPMV",
+    pure = true,
     parameters = {
         { name = "Sync Period", type = "enum", default = "1/4",
           values = {"1/16", "1/8", "1/4", "1/2", "measure"} },
@@ -9,35 +13,48 @@ effect = {
     }
 }
 
-function evaluate(context, params)
-    local period_beats = furious.period_to_beats(params["Sync Period"] or "1/4")
+-- Indexed by the "Sync Period" enum ordinal.
+local PERIOD_BEATS = { 0.25, 0.5, 1.0, 2.0, 4.0 }
+
+local function fill(result, context, params, clip_local_beats)
+    local period_beats = PERIOD_BEATS[params["Sync Period"]] or 1.0
     local period_seconds = context.tempo.beats_to_time(period_beats)
 
-    local position_in_period = context.clip_local_beats % period_beats
+    local position_in_period = clip_local_beats % period_beats
     local position_seconds = context.tempo.beats_to_time(position_in_period)
 
-    local period_count = math.floor(context.clip_local_beats / period_beats)
+    local period_count = math.floor(clip_local_beats / period_beats)
 
     local scale_x = context.clip.scale_x
     local scale_y = context.clip.scale_y
 
-    if params["Flip Horizontal"] == "true" and period_count % 2 == 1 then
+    if params["Flip Horizontal"] and period_count % 2 == 1 then
         scale_x = -scale_x
     end
 
-    if params["Flip Vertical"] == "true" and period_count % 2 == 1 then
+    if params["Flip Vertical"] and period_count % 2 == 1 then
         scale_y = -scale_y
     end
 
-    return {
-        use_looped_frame = true,
-        loop_start_seconds = context.clip.source_start_seconds,
-        loop_duration_seconds = period_seconds,
-        position_in_loop_seconds = position_seconds,
-        use_looped_audio = true,
-        audio_loop_start_seconds = context.clip.source_start_seconds,
-        audio_loop_duration_seconds = period_seconds,
-        scale_x = scale_x,
-        scale_y = scale_y
-    }
+    result.use_looped_frame = true
+    result.loop_start_seconds = context.clip.source_start_seconds
+    result.loop_duration_seconds = period_seconds
+    result.position_in_loop_seconds = position_seconds
+    result.use_looped_audio = true
+    result.audio_loop_start_seconds = context.clip.source_start_seconds
+    result.audio_loop_duration_seconds = period_seconds
+    result.scale_x = scale_x
+    result.scale_y = scale_y
+    return result
+end
+
+function evaluate(context, params)
+    return fill(context.result, context, params, context.clip_local_beats)
+end
+
+function evaluate_batch(context, params, beats)
+    local results = context.results
+    for i = 1, #beats do
+        fill(results[i], context, params, beats[i])
+    end
 end
@@ -1,6 +1,10 @@
+-- Reference script for the built-in native effect of the same id. The engine
+-- uses the native port and skips this file; copy it under a new id to tweak it.
+
 effect = {
     id = "lerp_transform",
     name = "Lerp Transform",
+    pure = true,
     parameters = {
         { name = "Duration", type = "enum", default = "1",
           values = {"1/16", "1/8", "1/4", "1/2", "1", "2", "4", "8"} },
@@ -20,88 +24,59 @@ effect = {
     }
 }
 
-local function parse_duration(str)
-    if str == "1/16" then return 0.25
-    elseif str == "1/8" then return 0.5
-    elseif str == "1/4" then return 1.0
-    elseif str == "1/2" then return 2.0
-    else return tonumber(str) or 1.0
-    end
-end
-
-local function ease(t, easing)
-    local pi = 3.14159265359
-
-    if easing == "ease_in_sine" then
-        return 1 - math.cos((t * pi) / 2)
-    elseif easing == "ease_out_sine" then
-        return math.sin((t * pi) / 2)
-    elseif easing == "ease_in_out_sine" then
-        return -(math.cos(pi * t) - 1) / 2
-
-    elseif easing == "ease_in_quad" then
-        return t * t
-    elseif easing == "ease_out_quad" then
-        return 1 - (1 - t) * (1 - t)
-    elseif easing == "ease_in_out_quad" then
-        if t < 0.5 then
-            return 2 * t * t
-        else
-            return 1 - math.pow(-2 * t + 2, 2) / 2
-        end
-
-    elseif easing == "ease_in_cubic" then
-        return t * t * t
-    elseif easing == "ease_out_cubic" then
-        return 1 - math.pow(1 - t, 3)
-    elseif easing == "ease_in_out_cubic" then
-        if t < 0.5 then
-            return 4 * t * t * t
-        else
-            return 1 - math.pow(-2 * t + 2, 3) / 2
-        end
-
-    elseif easing == "ease_in_quart" then
-        return t * t * t * t
-    elseif easing == "ease_out_quart" then
-        return 1 - math.pow(1 - t, 4)
-    elseif easing == "ease_in_out_quart" then
-        if t < 0.5 then
-            return 8 * t * t * t * t
-        else
-            return 1 - math.pow(-2 * t + 2, 4) / 2
-        end
-
-    elseif easing == "ease_in_quint" then
-        return t * t * t * t * t
-    elseif easing == "ease_out_quint" then
-        return 1 - math.pow(1 - t, 5)
-    elseif easing == "ease_in_out_quint" then
-        if t < 0.5 then
-            return 16 * t * t * t * t * t
-        else
-            return 1 - math.pow(-2 * t + 2, 5) / 2
-        end
-
-    else
-        return t
-    end
-end
-
-function evaluate(context, params)
-    local duration_beats = parse_duration(params["Duration"])
-    if duration_beats <= 0 then duration_beats = 1.0 end
+-- Indexed by the enum ordinals the engine passes for "Duration" and "Easing".
+local DURATION_BEATS = { 0.25, 0.5, 1.0, 2.0, 1.0, 2.0, 4.0, 8.0 }
+
+local PI = 3.14159265359
+
+local EASINGS = {
+    function(t) return t end,
+
+    function(t) return 1 - math.cos((t * PI) / 2) end,
+    function(t) return math.sin((t * PI) / 2) end,
+    function(t) return -(math.cos(PI * t) - 1) / 2 end,
+
+    function(t) return t * t end,
+    function(t) return 1 - (1 - t) * (1 - t) end,
+    function(t)
+        if t < 0.5 then return 2 * t * t end
+        return 1 - (-2 * t + 2) ^ 2 / 2
+    end,
+
+    function(t) return t * t * t end,
+    function(t) return 1 - (1 - t) ^ 3 end,
+    function(t)
+        if t < 0.5 then return 4 * t * t * t end
+        return 1 - (-2 * t + 2) ^ 3 / 2
+    end,
+
+    function(t) return t * t * t * t end,
+    function(t) return 1 - (1 - t) ^ 4 end,
+    function(t)
+        if t < 0.5 then return 8 * t * t * t * t end
+        return 1 - (-2 * t + 2) ^ 4 / 2
+    end,
+
+    function(t) return t * t * t * t * t end,
+    function(t) return 1 - (1 - t) ^ 5 end,
+    function(t)
+        if t < 0.5 then return 16 * t * t * t * t * t end
+        return 1 - (-2 * t + 2) ^ 5 / 2
+    end,
+}
 
-    local easing = params["Easing"] or "linear"
+local function fill(result, context, params, clip_local_beats)
+    local duration_beats = DURATION_BEATS[params["Duration"]] or 1.0
+    local ease = EASINGS[params["Easing"]] or EASINGS[1]
 
-    local target_x = tonumber(params["Target X"]) or 0
-    local target_y = tonumber(params["Target Y"]) or 0
-    local target_scale_x = tonumber(params["Target Scale X"]) or 1
-    local target_scale_y = tonumber(params["Target Scale Y"]) or 1
-    local target_rotation = tonumber(params["Target Rotation"]) or 0
+    local target_x = params["Target X"]
+    local target_y = params["Target Y"]
+    local target_scale_x = params["Target Scale X"]
+    local target_scale_y = params["Target Scale Y"]
+    local target_rotation = params["Target Rotation"]
 
-    local loop = params["Loop"] == "true"
-    local ping_pong = params["Ping Pong"] == "true"
+    local loop = params["Loop"]
+    local ping_pong = params["Ping Pong"]
 
     local start_x = context.base.position_x
     local start_y = context.base.position_y
@@ -109,7 +84,7 @@ function evaluate(context, params)
     local start_scale_y = context.base.scale_y
     local start_rotation = context.base.rotation
 
-    local t = context.clip_local_beats / duration_beats
+    local t = clip_local_beats / duration_beats
 
     if loop then
         if ping_pong then
@@ -125,7 +100,7 @@ function evaluate(context, params)
         t = math.min(t, 1.0)
     end
 
-    t = ease(t, easing)
+    t = ease(t)
 
     local position_x = start_x + (target_x - start_x) * t
     local position_y = start_y + (target_y - start_y) * t
@@ -136,11 +111,21 @@ function evaluate(context, params)
     local acc_sign_x = context.clip.scale_x >= 0 and 1 or -1
     local acc_sign_y = context.clip.scale_y >= 0 and 1 or -1
 
-    return {
-        position_x = position_x,
-        position_y = position_y,
-        scale_x = math.abs(scale_x) * acc_sign_x,
-        scale_y = math.abs(scale_y) * acc_sign_y,
-        rotation = rotation
-    }
+    result.position_x = position_x
+    result.position_y = position_y
+    result.scale_x = math.abs(scale_x) * acc_sign_x
+    result.scale_y = math.abs(scale_y) * acc_sign_y
+    result.rotation = rotation
+    return result
+end
+
+function evaluate(context, params)
+    return fill(context.result, context, params, context.clip_local_beats)
+end
+
+function evaluate_batch(context, params, beats)
+    local results = context.results
+    for i = 1, #beats do
+        fill(results[i], context, params, beats[i])
+    end
 end
@@ -0,0 +1,37 @@
+-- Repeats the selected clip along a sixteenth-note rhythm from the playhead.
+-- Edit PATTERN and BARS to taste; 'x' places a hit, '.' is a rest.
+
+job = {
+    name = "Rhythm Fill",
+}
+
+local PATTERN = "x..x..x...x.x..."
+local BARS = 8
+local STEP_BEATS = 0.25
+
+function run(context)
+    local source = furious.timeline.clip(context.selected_clip_id)
+    if source == nil then
+        error("select a clip to repeat first")
+    end
+
+    local steps = #PATTERN * BARS
+    for step = 0, steps - 1 do
+        local index = step % #PATTERN + 1
+        if PATTERN:sub(index, index) == "x" then
+            furious.timeline.add_clip {
+                source_id = source.source_id,
+                track_index = source.track_index,
+                start_beat = context.playhead_beats + step * STEP_BEATS,
+                duration_beats = STEP_BEATS,
+                source_start_seconds = source.source_start_seconds,
+                position_x = source.position_x,
+                position_y = source.position_y,
+                scale_x = source.scale_x,
+                scale_y = source.scale_y,
+                rotation = source.rotation,
+            }
+        end
+        furious.job.set_progress((step + 1) / steps)
+    end
+end
@@ -1,9 +1,11 @@
 #include "furious/application.hpp"
+#include "furious/video/gl_api.hpp"
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
 #include <GLFW/glfw3.h>
 #include <nfd.h>
+#include <thread>
 
 namespace furious {
 
@@ -29,6 +31,10 @@ bool Application::initialize() {
 
     main_window_ = std::make_unique<MainWindow>();
     main_window_->set_glfw_window(window_);
+    if (!main_window_->start_render_thread(render_context_)) {
+        std::fprintf(stderr, "Failed to start render thread\n");
+        return false;
+    }
     return true;
 }
 
@@ -57,9 +63,29 @@ bool Application::init_glfw() {
         return false;
     }
 
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    render_context_ = glfwCreateWindow(1, 1, "FURIOUS render", nullptr, window_);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    if (!render_context_) {
+        std::fprintf(stderr, "Failed to create render context\n");
+        glfwDestroyWindow(window_);
+        glfwTerminate();
+        window_ = nullptr;
+        return false;
+    }
+
     glfwMakeContextCurrent(window_);
     glfwSwapInterval(1);
 
+    if (!load_gl_api()) {
+        return false;
+    }
+
+    // Pacing falls back on this when the driver ignores the swap interval.
+    if (const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor()); mode && mode->refreshRate > 0) {
+        frame_interval_ = std::chrono::duration<double>(1.0 / mode->refreshRate);
+    }
+
     return true;
 }
 
@@ -92,9 +118,49 @@ void Application::run() {
         }
     }
 
+    frame_deadline_ = std::chrono::steady_clock::now();
     while (!glfwWindowShouldClose(window_)) {
-        glfwPollEvents();
+        wait_for_events();
         render_frame();
+        pace_frame();
+    }
+}
+
+void Application::wait_for_events() {
+    if (main_window_->needs_continuous_rendering()) {
+        settle_frames_ = 0;
+        glfwPollEvents();
+        return;
+    }
+
+    if (settle_frames_ < IDLE_SETTLE_FRAMES) {
+        ++settle_frames_;
+        glfwPollEvents();
+        return;
+    }
+
+    // Waking before the timeout means an event arrived; otherwise this is
+    // just the periodic idle frame.
+    auto start = std::chrono::steady_clock::now();
+    glfwWaitEventsTimeout(IDLE_WAIT_SECONDS);
+    std::chrono::duration<double> waited = std::chrono::steady_clock::now() - start;
+    if (waited.count() < IDLE_WAIT_SECONDS) {
+        settle_frames_ = 0;
+    }
+    frame_deadline_ = std::chrono::steady_clock::now();
+}
+
+void Application::pace_frame() {
+    // With vsync working, the swap already blocked until the deadline and
+    // this does nothing. Without it, sleep off the rest of the refresh
+    // interval instead of spinning.
+    frame_deadline_ += std::chrono::duration_cast<std::chrono::steady_clock::duration>(frame_interval_);
+    auto now = std::chrono::steady_clock::now();
+    if (now < frame_deadline_) {
+        std::this_thread::sleep_until(frame_deadline_);
+    } else if (now - frame_deadline_ > frame_interval_) {
+        // Too far behind to catch up; start counting from this frame.
+        frame_deadline_ = now;
     }
 }
 
@@ -138,6 +204,14 @@ void Application::end_frame() {
 }
 
 void Application::shutdown() {
+    // Joins the render thread, which still needs the context windows.
+    main_window_.reset();
+
+    if (render_context_) {
+        glfwDestroyWindow(render_context_);
+        render_context_ = nullptr;
+    }
+
     if (window_) {
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
@@ -1,19 +1,325 @@
 #include "furious/audio/audio_buffer.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace furious {
 
-AudioBuffer::AudioBuffer(std::vector<float> samples, uint32_t sample_rate, uint32_t channels)
-    : samples_(std::move(samples))
+struct AudioBuffer::Storage {
+    std::vector<float> floats;
+    std::vector<uint16_t> packed;
+    void* mapping = nullptr;
+    size_t mapping_length = 0;
+
+    const std::byte* data = nullptr;
+    size_t size_bytes = 0;
+
+    Storage() = default;
+    Storage(const Storage&) = delete;
+    Storage& operator=(const Storage&) = delete;
+
+    ~Storage() {
+        if (!mapping) return;
+#ifdef _WIN32
+        UnmapViewOfFile(mapping);
+#else
+        munmap(mapping, mapping_length);
+#endif
+    }
+};
+
+namespace {
+
+constexpr char PCM_FILE_MAGIC[4] = {'F', 'P', 'C', 'M'};
+constexpr uint32_t PCM_FILE_VERSION = 1;
+
+struct PcmFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t sample_rate;
+    uint32_t channels;
+    uint32_t format;
+    uint32_t reserved;
+    uint64_t sample_count;
+};
+static_assert(sizeof(PcmFileHeader) == 32);
+
+constexpr float INT16_SCALE = 32767.0f;
+constexpr float INT16_INV_SCALE = 1.0f / 32768.0f;
+
+uint16_t encode_int16(float sample) {
+    float clamped = std::clamp(sample, -1.0f, 1.0f);
+    return std::bit_cast<uint16_t>(static_cast<int16_t>(std::lrint(clamped * INT16_SCALE)));
+}
+
+float decode_int16(uint16_t bits) {
+    return static_cast<float>(std::bit_cast<int16_t>(bits)) * INT16_INV_SCALE;
+}
+
+uint16_t encode_half(float value) {
+    uint32_t bits = std::bit_cast<uint32_t>(value);
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    uint32_t exponent = (bits >> 23) & 0xFFu;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (exponent == 0xFFu) {
+        return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+    }
+
+    int32_t half_exponent = static_cast<int32_t>(exponent) - 127 + 15;
+    if (half_exponent >= 0x1F) {
+        return static_cast<uint16_t>(sign | 0x7C00u);
+    }
+
+    if (half_exponent <= 0) {
+        if (half_exponent < -10) {
+            return sign;
+        }
+        mantissa |= 0x800000u;
+        uint32_t shift = static_cast<uint32_t>(14 - half_exponent);
+        uint32_t half_mantissa = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        uint32_t halfway = 1u << (shift - 1u);
+        if (remainder > halfway || (remainder == halfway && (half_mantissa & 1u))) {
+            ++half_mantissa;
+        }
+        return static_cast<uint16_t>(sign | half_mantissa);
+    }
+
+    uint32_t half = (static_cast<uint32_t>(half_exponent) << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+        ++half;
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+float decode_half(uint16_t half) {
+    uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1Fu;
+    uint32_t mantissa = half & 0x3FFu;
+
+    if (exponent == 0) {
+        float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -magnitude : magnitude;
+    }
+    if (exponent == 0x1Fu) {
+        return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << 13));
+    }
+    return std::bit_cast<float>(sign | ((exponent + 127 - 15) << 23) | (mantissa << 13));
+}
+
+float decode(SampleFormat format, uint16_t bits) {
+    return format == SampleFormat::Int16 ? decode_int16(bits) : decode_half(bits);
+}
+
+template<typename Decode>
+void mix_frames(const Decode& decode_at, uint64_t start_frame, uint64_t frame_count,
+                uint32_t channels, float gain, float* out) {
+    if (channels >= 2) {
+        for (uint64_t i = 0; i < frame_count; ++i) {
+            size_t index = (start_frame + i) * channels;
+            out[i * 2] += decode_at(index) * gain;
+            out[i * 2 + 1] += decode_at(index + 1) * gain;
+        }
+    } else {
+        for (uint64_t i = 0; i < frame_count; ++i) {
+            float sample = decode_at(start_frame + i) * gain;
+            out[i * 2] += sample;
+            out[i * 2 + 1] += sample;
+        }
+    }
+}
+
+} // namespace
+
+size_t bytes_per_sample(SampleFormat format) {
+    return format == SampleFormat::Float32 ? sizeof(float) : sizeof(uint16_t);
+}
+
+AudioBuffer::AudioBuffer(std::vector<float> samples, uint32_t sample_rate, uint32_t channels,
+                         SampleFormat format)
+    : format_(format)
     , sample_rate_(sample_rate)
-    , channels_(channels) {}
+    , channels_(channels) {
+    auto storage = std::make_shared<Storage>();
+
+    if (format_ == SampleFormat::Float32) {
+        storage->floats = std::move(samples);
+        storage->data = reinterpret_cast<const std::byte*>(storage->floats.data());
+        storage->size_bytes = storage->floats.size() * sizeof(float);
+    } else {
+        storage->packed.resize(samples.size());
+        if (format_ == SampleFormat::Int16) {
+            std::transform(samples.begin(), samples.end(), storage->packed.begin(), encode_int16);
+        } else {
+            std::transform(samples.begin(), samples.end(), storage->packed.begin(), encode_half);
+        }
+        storage->data = reinterpret_cast<const std::byte*>(storage->packed.data());
+        storage->size_bytes = storage->packed.size() * sizeof(uint16_t);
+    }
+
+    storage_ = std::move(storage);
+}
+
+std::expected<AudioBuffer, std::string> AudioBuffer::map_file(const std::string& filepath) {
+    auto storage = std::make_shared<Storage>();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return std::unexpected("Failed to open PCM file");
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart < static_cast<LONGLONG>(sizeof(PcmFileHeader))) {
+        CloseHandle(file);
+        return std::unexpected("PCM file is truncated");
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        return std::unexpected("Failed to map PCM file");
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view) {
+        return std::unexpected("Failed to map PCM file");
+    }
+
+    storage->mapping = view;
+    storage->mapping_length = static_cast<size_t>(file_size.QuadPart);
+#else
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::unexpected("Failed to open PCM file");
+    }
+
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(PcmFileHeader))) {
+        ::close(fd);
+        return std::unexpected("PCM file is truncated");
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return std::unexpected("Failed to map PCM file");
+    }
+
+    storage->mapping = view;
+    storage->mapping_length = static_cast<size_t>(st.st_size);
+#endif
+
+    PcmFileHeader header;
+    std::memcpy(&header, storage->mapping, sizeof(header));
+
+    if (std::memcmp(header.magic, PCM_FILE_MAGIC, sizeof(PCM_FILE_MAGIC)) != 0 ||
+        header.version != PCM_FILE_VERSION) {
+        return std::unexpected("Not a PCM cache file");
+    }
+
+    if (header.format > static_cast<uint32_t>(SampleFormat::Float16)) {
+        return std::unexpected("Unknown PCM sample format");
+    }
+
+    auto format = static_cast<SampleFormat>(header.format);
+    size_t payload_bytes = storage->mapping_length - sizeof(PcmFileHeader);
+    if (header.sample_count > payload_bytes / bytes_per_sample(format)) {
+        return std::unexpected("PCM file is truncated");
+    }
+
+    storage->data = static_cast<const std::byte*>(storage->mapping) + sizeof(PcmFileHeader);
+    storage->size_bytes = static_cast<size_t>(header.sample_count) * bytes_per_sample(format);
+
+    AudioBuffer buffer;
+    buffer.storage_ = std::move(storage);
+    buffer.format_ = format;
+    buffer.sample_rate_ = header.sample_rate;
+    buffer.channels_ = header.channels;
+    return buffer;
+}
+
+std::expected<void, std::string> AudioBuffer::write_file(const std::string& filepath) const {
+    PcmFileHeader header{};
+    std::memcpy(header.magic, PCM_FILE_MAGIC, sizeof(PCM_FILE_MAGIC));
+    header.version = PCM_FILE_VERSION;
+    header.sample_rate = sample_rate_;
+    header.channels = channels_;
+    header.format = static_cast<uint32_t>(format_);
+    header.sample_count = sample_count();
+
+    // Write next to the destination and rename so a crash never leaves a
+    // truncated file that a later map_file() would accept.
+    std::string temp_path = filepath + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return std::unexpected("Failed to create PCM file");
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (size_bytes() > 0) {
+            file.write(reinterpret_cast<const char*>(data()), static_cast<std::streamsize>(size_bytes()));
+        }
+        if (!file.good()) {
+            file.close();
+            std::filesystem::remove(temp_path);
+            return std::unexpected("Failed to write PCM file");
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp_path, filepath, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        return std::unexpected("Failed to finalize PCM file");
+    }
+    return {};
+}
+
+const std::byte* AudioBuffer::data() const {
+    return storage_ ? storage_->data : nullptr;
+}
 
 std::span<const float> AudioBuffer::samples() const {
-    return samples_;
+    if (format_ != SampleFormat::Float32 || !storage_) {
+        return {};
+    }
+    return {reinterpret_cast<const float*>(storage_->data), sample_count()};
+}
+
+size_t AudioBuffer::sample_count() const {
+    return storage_ ? storage_->size_bytes / bytes_per_sample(format_) : 0;
+}
+
+size_t AudioBuffer::size_bytes() const {
+    return storage_ ? storage_->size_bytes : 0;
+}
+
+bool AudioBuffer::is_mapped() const {
+    return storage_ && storage_->mapping != nullptr;
 }
 
 uint64_t AudioBuffer::frame_count() const {
     if (channels_ == 0) return 0;
-    return samples_.size() / channels_;
+    return sample_count() / channels_;
 }
 
 double AudioBuffer::duration_seconds() const {
@@ -24,8 +330,56 @@ double AudioBuffer::duration_seconds() const {
 float AudioBuffer::sample_at(uint64_t frame, uint32_t channel) const {
     if (channel >= channels_) return 0.0f;
     size_t index = frame * channels_ + channel;
-    if (index >= samples_.size()) return 0.0f;
-    return samples_[index];
+    if (index >= sample_count()) return 0.0f;
+    if (format_ == SampleFormat::Float32) {
+        return reinterpret_cast<const float*>(data())[index];
+    }
+    return decode(format_, reinterpret_cast<const uint16_t*>(data())[index]);
+}
+
+void AudioBuffer::mix_stereo(uint64_t start_frame, uint64_t frame_count, float gain, float* out) const {
+    uint64_t total_frames = this->frame_count();
+    if (start_frame >= total_frames) return;
+    frame_count = std::min(frame_count, total_frames - start_frame);
+
+    switch (format_) {
+        case SampleFormat::Float32: {
+            const float* data = reinterpret_cast<const float*>(this->data());
+            mix_frames([data](size_t i) { return data[i]; },
+                       start_frame, frame_count, channels_, gain, out);
+            break;
+        }
+        case SampleFormat::Int16: {
+            const uint16_t* data = reinterpret_cast<const uint16_t*>(this->data());
+            mix_frames([data](size_t i) { return decode_int16(data[i]); },
+                       start_frame, frame_count, channels_, gain, out);
+            break;
+        }
+        case SampleFormat::Float16: {
+            const uint16_t* data = reinterpret_cast<const uint16_t*>(this->data());
+            mix_frames([data](size_t i) { return decode_half(data[i]); },
+                       start_frame, frame_count, channels_, gain, out);
+            break;
+        }
+    }
+}
+
+AudioBuffer AudioBuffer::converted(SampleFormat format) const {
+    if (format == format_) {
+        return *this;
+    }
+
+    std::vector<float> decoded;
+    if (format_ == SampleFormat::Float32) {
+        auto source = samples();
+        decoded.assign(source.begin(), source.end());
+    } else {
+        const uint16_t* packed = reinterpret_cast<const uint16_t*>(data());
+        decoded.resize(sample_count());
+        std::transform(packed, packed + decoded.size(), decoded.begin(),
+            [this](uint16_t bits) { return decode(format_, bits); });
+    }
+    return AudioBuffer(std::move(decoded), sample_rate_, channels_, format);
 }
 
 }
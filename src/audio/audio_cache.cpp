@@ -0,0 +1,104 @@
+#include "furious/audio/audio_cache.hpp"
+#include "furious/core/key_hasher.hpp"
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+namespace furious {
+
+AudioCache::AudioCache()
+    : directory_(default_directory()) {}
+
+AudioCache::AudioCache(std::filesystem::path directory)
+    : directory_(std::move(directory)) {}
+
+std::filesystem::path AudioCache::entry_path(const std::string& source_path, SampleFormat format,
+                                             uint32_t sample_rate, uint32_t channels) const {
+    std::error_code ec;
+    std::filesystem::path absolute = std::filesystem::absolute(source_path, ec);
+    if (ec) return {};
+
+    auto file_size = std::filesystem::file_size(absolute, ec);
+    if (ec) return {};
+
+    auto write_time = std::filesystem::last_write_time(absolute, ec);
+    if (ec) return {};
+
+    KeyHasher hasher;
+    hasher.add(absolute.lexically_normal().string());
+    hasher.add(static_cast<uint64_t>(file_size));
+    hasher.add(static_cast<uint64_t>(write_time.time_since_epoch().count()));
+    hasher.add(static_cast<uint64_t>(format));
+    hasher.add(static_cast<uint64_t>(sample_rate));
+    hasher.add(static_cast<uint64_t>(channels));
+
+    std::ostringstream name;
+    name << std::hex << std::setfill('0') << std::setw(16) << hasher.value() << ".pcm";
+    return directory_ / name.str();
+}
+
+std::shared_ptr<const AudioBuffer> AudioCache::load(const std::string& source_path, SampleFormat format,
+                                                    uint32_t sample_rate, uint32_t channels) const {
+    if (!enabled_ || directory_.empty()) return nullptr;
+
+    auto path = entry_path(source_path, format, sample_rate, channels);
+    if (path.empty()) return nullptr;
+
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) return nullptr;
+
+    auto result = AudioBuffer::map_file(path.string());
+    if (!result.has_value()) {
+        std::filesystem::remove(path, ec);
+        return nullptr;
+    }
+
+    if (result->format() != format || result->sample_rate() != sample_rate ||
+        result->channels() != channels) {
+        return nullptr;
+    }
+    return std::make_shared<const AudioBuffer>(std::move(*result));
+}
+
+std::shared_ptr<const AudioBuffer> AudioCache::store(const std::string& source_path,
+                                                     const AudioBuffer& buffer) const {
+    if (!enabled_ || directory_.empty() || buffer.empty()) return nullptr;
+
+    auto path = entry_path(source_path, buffer.format(), buffer.sample_rate(), buffer.channels());
+    if (path.empty()) return nullptr;
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) return nullptr;
+
+    if (!buffer.write_file(path.string()).has_value()) {
+        return nullptr;
+    }
+
+    auto result = AudioBuffer::map_file(path.string());
+    if (!result.has_value()) {
+        return nullptr;
+    }
+    return std::make_shared<const AudioBuffer>(std::move(*result));
+}
+
+std::filesystem::path AudioCache::default_directory() {
+#ifdef _WIN32
+    if (const char* local = std::getenv("LOCALAPPDATA"); local && *local) {
+        return std::filesystem::path(local) / "furious" / "audio_cache";
+    }
+#else
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+        return std::filesystem::path(xdg) / "furious" / "audio";
+    }
+    if (const char* home = std::getenv("HOME"); home && *home) {
+        return std::filesystem::path(home) / ".cache" / "furious" / "audio";
+    }
+#endif
+    std::error_code ec;
+    auto temp = std::filesystem::temp_directory_path(ec);
+    if (ec) return {};
+    return temp / "furious" / "audio";
+}
+
+} // namespace furious
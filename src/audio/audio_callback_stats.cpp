@@ -0,0 +1,77 @@
+#include "furious/audio/audio_callback_stats.hpp"
+#include <algorithm>
+
+namespace furious {
+
+namespace {
+
+constexpr float XRUN_GAP_FACTOR = 1.5f;
+
+float percentile(std::array<float, AudioCallbackStats::CAPACITY>& values, size_t count, float fraction) {
+    if (count == 0) return 0.0f;
+    auto index = static_cast<size_t>(fraction * static_cast<float>(count - 1) + 0.5f);
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index),
+                     values.begin() + static_cast<std::ptrdiff_t>(count));
+    return values[index];
+}
+
+} // namespace
+
+void AudioCallbackStats::record(int64_t start_us, float elapsed_us, float period_us, uint32_t active_clips) {
+    uint64_t index = callbacks_.load(std::memory_order_relaxed);
+    size_t slot = static_cast<size_t>(index % CAPACITY);
+    elapsed_us_[slot].store(elapsed_us, std::memory_order_relaxed);
+    period_us_[slot].store(period_us, std::memory_order_relaxed);
+    active_clips_.store(active_clips, std::memory_order_relaxed);
+
+    if (elapsed_us > period_us) {
+        late_callbacks_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    int64_t last_start = last_start_us_.exchange(start_us, std::memory_order_relaxed);
+    float last_period = last_period_us_.exchange(period_us, std::memory_order_relaxed);
+    if (last_start >= 0 && last_period > 0.0f &&
+        static_cast<float>(start_us - last_start) > last_period * XRUN_GAP_FACTOR) {
+        xruns_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    callbacks_.store(index + 1, std::memory_order_release);
+}
+
+void AudioCallbackStats::reset() {
+    callbacks_.store(0, std::memory_order_relaxed);
+    late_callbacks_.store(0, std::memory_order_relaxed);
+    xruns_.store(0, std::memory_order_relaxed);
+    last_start_us_.store(-1, std::memory_order_relaxed);
+    last_period_us_.store(0.0f, std::memory_order_relaxed);
+}
+
+AudioCallbackStats::Snapshot AudioCallbackStats::snapshot() const {
+    Snapshot snap;
+    uint64_t total = callbacks_.load(std::memory_order_acquire);
+    size_t count = static_cast<size_t>(std::min<uint64_t>(total, CAPACITY));
+    uint64_t first = total - count;
+
+    std::array<float, CAPACITY> elapsed{};
+    for (size_t i = 0; i < count; ++i) {
+        size_t slot = static_cast<size_t>((first + i) % CAPACITY);
+        float e = elapsed_us_[slot].load(std::memory_order_relaxed);
+        float p = period_us_[slot].load(std::memory_order_relaxed);
+        elapsed[i] = e;
+        snap.load_history[i] = p > 0.0f ? e / p : 0.0f;
+        snap.max_us = std::max(snap.max_us, e);
+        snap.period_us = p;
+    }
+
+    snap.history_count = count;
+    snap.last_load = count > 0 ? snap.load_history[count - 1] : 0.0f;
+    snap.p50_us = percentile(elapsed, count, 0.50f);
+    snap.p99_us = percentile(elapsed, count, 0.99f);
+    snap.callbacks = total;
+    snap.late_callbacks = late_callbacks_.load(std::memory_order_relaxed);
+    snap.xruns = xruns_.load(std::memory_order_relaxed);
+    snap.active_clips = active_clips_.load(std::memory_order_relaxed);
+    return snap;
+}
+
+} // namespace furious
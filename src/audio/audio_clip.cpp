@@ -1,55 +1,228 @@
 #include "furious/audio/audio_clip.hpp"
-
-#define MINIAUDIO_IMPLEMENTATION
-#include "miniaudio.h"
+#include "furious/audio/audio_decoder.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace furious {
 
-bool AudioClip::load(const std::string& filepath) {
-    unload();
+namespace {
 
-    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 2, 44100);
-    ma_decoder decoder;
+constexpr size_t DECODE_CHUNK_FRAMES = 4096;
 
-    if (ma_decoder_init_file(filepath.c_str(), &config, &decoder) != MA_SUCCESS) {
-        return false;
+} // namespace
+
+// Single-producer/single-consumer ring. The reader thread owns write_index
+// and the audio thread owns read_index, except while a seek is pending: the
+// audio thread stops reading until the reader has repositioned both.
+struct AudioClip::Stream {
+    AudioDecoder decoder;
+
+    std::vector<float> ring;
+    uint64_t capacity_frames = 0;
+    std::vector<float> scratch;
+
+    std::atomic<uint64_t> read_index{0};
+    std::atomic<uint64_t> write_index{0};
+    std::atomic<uint64_t> read_frame{0};
+
+    std::atomic<bool> seek_pending{true};
+    std::atomic<uint64_t> seek_target{0};
+    std::atomic<bool> end_of_stream{false};
+    std::atomic<bool> stop{false};
+
+    // Source frame at write_index; reader thread only.
+    uint64_t decode_frame = 0;
+    std::atomic<uint64_t> total_frames{0};
+    std::atomic<bool> length_exact{false};
+
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    std::thread reader;
+
+    void run();
+    bool fill(uint64_t max_frames);
+    void request_seek(uint64_t frame);
+};
+
+void AudioClip::Stream::request_seek(uint64_t frame) {
+    seek_target.store(frame, std::memory_order_relaxed);
+    seek_pending.store(true, std::memory_order_release);
+    wake.notify_one();
+}
+
+bool AudioClip::Stream::fill(uint64_t max_frames) {
+    uint64_t write = write_index.load(std::memory_order_relaxed);
+    uint64_t used = write - read_index.load(std::memory_order_acquire);
+    uint64_t free_frames = capacity_frames - used;
+    uint64_t want = std::min({free_frames, max_frames, static_cast<uint64_t>(DECODE_CHUNK_FRAMES)});
+    if (want == 0) return false;
+
+    size_t got = decoder.read_frames(scratch.data(), static_cast<size_t>(want));
+    decode_frame += got;
+    if (got < want) {
+        total_frames.store(decode_frame, std::memory_order_relaxed);
+        length_exact.store(true, std::memory_order_relaxed);
+        end_of_stream.store(true, std::memory_order_release);
+    } else if (!length_exact.load(std::memory_order_relaxed) &&
+               decode_frame > total_frames.load(std::memory_order_relaxed)) {
+        total_frames.store(decode_frame, std::memory_order_relaxed);
     }
 
-    ma_uint64 frame_count;
-    if (ma_decoder_get_length_in_pcm_frames(&decoder, &frame_count) != MA_SUCCESS) {
-        ma_decoder_uninit(&decoder);
-        return false;
+    for (size_t i = 0; i < got; ++i) {
+        size_t slot = static_cast<size_t>((write + i) % capacity_frames) * OUTPUT_CHANNELS;
+        ring[slot] = scratch[i * OUTPUT_CHANNELS];
+        ring[slot + 1] = scratch[i * OUTPUT_CHANNELS + 1];
+    }
+    write_index.store(write + got, std::memory_order_release);
+    return got > 0;
+}
+
+void AudioClip::Stream::run() {
+    using namespace std::chrono_literals;
+
+    while (!stop.load()) {
+        if (seek_pending.load(std::memory_order_acquire)) {
+            uint64_t target = seek_target.load(std::memory_order_relaxed);
+
+            // The audio thread is not reading while a seek is pending, so the
+            // ring can be reset from this side.
+            read_index.store(write_index.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            end_of_stream.store(!decoder.seek_frame(target), std::memory_order_relaxed);
+            read_frame.store(target, std::memory_order_relaxed);
+            decode_frame = target;
+
+            // Prefill before publishing so the playhead, which kept moving
+            // during the seek, lands inside the buffered window.
+            uint64_t prefill = capacity_frames / 2;
+            while (prefill > 0 && !end_of_stream.load(std::memory_order_relaxed) && !stop.load()) {
+                uint64_t before = write_index.load(std::memory_order_relaxed);
+                if (!fill(prefill)) break;
+                prefill -= std::min(prefill, write_index.load(std::memory_order_relaxed) - before);
+            }
+
+            seek_pending.store(false, std::memory_order_release);
+            continue;
+        }
+
+        if (!end_of_stream.load(std::memory_order_relaxed) && fill(capacity_frames)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        wake.wait_for(lock, 10ms, [this] {
+            return stop.load() || seek_pending.load(std::memory_order_acquire);
+        });
     }
+}
+
+AudioClip::AudioClip() = default;
 
-    sample_rate_ = decoder.outputSampleRate;
-    channels_ = decoder.outputChannels;
-    total_frames_ = frame_count;
+AudioClip::~AudioClip() {
+    unload();
+}
 
-    samples_.resize(frame_count * channels_);
+bool AudioClip::load(const std::string& filepath) {
+    unload();
 
-    ma_uint64 frames_read;
-    if (ma_decoder_read_pcm_frames(&decoder, samples_.data(), frame_count, &frames_read) != MA_SUCCESS) {
-        ma_decoder_uninit(&decoder);
-        unload();
+    auto stream = std::make_unique<Stream>();
+    if (!stream->decoder.open(filepath).has_value() || !stream->decoder.has_audio_stream()) {
         return false;
     }
+    if (!stream->decoder.prepare_stream(OUTPUT_SAMPLE_RATE, OUTPUT_CHANNELS).has_value()) {
+        return false;
+    }
+
+    stream->capacity_frames = static_cast<uint64_t>(READ_AHEAD_SECONDS * OUTPUT_SAMPLE_RATE);
+    stream->ring.assign(static_cast<size_t>(stream->capacity_frames) * OUTPUT_CHANNELS, 0.0f);
+    stream->scratch.assign(DECODE_CHUNK_FRAMES * OUTPUT_CHANNELS, 0.0f);
 
-    ma_decoder_uninit(&decoder);
+    sample_rate_ = OUTPUT_SAMPLE_RATE;
+    channels_ = OUTPUT_CHANNELS;
+    stream->total_frames = static_cast<uint64_t>(stream->decoder.duration_seconds() * OUTPUT_SAMPLE_RATE);
     filepath_ = filepath;
+
+    Stream* raw = stream.get();
+    stream->reader = std::thread([raw] { raw->run(); });
+    stream_ = std::move(stream);
     return true;
 }
 
 void AudioClip::unload() {
-    samples_.clear();
+    if (stream_) {
+        stream_->stop.store(true);
+        stream_->wake.notify_one();
+        if (stream_->reader.joinable()) {
+            stream_->reader.join();
+        }
+        stream_.reset();
+    }
+
     filepath_.clear();
     sample_rate_ = 0;
     channels_ = 0;
-    total_frames_ = 0;
+}
+
+uint64_t AudioClip::total_frames() const {
+    return stream_ ? stream_->total_frames.load(std::memory_order_relaxed) : 0;
+}
+
+bool AudioClip::length_is_exact() const {
+    return stream_ && stream_->length_exact.load(std::memory_order_relaxed);
 }
 
 double AudioClip::duration_seconds() const {
     if (sample_rate_ == 0) return 0.0;
-    return static_cast<double>(total_frames_) / static_cast<double>(sample_rate_);
+    return static_cast<double>(total_frames()) / static_cast<double>(sample_rate_);
+}
+
+uint32_t AudioClip::mix_into(uint64_t frame, uint32_t frame_count, float* out) const {
+    Stream* stream = stream_.get();
+    if (!stream || frame_count == 0) return 0;
+
+    if (stream->seek_pending.load(std::memory_order_acquire)) {
+        stream->seek_target.store(frame, std::memory_order_relaxed);
+        return 0;
+    }
+
+    uint64_t read = stream->read_index.load(std::memory_order_relaxed);
+    uint64_t write = stream->write_index.load(std::memory_order_acquire);
+    uint64_t head = stream->read_frame.load(std::memory_order_relaxed);
+    uint64_t buffered = write - read;
+
+    if (frame >= head + buffered && stream->end_of_stream.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    if (frame < head || frame > head + buffered) {
+        stream->request_seek(frame);
+        return 0;
+    }
+
+    uint64_t skip = frame - head;
+    read += skip;
+    buffered -= skip;
+
+    uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(frame_count, buffered));
+    for (uint32_t i = 0; i < count; ++i) {
+        size_t slot = static_cast<size_t>((read + i) % stream->capacity_frames) * OUTPUT_CHANNELS;
+        out[i * 2] += stream->ring[slot];
+        out[i * 2 + 1] += stream->ring[slot + 1];
+    }
+
+    stream->read_index.store(read + count, std::memory_order_release);
+    stream->read_frame.store(frame + count, std::memory_order_relaxed);
+    return count;
+}
+
+uint64_t AudioClip::buffered_frames() const {
+    if (!stream_) return 0;
+    return stream_->write_index.load(std::memory_order_acquire) -
+           stream_->read_index.load(std::memory_order_acquire);
 }
 
 } // namespace furious
@@ -7,10 +7,103 @@ extern "C" {
 #include <libswresample/swresample.h>
 }
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <optional>
+#include <thread>
 #include <vector>
 
 namespace furious {
 
+namespace {
+
+constexpr size_t READ_CHUNK_FRAMES = 16384;
+constexpr double MIN_SEGMENTED_SECONDS = 30.0;
+constexpr double MIN_SEGMENT_SECONDS = 10.0;
+constexpr unsigned MAX_SEGMENTS = 16;
+
+// Decoded and thrown away ahead of every seek target: covers MP3/AAC
+// overlap and bit reservoirs and the resampler's filter, so output after a
+// seek matches a sequential decode.
+constexpr double SEEK_PREROLL_SECONDS = 0.1;
+
+unsigned segment_count(double duration_seconds, unsigned max_threads) {
+    if (duration_seconds < MIN_SEGMENTED_SECONDS) return 1;
+
+    unsigned threads = max_threads > 0 ? max_threads : std::thread::hardware_concurrency();
+    auto by_length = static_cast<unsigned>(duration_seconds / MIN_SEGMENT_SECONDS);
+    return std::clamp(std::min({threads, by_length, MAX_SEGMENTS}), 1u, MAX_SEGMENTS);
+}
+
+// Decodes [start, end) frame ranges of the file on separate threads, each
+// with its own decoder, writing straight into one preallocated buffer.
+// Seeks decode a pre-roll first, and a segment keeps feeding its resampler
+// until the frame before its end has come out, so seams carry no codec
+// warm-up and no flush padding. The last segment runs to end of stream,
+// where the resampler is flushed, so a short duration estimate is harmless;
+// any other segment coming up short (bad seek, overestimated duration)
+// abandons the attempt so the caller can decode sequentially.
+std::optional<std::vector<float>> extract_segmented(const std::string& filepath, uint64_t estimated_frames,
+                                                    unsigned segments, uint32_t sample_rate,
+                                                    uint32_t channels) {
+    std::vector<float> samples(static_cast<size_t>(estimated_frames) * channels);
+    std::vector<float> tail;
+    std::vector<uint64_t> decoded(segments, 0);
+    std::vector<char> succeeded(segments, 0);
+
+    auto decode_segment = [&](unsigned index) {
+        uint64_t start = estimated_frames * index / segments;
+        uint64_t end = estimated_frames * (index + 1) / segments;
+        bool last = index + 1 == segments;
+
+        AudioDecoder decoder;
+        if (!decoder.open(filepath).has_value() ||
+            !decoder.prepare_stream(sample_rate, channels).has_value()) {
+            return;
+        }
+        if (start > 0 && !decoder.seek_frame(start)) {
+            return;
+        }
+
+        uint64_t want = end - start;
+        uint64_t got = decoder.read_frames(samples.data() + start * channels, static_cast<size_t>(want));
+        decoded[index] = got;
+
+        if (last && got == want) {
+            std::vector<float> chunk(READ_CHUNK_FRAMES * channels);
+            size_t more = 0;
+            while ((more = decoder.read_frames(chunk.data(), READ_CHUNK_FRAMES)) > 0) {
+                tail.insert(tail.end(), chunk.begin(), chunk.begin() + static_cast<std::ptrdiff_t>(more * channels));
+            }
+        }
+
+        succeeded[index] = last || got == want;
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(segments - 1);
+    for (unsigned i = 1; i < segments; ++i) {
+        workers.emplace_back(decode_segment, i);
+    }
+    decode_segment(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    if (std::find(succeeded.begin(), succeeded.end(), 0) != succeeded.end()) {
+        return std::nullopt;
+    }
+
+    uint64_t last_start = estimated_frames * (segments - 1) / segments;
+    samples.resize(static_cast<size_t>(last_start + decoded.back()) * channels);
+    samples.insert(samples.end(), tail.begin(), tail.end());
+    return samples;
+}
+
+} // namespace
+
 struct AudioDecoder::Impl {
     AVFormatContext* format_ctx = nullptr;
     AVCodecContext* codec_ctx = nullptr;
@@ -18,11 +111,166 @@ struct AudioDecoder::Impl {
     AVFrame* frame = nullptr;
     AVPacket* packet = nullptr;
 
+    std::string filepath;
     int audio_stream_index = -1;
     double duration_seconds = 0.0;
     bool is_open = false;
+
+    // Streaming state
+    uint32_t stream_sample_rate = 0;
+    uint32_t stream_channels = 0;
+    std::vector<float> pending;
+    size_t pending_offset = 0;
+    std::vector<const uint8_t*> input_planes;
+    int64_t next_frame = 0;
+    int64_t discard_until = 0;
+    bool position_known = true;  // false after a seek until the first frame
+    bool draining = false;
+    bool finished = false;
+
+    std::expected<void, std::string> init_resampler(uint32_t target_sample_rate, uint32_t target_channels);
+    void append_converted(AVFrame* source);
+    bool decode_into_pending();
 };
 
+std::expected<void, std::string> AudioDecoder::Impl::init_resampler(uint32_t target_sample_rate,
+                                                                   uint32_t target_channels) {
+    if (swr_ctx) {
+        swr_free(&swr_ctx);
+    }
+
+    AVChannelLayout out_ch_layout;
+    av_channel_layout_default(&out_ch_layout, static_cast<int>(target_channels));
+
+    int ret = swr_alloc_set_opts2(
+        &swr_ctx,
+        &out_ch_layout,
+        AV_SAMPLE_FMT_FLT,
+        static_cast<int>(target_sample_rate),
+        &codec_ctx->ch_layout,
+        codec_ctx->sample_fmt,
+        codec_ctx->sample_rate,
+        0,
+        nullptr
+    );
+    av_channel_layout_uninit(&out_ch_layout);
+
+    if (ret < 0 || !swr_ctx) {
+        return std::unexpected("Failed to allocate resampler");
+    }
+
+    if (swr_init(swr_ctx) < 0) {
+        return std::unexpected("Failed to initialize resampler");
+    }
+    return {};
+}
+
+void AudioDecoder::Impl::append_converted(AVFrame* source) {
+    int skip = 0;
+    if (!position_known && source) {
+        AVStream* stream = format_ctx->streams[audio_stream_index];
+        int64_t timestamp = source->best_effort_timestamp;
+        if (timestamp != AV_NOPTS_VALUE) {
+            if (stream->start_time != AV_NOPTS_VALUE) {
+                timestamp -= stream->start_time;
+            }
+            // The fresh resampler must start on an input sample that maps
+            // to a whole output frame, or the whole segment would sit a
+            // fraction of a sample off a sequential decode.
+            int64_t in_rate = codec_ctx->sample_rate;
+            int64_t out_rate = stream_sample_rate;
+            int64_t divisor = std::gcd(in_rate, out_rate);
+            int64_t step = in_rate / divisor;
+            int64_t input_frame = av_rescale_q(timestamp, stream->time_base, AVRational{1, static_cast<int>(in_rate)});
+            int64_t aligned = input_frame + ((step - input_frame % step) % step);
+            if (aligned - input_frame >= source->nb_samples) {
+                return;
+            }
+            skip = static_cast<int>(aligned - input_frame);
+            next_frame = aligned / step * (out_rate / divisor);
+        } else {
+            next_frame = discard_until;
+        }
+        position_known = true;
+    }
+
+    int in_samples = source ? source->nb_samples - skip : 0;
+    int out_samples = swr_get_out_samples(swr_ctx, in_samples);
+    if (out_samples <= 0) return;
+
+    input_planes.clear();
+    if (source) {
+        auto format = static_cast<AVSampleFormat>(source->format);
+        bool planar = av_sample_fmt_is_planar(format);
+        int channels = source->ch_layout.nb_channels;
+        size_t offset = static_cast<size_t>(skip) * static_cast<size_t>(av_get_bytes_per_sample(format)) *
+                        static_cast<size_t>(planar ? 1 : channels);
+        for (int plane = 0; plane < (planar ? channels : 1); ++plane) {
+            input_planes.push_back(source->extended_data[plane] + offset);
+        }
+    }
+
+    size_t old_size = pending.size();
+    pending.resize(old_size + static_cast<size_t>(out_samples) * stream_channels);
+    uint8_t* out_buffer = reinterpret_cast<uint8_t*>(pending.data() + old_size);
+
+    int converted = swr_convert(
+        swr_ctx,
+        &out_buffer,
+        out_samples,
+        source ? input_planes.data() : nullptr,
+        in_samples
+    );
+    converted = std::max(converted, 0);
+    pending.resize(old_size + static_cast<size_t>(converted) * stream_channels);
+
+    // After a seek the demuxer lands on the packet boundary before the
+    // pre-roll; drop everything before the requested frame.
+    if (next_frame < discard_until && converted > 0) {
+        int64_t drop = std::min<int64_t>(converted, discard_until - next_frame);
+        auto begin = pending.begin() + static_cast<std::ptrdiff_t>(old_size);
+        pending.erase(begin, begin + static_cast<std::ptrdiff_t>(drop * stream_channels));
+    }
+    next_frame += converted;
+}
+
+bool AudioDecoder::Impl::decode_into_pending() {
+    pending.clear();
+    pending_offset = 0;
+
+    while (pending.empty()) {
+        int ret = avcodec_receive_frame(codec_ctx, frame);
+        if (ret == 0) {
+            append_converted(frame);
+            av_frame_unref(frame);
+            continue;
+        }
+
+        if (ret == AVERROR_EOF) {
+            if (finished) return false;
+            finished = true;
+            append_converted(nullptr);
+            return !pending.empty();
+        }
+
+        if (ret != AVERROR(EAGAIN) || draining) {
+            return false;
+        }
+
+        if (av_read_frame(format_ctx, packet) < 0) {
+            avcodec_send_packet(codec_ctx, nullptr);
+            draining = true;
+            continue;
+        }
+
+        if (packet->stream_index == audio_stream_index) {
+            avcodec_send_packet(codec_ctx, packet);
+        }
+        av_packet_unref(packet);
+    }
+    return true;
+}
+
 AudioDecoder::AudioDecoder() : impl_(std::make_unique<Impl>()) {}
 
 AudioDecoder::~AudioDecoder() {
@@ -38,6 +286,7 @@ std::expected<void, std::string> AudioDecoder::open(const std::string& filepath)
     if (avformat_open_input(&impl_->format_ctx, filepath.c_str(), nullptr, nullptr) < 0) {
         return std::unexpected("Failed to open file");
     }
+    impl_->filepath = filepath;
 
     if (avformat_find_stream_info(impl_->format_ctx, nullptr) < 0) {
         close();
@@ -117,9 +366,20 @@ void AudioDecoder::close() {
         avformat_close_input(&impl_->format_ctx);
     }
 
+    impl_->filepath.clear();
     impl_->audio_stream_index = -1;
     impl_->duration_seconds = 0.0;
     impl_->is_open = false;
+
+    impl_->stream_sample_rate = 0;
+    impl_->stream_channels = 0;
+    impl_->pending.clear();
+    impl_->pending_offset = 0;
+    impl_->next_frame = 0;
+    impl_->discard_until = 0;
+    impl_->position_known = true;
+    impl_->draining = false;
+    impl_->finished = false;
 }
 
 bool AudioDecoder::is_open() const {
@@ -135,7 +395,9 @@ double AudioDecoder::duration_seconds() const {
 }
 
 std::expected<AudioBuffer, std::string> AudioDecoder::extract_all(uint32_t target_sample_rate,
-                                                                   uint32_t target_channels) {
+                                                                   uint32_t target_channels,
+                                                                   SampleFormat format,
+                                                                   unsigned max_threads) {
     if (!impl_->is_open) {
         return std::unexpected("Decoder not open");
     }
@@ -144,121 +406,126 @@ std::expected<AudioBuffer, std::string> AudioDecoder::extract_all(uint32_t targe
         return std::unexpected("No audio stream");
     }
 
-    AVCodecContext* ctx = impl_->codec_ctx;
-
-    AVChannelLayout out_ch_layout;
-    av_channel_layout_default(&out_ch_layout, static_cast<int>(target_channels));
-
-    int ret = swr_alloc_set_opts2(
-        &impl_->swr_ctx,
-        &out_ch_layout,
-        AV_SAMPLE_FMT_FLT,
-        static_cast<int>(target_sample_rate),
-        &ctx->ch_layout,
-        ctx->sample_fmt,
-        ctx->sample_rate,
-        0,
-        nullptr
-    );
-
-    if (ret < 0 || !impl_->swr_ctx) {
-        av_channel_layout_uninit(&out_ch_layout);
-        return std::unexpected("Failed to allocate resampler");
-    }
-
-    if (swr_init(impl_->swr_ctx) < 0) {
-        av_channel_layout_uninit(&out_ch_layout);
-        return std::unexpected("Failed to initialize resampler");
-    }
+    uint64_t estimated_frames = static_cast<uint64_t>(impl_->duration_seconds * target_sample_rate);
+    unsigned segments = segment_count(impl_->duration_seconds, max_threads);
+    bool seekable = impl_->format_ctx->pb && (impl_->format_ctx->pb->seekable & AVIO_SEEKABLE_NORMAL);
 
     std::vector<float> all_samples;
-    all_samples.reserve(static_cast<size_t>(impl_->duration_seconds * target_sample_rate * target_channels));
+    if (segments > 1 && seekable) {
+        if (auto segmented = extract_segmented(impl_->filepath, estimated_frames, segments,
+                                               target_sample_rate, target_channels)) {
+            all_samples = std::move(*segmented);
+        }
+    }
 
-    while (av_read_frame(impl_->format_ctx, impl_->packet) >= 0) {
-        if (impl_->packet->stream_index != impl_->audio_stream_index) {
-            av_packet_unref(impl_->packet);
-            continue;
+    if (all_samples.empty()) {
+        if (auto prepared = prepare_stream(target_sample_rate, target_channels); !prepared) {
+            return std::unexpected(prepared.error());
         }
 
-        ret = avcodec_send_packet(impl_->codec_ctx, impl_->packet);
-        av_packet_unref(impl_->packet);
+        size_t capacity = std::max<uint64_t>(estimated_frames, READ_CHUNK_FRAMES);
+        size_t frames = 0;
+        all_samples.resize(capacity * target_channels);
+        while (true) {
+            if (frames == capacity) {
+                capacity += capacity / 2;
+                all_samples.resize(capacity * target_channels);
+            }
+            size_t requested = capacity - frames;
+            size_t got = read_frames(all_samples.data() + frames * target_channels, requested);
+            frames += got;
+            if (got < requested) break;
+        }
+        all_samples.resize(frames * target_channels);
+    }
 
-        if (ret < 0) continue;
+    return AudioBuffer(std::move(all_samples), target_sample_rate, target_channels, format);
+}
 
-        while (avcodec_receive_frame(impl_->codec_ctx, impl_->frame) >= 0) {
-            int out_samples = swr_get_out_samples(impl_->swr_ctx, impl_->frame->nb_samples);
-            if (out_samples <= 0) {
-                av_frame_unref(impl_->frame);
-                continue;
-            }
+std::expected<void, std::string> AudioDecoder::prepare_stream(uint32_t target_sample_rate,
+                                                               uint32_t target_channels) {
+    if (!impl_->is_open) {
+        return std::unexpected("Decoder not open");
+    }
 
-            std::vector<float> frame_buffer(static_cast<size_t>(out_samples * target_channels));
-            uint8_t* out_buffer = reinterpret_cast<uint8_t*>(frame_buffer.data());
-
-            int converted = swr_convert(
-                impl_->swr_ctx,
-                &out_buffer,
-                out_samples,
-                const_cast<const uint8_t**>(impl_->frame->extended_data),
-                impl_->frame->nb_samples
-            );
-
-            if (converted > 0) {
-                size_t sample_count = static_cast<size_t>(converted * target_channels);
-                all_samples.insert(all_samples.end(),
-                                   frame_buffer.begin(),
-                                   frame_buffer.begin() + sample_count);
-            }
+    if (impl_->audio_stream_index < 0) {
+        return std::unexpected("No audio stream");
+    }
 
-            av_frame_unref(impl_->frame);
-        }
+    if (auto resampler = impl_->init_resampler(target_sample_rate, target_channels); !resampler) {
+        return resampler;
     }
 
-    avcodec_send_packet(impl_->codec_ctx, nullptr);
-    while (avcodec_receive_frame(impl_->codec_ctx, impl_->frame) >= 0) {
-        int out_samples = swr_get_out_samples(impl_->swr_ctx, impl_->frame->nb_samples);
-        if (out_samples <= 0) {
-            av_frame_unref(impl_->frame);
+    impl_->stream_sample_rate = target_sample_rate;
+    impl_->stream_channels = target_channels;
+    impl_->pending.clear();
+    impl_->pending_offset = 0;
+    impl_->next_frame = 0;
+    impl_->discard_until = 0;
+    impl_->position_known = true;
+    impl_->draining = false;
+    impl_->finished = false;
+    return {};
+}
+
+size_t AudioDecoder::read_frames(float* out, size_t frame_count) {
+    if (impl_->stream_channels == 0) return 0;
+
+    const size_t channels = impl_->stream_channels;
+    size_t written = 0;
+    while (written < frame_count) {
+        size_t available = (impl_->pending.size() - impl_->pending_offset) / channels;
+        if (available == 0) {
+            if (!impl_->decode_into_pending()) break;
             continue;
         }
 
-        std::vector<float> frame_buffer(static_cast<size_t>(out_samples * target_channels));
-        uint8_t* out_buffer = reinterpret_cast<uint8_t*>(frame_buffer.data());
-
-        int converted = swr_convert(
-            impl_->swr_ctx,
-            &out_buffer,
-            out_samples,
-            const_cast<const uint8_t**>(impl_->frame->extended_data),
-            impl_->frame->nb_samples
-        );
-
-        if (converted > 0) {
-            size_t sample_count = static_cast<size_t>(converted * target_channels);
-            all_samples.insert(all_samples.end(),
-                               frame_buffer.begin(),
-                               frame_buffer.begin() + sample_count);
-        }
+        size_t count = std::min(available, frame_count - written);
+        std::memcpy(out + written * channels,
+                    impl_->pending.data() + impl_->pending_offset,
+                    count * channels * sizeof(float));
+        impl_->pending_offset += count * channels;
+        written += count;
+    }
+    return written;
+}
 
-        av_frame_unref(impl_->frame);
+bool AudioDecoder::seek_frame(uint64_t frame) {
+    if (impl_->stream_channels == 0) return false;
+
+    AVStream* stream = impl_->format_ctx->streams[impl_->audio_stream_index];
+    double preroll_seconds = SEEK_PREROLL_SECONDS;
+    if (stream->codecpar->seek_preroll > 0 && stream->codecpar->sample_rate > 0) {
+        preroll_seconds = std::max(preroll_seconds, static_cast<double>(stream->codecpar->seek_preroll) /
+                                                        stream->codecpar->sample_rate);
+    }
+    auto preroll = static_cast<uint64_t>(preroll_seconds * impl_->stream_sample_rate);
+    uint64_t seek_to = frame > preroll ? frame - preroll : 0;
+
+    int64_t timestamp = av_rescale_q(static_cast<int64_t>(seek_to),
+                                     AVRational{1, static_cast<int>(impl_->stream_sample_rate)},
+                                     stream->time_base);
+    if (stream->start_time != AV_NOPTS_VALUE) {
+        timestamp += stream->start_time;
     }
 
-    int flushed = swr_convert(impl_->swr_ctx, nullptr, 0, nullptr, 0);
-    if (flushed > 0) {
-        std::vector<float> flush_buffer(static_cast<size_t>(flushed * target_channels));
-        uint8_t* out_buffer = reinterpret_cast<uint8_t*>(flush_buffer.data());
-        int got = swr_convert(impl_->swr_ctx, &out_buffer, flushed, nullptr, 0);
-        if (got > 0) {
-            size_t sample_count = static_cast<size_t>(got * target_channels);
-            all_samples.insert(all_samples.end(),
-                               flush_buffer.begin(),
-                               flush_buffer.begin() + sample_count);
-        }
+    if (av_seek_frame(impl_->format_ctx, impl_->audio_stream_index, timestamp, AVSEEK_FLAG_BACKWARD) < 0) {
+        return false;
     }
 
-    av_channel_layout_uninit(&out_ch_layout);
+    avcodec_flush_buffers(impl_->codec_ctx);
+    if (!impl_->init_resampler(impl_->stream_sample_rate, impl_->stream_channels)) {
+        impl_->stream_channels = 0;
+        return false;
+    }
 
-    return AudioBuffer(std::move(all_samples), target_sample_rate, target_channels);
+    impl_->pending.clear();
+    impl_->pending_offset = 0;
+    impl_->discard_until = static_cast<int64_t>(frame);
+    impl_->position_known = false;
+    impl_->draining = false;
+    impl_->finished = false;
+    return true;
 }
 
 }
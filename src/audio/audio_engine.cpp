@@ -1,5 +1,9 @@
 #include "furious/audio/audio_engine.hpp"
+
+#define MINIAUDIO_IMPLEMENTATION
 #include "miniaudio.h"
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 
 namespace furious {
@@ -10,9 +14,84 @@ struct AudioEngine::Impl {
     uint64_t metronome_click_position = 0;  // (0 = not playing)
 };
 
+// Mixes one clip into the stereo output in contiguous runs of source frames,
+// so the buffer's format-specific kernel handles the per-sample work.
+static void mix_clip(const ClipAudioState& clip_state, uint64_t current_frame,
+                     ma_uint32 frame_count, float* out) {
+    if (!clip_state.buffer || clip_state.buffer->empty()) return;
+
+    const int64_t source_frames = static_cast<int64_t>(clip_state.buffer->frame_count());
+    const bool looped = clip_state.use_looped_audio && clip_state.loop_duration_frames > 0;
+
+    int64_t i = 0;
+    const int64_t total = static_cast<int64_t>(frame_count);
+    while (i < total) {
+        int64_t frame_in_clip = static_cast<int64_t>(current_frame) + i - clip_state.timeline_start_frame;
+        if (frame_in_clip < 0) {
+            i += -frame_in_clip;
+            continue;
+        }
+        if (frame_in_clip >= clip_state.duration_frames) {
+            break;
+        }
+
+        int64_t run = std::min(total - i, clip_state.duration_frames - frame_in_clip);
+        int64_t source_frame;
+        if (looped) {
+            int64_t adjusted_frame = frame_in_clip + clip_state.loop_phase_offset_frames;
+            int64_t position_in_loop = adjusted_frame % clip_state.loop_duration_frames;
+            if (position_in_loop < 0) position_in_loop += clip_state.loop_duration_frames;
+            source_frame = clip_state.loop_start_frames + position_in_loop;
+            run = std::min(run, clip_state.loop_duration_frames - position_in_loop);
+        } else {
+            source_frame = clip_state.source_offset_frames + frame_in_clip;
+        }
+
+        if (source_frame < 0) {
+            i += std::min(run, -source_frame);
+            continue;
+        }
+        if (source_frame < source_frames) {
+            run = std::min(run, source_frames - source_frame);
+            clip_state.buffer->mix_stereo(static_cast<uint64_t>(source_frame),
+                                          static_cast<uint64_t>(run),
+                                          clip_state.volume, out + i * 2);
+        }
+        i += run;
+    }
+}
+
+// Records the callback's elapsed time against its period on every exit path.
+class CallbackTimer {
+public:
+    CallbackTimer(AudioEngine& engine, ma_uint32 frame_count)
+        : engine_(engine)
+        , frame_count_(frame_count)
+        , start_(std::chrono::steady_clock::now()) {}
+
+    ~CallbackTimer() {
+        auto end = std::chrono::steady_clock::now();
+        float elapsed_us = std::chrono::duration<float, std::micro>(end - start_).count();
+        float period_us = 1e6f * static_cast<float>(frame_count_) / static_cast<float>(engine_.sample_rate());
+        auto start_us = std::chrono::duration_cast<std::chrono::microseconds>(start_.time_since_epoch()).count();
+        engine_.callback_stats().record(static_cast<int64_t>(start_us), elapsed_us, period_us, active_clips);
+    }
+
+    CallbackTimer(const CallbackTimer&) = delete;
+    CallbackTimer& operator=(const CallbackTimer&) = delete;
+
+    uint32_t active_clips = 0;
+
+private:
+    AudioEngine& engine_;
+    ma_uint32 frame_count_;
+    std::chrono::steady_clock::time_point start_;
+};
+
 static void audio_callback(ma_device* device, void* output, const void* /*input*/, ma_uint32 frame_count) {
     auto* engine = static_cast<AudioEngine*>(device->pUserData);
     auto* out = static_cast<float*>(output);
+    CallbackTimer timer(*engine, frame_count);
 
     bool has_clip = engine->has_clip();
     bool is_playing = engine->is_playing();
@@ -29,65 +108,17 @@ static void audio_callback(ma_device* device, void* output, const void* /*input*
     engine->swap_active_clips_if_pending();
 
     const auto& active_clips = engine->active_clips();
+    timer.active_clips = static_cast<uint32_t>(active_clips.size());
     for (const auto& clip_state : active_clips) {
-        if (!clip_state.buffer || clip_state.buffer->empty()) continue;
-
-        uint32_t channels = clip_state.buffer->channels();
-
-        for (ma_uint32 i = 0; i < frame_count; ++i) {
-            int64_t global_frame = static_cast<int64_t>(current_frame + i);
-            int64_t frame_in_clip = global_frame - clip_state.timeline_start_frame;
-
-            if (frame_in_clip < 0 || frame_in_clip >= clip_state.duration_frames) {
-                continue;
-            }
-
-            int64_t source_frame;
-            if (clip_state.use_looped_audio && clip_state.loop_duration_frames > 0) {
-                int64_t adjusted_frame = frame_in_clip + clip_state.loop_phase_offset_frames;
-                int64_t position_in_loop = adjusted_frame % clip_state.loop_duration_frames;
-                if (position_in_loop < 0) position_in_loop += clip_state.loop_duration_frames;
-                source_frame = clip_state.loop_start_frames + position_in_loop;
-            } else {
-                source_frame = clip_state.source_offset_frames + frame_in_clip;
-            }
-
-            if (source_frame < 0 || source_frame >= static_cast<int64_t>(clip_state.buffer->frame_count())) {
-                continue;
-            }
-
-            float left = clip_state.buffer->sample_at(static_cast<uint64_t>(source_frame), 0);
-            float right = channels >= 2
-                ? clip_state.buffer->sample_at(static_cast<uint64_t>(source_frame), 1)
-                : left;
-
-            out[i * 2] += left * clip_state.volume;
-            out[i * 2 + 1] += right * clip_state.volume;
-        }
+        mix_clip(clip_state, current_frame, frame_count, out);
     }
 
     if (has_clip) {
-        const AudioClip* clip = engine->clip();
-        uint32_t channels = clip->channels();
         uint64_t start_frame = engine->clip_start_frame();
-        uint64_t end_frame = engine->clip_end_frame();
-        uint64_t trimmed_duration = end_frame - start_frame;
-
-        for (ma_uint32 i = 0; i < frame_count; ++i) {
-            uint64_t playhead_pos = current_frame + i;
-            if (playhead_pos < trimmed_duration) {
-                uint64_t clip_frame = start_frame + playhead_pos;
-                if (clip_frame < clip->total_frames()) {
-                    size_t sample_index = clip_frame * channels;
-                    if (channels >= 2) {
-                        out[i * 2] += clip->data()[sample_index];
-                        out[i * 2 + 1] += clip->data()[sample_index + 1];
-                    } else {
-                        out[i * 2] += clip->data()[sample_index];
-                        out[i * 2 + 1] += clip->data()[sample_index];
-                    }
-                }
-            }
+        uint64_t trimmed_duration = engine->clip_end_frame() - start_frame;
+        if (current_frame < trimmed_duration) {
+            auto frames = static_cast<uint32_t>(std::min<uint64_t>(frame_count, trimmed_duration - current_frame));
+            engine->clip()->mix_into(start_frame + current_frame, frames, out);
         }
     }
 
@@ -263,6 +294,7 @@ void AudioEngine::set_clip_start_seconds(double seconds) {
 void AudioEngine::set_clip_end_seconds(double seconds) {
     if (seconds >= 0.0) {
         clip_end_seconds_ = seconds;
+        clip_end_at_length_ = clip_ && clip_->is_loaded() && seconds >= clip_->duration_seconds();
         if (clip_ && clip_->is_loaded()) {
             uint64_t trimmed_duration = clip_end_frame() - clip_start_frame();
             if (playhead_frame_.load() > trimmed_duration) {
@@ -276,13 +308,22 @@ void AudioEngine::reset_clip_bounds() {
     clip_start_seconds_ = 0.0;
     if (clip_ && clip_->is_loaded()) {
         clip_end_seconds_ = clip_->duration_seconds();
+        clip_end_at_length_ = true;
     } else {
         clip_end_seconds_ = 0.0;
+        clip_end_at_length_ = false;
+    }
+}
+
+double AudioEngine::clip_end_seconds() const {
+    if (clip_end_at_length_.load() && clip_ && clip_->is_loaded()) {
+        return clip_->duration_seconds();
     }
+    return clip_end_seconds_.load();
 }
 
 double AudioEngine::trimmed_duration_seconds() const {
-    return clip_end_seconds_.load() - clip_start_seconds_.load();
+    return clip_end_seconds() - clip_start_seconds_.load();
 }
 
 uint64_t AudioEngine::clip_start_frame() const {
@@ -291,7 +332,7 @@ uint64_t AudioEngine::clip_start_frame() const {
 
 uint64_t AudioEngine::clip_end_frame() const {
     double end_seconds = clip_end_seconds_.load();
-    if (end_seconds <= 0.0 && clip_ && clip_->is_loaded()) {
+    if ((end_seconds <= 0.0 || clip_end_at_length_.load()) && clip_ && clip_->is_loaded()) {
         return clip_->total_frames();
     }
     return static_cast<uint64_t>(end_seconds * sample_rate_);
@@ -2,6 +2,18 @@
 
 namespace furious {
 
+void CompoundCommand::execute() {
+    for (auto& cmd : commands_) {
+        cmd->execute();
+    }
+}
+
+void CompoundCommand::undo() {
+    for (auto it = commands_.rbegin(); it != commands_.rend(); ++it) {
+        (*it)->undo();
+    }
+}
+
 void CommandHistory::execute(std::unique_ptr<Command> cmd) {
     cmd->execute();
     undo_stack_.push_back(std::move(cmd));
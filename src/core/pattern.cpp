@@ -1,4 +1,5 @@
 #include "furious/core/pattern.hpp"
+#include <algorithm>
 
 namespace furious {
 
@@ -37,4 +38,85 @@ std::optional<float> Pattern::value_at(int subdivision, PatternTargetProperty pr
     return std::nullopt;
 }
 
+CompiledPattern Pattern::compile() const {
+    CompiledPattern compiled;
+    if (length_subdivisions <= 0 || triggers.empty()) {
+        return compiled;
+    }
+
+    const auto length = static_cast<size_t>(length_subdivisions);
+    compiled.length_subdivisions = length_subdivisions;
+    compiled.held_values.assign(length * PATTERN_PROPERTY_COUNT, 0.0f);
+
+    // A property holds the value of the nearest trigger at or before the
+    // subdivision, wrapping around the pattern; the first trigger wins ties.
+    for (size_t prop = 0; prop < PATTERN_PROPERTY_COUNT; ++prop) {
+        auto target = static_cast<PatternTargetProperty>(prop);
+        for (int subdivision = 0; subdivision < length_subdivisions; ++subdivision) {
+            const PatternTrigger* best = nullptr;
+            int best_distance = length_subdivisions + 1;
+
+            for (const auto& trigger : triggers) {
+                if (trigger.target != target) continue;
+
+                int distance;
+                if (trigger.subdivision_index <= subdivision) {
+                    distance = subdivision - trigger.subdivision_index;
+                } else {
+                    distance = subdivision + (length_subdivisions - trigger.subdivision_index);
+                }
+
+                if (distance < best_distance) {
+                    best_distance = distance;
+                    best = &trigger;
+                }
+            }
+
+            if (!best) break;
+            compiled.has_property[prop] = true;
+            compiled.held_values[static_cast<size_t>(subdivision) * PATTERN_PROPERTY_COUNT + prop] = best->value;
+        }
+    }
+
+    std::vector<int> restart_subdivs;
+    compiled.restarts.assign(length, 0);
+    for (const auto& trigger : triggers) {
+        if (!settings_for(trigger.target).restart_on_trigger) continue;
+        restart_subdivs.push_back(trigger.subdivision_index);
+        if (trigger.subdivision_index >= 0 && trigger.subdivision_index < length_subdivisions) {
+            compiled.restarts[static_cast<size_t>(trigger.subdivision_index)] = 1;
+        }
+    }
+
+    if (restart_subdivs.empty()) {
+        return compiled;
+    }
+
+    std::sort(restart_subdivs.begin(), restart_subdivs.end());
+    restart_subdivs.erase(std::unique(restart_subdivs.begin(), restart_subdivs.end()), restart_subdivs.end());
+
+    compiled.has_restarts = true;
+    compiled.loop_start.resize(length);
+    compiled.loop_interval.resize(length);
+
+    for (int subdivision = 0; subdivision < length_subdivisions; ++subdivision) {
+        int most_recent = restart_subdivs.back();
+        int next = restart_subdivs.front();
+        for (size_t i = 0; i < restart_subdivs.size(); ++i) {
+            if (restart_subdivs[i] <= subdivision) {
+                most_recent = restart_subdivs[i];
+                next = restart_subdivs[(i + 1) % restart_subdivs.size()];
+            }
+        }
+
+        auto at = static_cast<size_t>(subdivision);
+        compiled.loop_start[at] = most_recent;
+        compiled.loop_interval[at] = next > most_recent
+            ? next - most_recent
+            : length_subdivisions - most_recent + next;
+    }
+
+    return compiled;
+}
+
 } // namespace furious
@@ -12,35 +12,108 @@ std::string PatternLibrary::create_pattern(const std::string& name) {
     pattern.name = name;
     pattern.length_subdivisions = 16;
     patterns_.push_back(pattern);
+    bind_handle(patterns_.size() - 1);
     return pattern.id;
 }
 
 void PatternLibrary::add_pattern(const Pattern& pattern) {
     patterns_.push_back(pattern);
+    bind_handle(patterns_.size() - 1);
 }
 
 void PatternLibrary::remove_pattern(std::string_view pattern_id) {
     std::erase_if(patterns_, [pattern_id](const Pattern& p) {
         return p.id == pattern_id;
     });
+    rebind_handles();
 }
 
 Pattern* PatternLibrary::find_pattern(std::string_view pattern_id) {
-    auto it = std::ranges::find_if(patterns_, [pattern_id](const Pattern& p) {
-        return p.id == pattern_id;
-    });
-    return it != patterns_.end() ? &(*it) : nullptr;
+    return find_pattern(handles_.find(pattern_id));
 }
 
 const Pattern* PatternLibrary::find_pattern(std::string_view pattern_id) const {
-    auto it = std::ranges::find_if(patterns_, [pattern_id](const Pattern& p) {
-        return p.id == pattern_id;
-    });
-    return it != patterns_.end() ? &(*it) : nullptr;
+    return find_pattern(handles_.find(pattern_id));
+}
+
+Pattern* PatternLibrary::find_pattern(PatternHandle handle) {
+    size_t slot = handles_.slot(handle);
+    return slot != HandleTable<PatternTag>::NO_SLOT ? &patterns_[slot] : nullptr;
+}
+
+const Pattern* PatternLibrary::find_pattern(PatternHandle handle) const {
+    size_t slot = handles_.slot(handle);
+    return slot != HandleTable<PatternTag>::NO_SLOT ? &patterns_[slot] : nullptr;
+}
+
+void PatternLibrary::update_pattern(std::string_view pattern_id, const Pattern& state) {
+    size_t slot = handles_.slot(handles_.find(pattern_id));
+    if (slot == HandleTable<PatternTag>::NO_SLOT) return;
+
+    std::string id = std::move(patterns_[slot].id);
+    patterns_[slot] = state;
+    patterns_[slot].id = std::move(id);
+    mark_pattern_modified(pattern_id);
+}
+
+void PatternLibrary::mark_pattern_modified(std::string_view pattern_id) {
+    size_t slot = handles_.slot(handles_.find(pattern_id));
+    if (slot == HandleTable<PatternTag>::NO_SLOT) return;
+
+    compiled_[slot].reset();
+    revisions_[slot] = next_revision_++;
+}
+
+const Pattern* PatternLibrary::find_pattern(const ClipPatternReference& ref) const {
+    if (!handles_.is_current(ref.pattern_handle)) {
+        ref.pattern_handle = handles_.find(ref.pattern_id);
+    }
+    return find_pattern(ref.pattern_handle);
+}
+
+const CompiledPattern* PatternLibrary::compiled_pattern(const ClipPatternReference& ref) const {
+    const Pattern* pattern = find_pattern(ref);
+    if (!pattern) return nullptr;
+
+    auto& compiled = compiled_[static_cast<size_t>(pattern - patterns_.data())];
+    if (!compiled) {
+        compiled = pattern->compile();
+    }
+    return &*compiled;
+}
+
+uint64_t PatternLibrary::pattern_revision(const ClipPatternReference& ref) const {
+    const Pattern* pattern = find_pattern(ref);
+    if (!pattern) return 0;
+    return revisions_[static_cast<size_t>(pattern - patterns_.data())];
 }
 
 void PatternLibrary::clear() {
     patterns_.clear();
+    compiled_.clear();
+    revisions_.clear();
+    handles_.clear();
+}
+
+void PatternLibrary::bind_handle(size_t pattern) {
+    compiled_.resize(patterns_.size());
+    while (revisions_.size() < patterns_.size()) {
+        revisions_.push_back(next_revision_++);
+    }
+    PatternHandle handle = handles_.intern(patterns_[pattern].id);
+    if (handles_.slot(handle) == HandleTable<PatternTag>::NO_SLOT) {
+        handles_.bind(handle, pattern);
+    }
+}
+
+void PatternLibrary::rebind_handles() {
+    compiled_.assign(patterns_.size(), std::nullopt);
+    revisions_.clear();
+    handles_.unbind_all();
+    for (size_t i = 0; i < patterns_.size(); ++i) {
+        bind_handle(i);
+    }
+    handles_.release_unbound();
 }
 
 std::string PatternLibrary::duplicate_pattern(std::string_view pattern_id) {
@@ -53,6 +126,7 @@ std::string PatternLibrary::duplicate_pattern(std::string_view pattern_id) {
     copy.id = generate_id();
     copy.name = original->name + " (Copy)";
     patterns_.push_back(copy);
+    bind_handle(patterns_.size() - 1);
     return copy.id;
 }
 
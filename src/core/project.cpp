@@ -1,4 +1,5 @@
 #include "furious/core/project.hpp"
+#include <algorithm>
 #include <utility>
 
 namespace furious {
@@ -31,4 +32,9 @@ void Project::set_grid_subdivision(NoteSubdivision subdivision) {
     grid_subdivision_ = subdivision;
 }
 
+void Project::set_resolution(int width, int height) {
+    width_ = std::max(width, 1);
+    height_ = std::max(height, 1);
+}
+
 } // namespace furious
@@ -259,6 +259,8 @@ bool ProjectData::save_to_file(const std::string& filepath) const {
     j["tempo"]["bpm"] = bpm;
     j["tempo"]["grid_subdivision"] = enum_to_string(grid_subdivision);
     j["tempo"]["fps"] = fps;
+    j["output"]["width"] = output_width;
+    j["output"]["height"] = output_height;
     j["transport"]["metronome_enabled"] = metronome_enabled;
     j["transport"]["follow_playhead"] = follow_playhead;
     j["transport"]["loop_enabled"] = loop_enabled;
@@ -275,6 +277,7 @@ bool ProjectData::save_to_file(const std::string& filepath) const {
     j["audio"]["filepath"] = audio_filepath;
     j["audio"]["clip_start_seconds"] = clip_start_seconds;
     j["audio"]["clip_end_seconds"] = clip_end_seconds;
+    j["audio"]["sample_format"] = enum_to_string(audio_sample_format);
 
     j["sources"] = nlohmann::json::array();
     for (const auto& source : sources) {
@@ -332,6 +335,12 @@ bool ProjectData::load_from_file(const std::string& filepath, ProjectData& out_d
         out_data.fps = tempo.value("fps", 30.0);
     }
 
+    if (j.contains("output")) {
+        auto& output = j["output"];
+        out_data.output_width = output.value("width", 1920);
+        out_data.output_height = output.value("height", 1080);
+    }
+
     if (j.contains("transport")) {
         auto& transport = j["transport"];
         out_data.metronome_enabled = transport.value("metronome_enabled", false);
@@ -360,6 +369,7 @@ bool ProjectData::load_from_file(const std::string& filepath, ProjectData& out_d
         out_data.audio_filepath = audio.value("filepath", "");
         out_data.clip_start_seconds = audio.value("clip_start_seconds", 0.0);
         out_data.clip_end_seconds = audio.value("clip_end_seconds", 0.0);
+        out_data.audio_sample_format = string_to_enum(audio.value("sample_format", "float32"), SampleFormat::Float32);
     }
 
     out_data.sources.clear();
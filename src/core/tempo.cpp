@@ -7,7 +7,11 @@ namespace furious {
 Tempo::Tempo(double bpm) : bpm_(std::clamp(bpm, 1.0, 999.0)) {}
 
 void Tempo::set_bpm(double bpm) {
-    bpm_ = std::clamp(bpm, 1.0, 999.0);
+    double clamped = std::clamp(bpm, 1.0, 999.0);
+    if (clamped != bpm_) {
+        bpm_ = clamped;
+        ++generation_;
+    }
 }
 
 double Tempo::bpm() const {
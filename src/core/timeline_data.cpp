@@ -3,6 +3,7 @@
 #include <random>
 #include <sstream>
 #include <iomanip>
+#include <limits>
 
 namespace furious {
 
@@ -18,6 +19,7 @@ size_t TimelineData::add_track(std::string name) {
         track.name = std::move(name);
     }
     tracks_.push_back(track);
+    ++generation_;
     return tracks_.size() - 1;
 }
 
@@ -39,6 +41,9 @@ void TimelineData::remove_track(size_t index) {
     }
 
     tracks_.erase(tracks_.begin() + static_cast<ptrdiff_t>(index));
+    rebind_handles();
+    index_dirty_ = true;
+    ++generation_;
 }
 
 void TimelineData::add_clip(const TimelineClip& clip) {
@@ -46,7 +51,16 @@ void TimelineData::add_clip(const TimelineClip& clip) {
     if (new_clip.id.empty()) {
         new_clip.id = generate_id();
     }
+
+    if (!index_dirty_) {
+        ensure_index();
+    }
     clips_.push_back(new_clip);
+    bind_handle(clips_.size() - 1);
+    if (!index_dirty_) {
+        index_insert(clips_.size() - 1);
+    }
+    ++generation_;
 }
 
 void TimelineData::remove_clip(std::string_view clip_id) {
@@ -57,6 +71,9 @@ void TimelineData::remove_clip(std::string_view clip_id) {
             }),
         clips_.end()
     );
+    rebind_handles();
+    index_dirty_ = true;
+    ++generation_;
 }
 
 void TimelineData::remove_clips_by_source(std::string_view source_id) {
@@ -67,6 +84,9 @@ void TimelineData::remove_clips_by_source(std::string_view source_id) {
             }),
         clips_.end()
     );
+    rebind_handles();
+    index_dirty_ = true;
+    ++generation_;
 }
 
 bool TimelineData::has_clips_using_source(std::string_view source_id) const {
@@ -77,70 +97,137 @@ bool TimelineData::has_clips_using_source(std::string_view source_id) const {
 }
 
 TimelineClip* TimelineData::find_clip(std::string_view clip_id) {
-    auto it = std::find_if(clips_.begin(), clips_.end(),
-        [clip_id](const TimelineClip& clip) {
-            return clip.id == clip_id;
-        });
-    return it != clips_.end() ? &(*it) : nullptr;
+    return find_clip(handles_.find(clip_id));
 }
 
 const TimelineClip* TimelineData::find_clip(std::string_view clip_id) const {
-    auto it = std::find_if(clips_.begin(), clips_.end(),
-        [clip_id](const TimelineClip& clip) {
-            return clip.id == clip_id;
-        });
-    return it != clips_.end() ? &(*it) : nullptr;
+    return find_clip(handles_.find(clip_id));
+}
+
+TimelineClip* TimelineData::find_clip(ClipHandle handle) {
+    size_t slot = handles_.slot(handle);
+    return slot != HandleTable<ClipTag>::NO_SLOT ? &clips_[slot] : nullptr;
+}
+
+const TimelineClip* TimelineData::find_clip(ClipHandle handle) const {
+    size_t slot = handles_.slot(handle);
+    return slot != HandleTable<ClipTag>::NO_SLOT ? &clips_[slot] : nullptr;
+}
+
+ClipHandle TimelineData::handle_of(const TimelineClip& clip) const {
+    if (!clips_.empty() && &clip >= clips_.data() && &clip < clips_.data() + clips_.size()) {
+        return clip_handles_[static_cast<size_t>(&clip - clips_.data())];
+    }
+    return handles_.find(clip.id);
+}
+
+void TimelineData::set_clip_span(std::string_view clip_id, double start_beat, double duration_beats,
+                                 size_t track_index) {
+    size_t slot = handles_.slot(handles_.find(clip_id));
+    if (slot == HandleTable<ClipTag>::NO_SLOT) return;
+
+    auto& clip = clips_[slot];
+    if (clip.start_beat == start_beat && clip.duration_beats == duration_beats &&
+        clip.track_index == track_index) {
+        return;
+    }
+    clip.start_beat = start_beat;
+    clip.duration_beats = duration_beats;
+    clip.track_index = track_index;
+    reindex(slot);
+}
+
+void TimelineData::update_clip(std::string_view clip_id, const TimelineClip& state) {
+    size_t slot = handles_.slot(handles_.find(clip_id));
+    if (slot == HandleTable<ClipTag>::NO_SLOT) return;
+
+    std::string id = std::move(clips_[slot].id);
+    clips_[slot] = state;
+    clips_[slot].id = std::move(id);
+    reindex(slot);
+}
+
+template<typename Fn>
+void TimelineData::visit_candidates(const TrackIndex& track, size_t upper, double min_end, Fn&& fn) {
+    for (size_t i = upper; i-- > 0;) {
+        if (track.max_end[i] <= min_end) break;
+        if (track.entries[i].end > min_end) {
+            fn(track.entries[i]);
+        }
+    }
 }
 
 std::vector<TimelineClip*> TimelineData::clips_at_beat(double beat) {
+    ensure_index();
+
     std::vector<TimelineClip*> result;
-    for (auto& clip : clips_) {
-        if (clip.contains_beat(beat)) {
-            result.push_back(&clip);
-        }
+    for (const auto& track : track_index_) {
+        auto upper = std::upper_bound(track.entries.begin(), track.entries.end(), beat,
+            [](double value, const IndexEntry& entry) { return value < entry.start; });
+        size_t first = result.size();
+        visit_candidates(track, static_cast<size_t>(upper - track.entries.begin()), beat,
+            [&](const IndexEntry& entry) { result.push_back(&clips_[entry.clip]); });
+        std::reverse(result.begin() + static_cast<ptrdiff_t>(first), result.end());
     }
-    std::sort(result.begin(), result.end(),
-        [](const TimelineClip* a, const TimelineClip* b) {
-            return a->track_index < b->track_index;
-        });
+
+    return result;
+}
+
+std::vector<TimelineClip*> TimelineData::clips_in_range(double start_beat, double end_beat) {
+    ensure_index();
+
+    std::vector<TimelineClip*> result;
+    for (const auto& track : track_index_) {
+        auto upper = std::lower_bound(track.entries.begin(), track.entries.end(), end_beat,
+            [](const IndexEntry& entry, double value) { return entry.start < value; });
+        size_t first = result.size();
+        visit_candidates(track, static_cast<size_t>(upper - track.entries.begin()), start_beat,
+            [&](const IndexEntry& entry) { result.push_back(&clips_[entry.clip]); });
+        std::reverse(result.begin() + static_cast<ptrdiff_t>(first), result.end());
+    }
+
     return result;
 }
 
 std::vector<TimelineClip*> TimelineData::clips_starting_between(double start_beat, double end_beat) {
+    ensure_index();
+
     std::vector<TimelineClip*> result;
-    for (auto& clip : clips_) {
-        if (clip.start_beat > start_beat && clip.start_beat <= end_beat) {
-            result.push_back(&clip);
+    for (const auto& track : track_index_) {
+        auto first = std::upper_bound(track.entries.begin(), track.entries.end(), start_beat,
+            [](double value, const IndexEntry& entry) { return value < entry.start; });
+        auto last = std::upper_bound(first, track.entries.end(), end_beat,
+            [](double value, const IndexEntry& entry) { return value < entry.start; });
+        for (auto it = first; it != last; ++it) {
+            result.push_back(&clips_[it->clip]);
         }
     }
+
     return result;
 }
 
 std::vector<TimelineClip*> TimelineData::clips_on_track(size_t track_index) {
+    ensure_index();
+
     std::vector<TimelineClip*> result;
-    for (auto& clip : clips_) {
-        if (clip.track_index == track_index) {
-            result.push_back(&clip);
-        }
+    if (track_index >= track_index_.size()) return result;
+
+    for (const auto& entry : track_index_[track_index].entries) {
+        result.push_back(&clips_[entry.clip]);
     }
-    std::sort(result.begin(), result.end(),
-        [](const TimelineClip* a, const TimelineClip* b) {
-            return a->start_beat < b->start_beat;
-        });
+
     return result;
 }
 
 std::vector<const TimelineClip*> TimelineData::clips_on_track(size_t track_index) const {
+    ensure_index();
+
     std::vector<const TimelineClip*> result;
-    for (const auto& clip : clips_) {
-        if (clip.track_index == track_index) {
-            result.push_back(&clip);
-        }
+    if (track_index >= track_index_.size()) return result;
+
+    for (const auto& entry : track_index_[track_index].entries) {
+        result.push_back(&clips_[entry.clip]);
     }
-    std::sort(result.begin(), result.end(),
-        [](const TimelineClip* a, const TimelineClip* b) {
-            return a->start_beat < b->start_beat;
-        });
     return result;
 }
 
@@ -148,22 +235,41 @@ void TimelineData::for_each_clip(std::function<void(TimelineClip&)> fn) {
     for (auto& clip : clips_) {
         fn(clip);
     }
+    index_dirty_ = true;
+    ++generation_;
+}
+
+void TimelineData::publish_snapshot() {
+    uint64_t current = generation();
+    std::shared_ptr<const TimelineSnapshot> previous = snapshot_.load(std::memory_order_relaxed);
+    if (previous && previous->generation() == current) {
+        return;
+    }
+    snapshot_.store(TimelineSnapshot::create(current, tracks_, clips_, clip_handles_, previous.get()),
+                    std::memory_order_release);
+}
+
+std::shared_ptr<const TimelineSnapshot> TimelineData::snapshot() const {
+    return snapshot_.load(std::memory_order_acquire);
 }
 
 size_t TimelineData::find_available_track(double start_beat, double duration_beats) const {
+    ensure_index();
+
     double end_beat = start_beat + duration_beats;
 
     for (size_t track_idx = 0; track_idx < tracks_.size(); ++track_idx) {
-        bool has_overlap = false;
-        for (const auto& clip : clips_) {
-            if (clip.track_index != track_idx) continue;
-
-            double clip_end = clip.start_beat + clip.duration_beats;
-            if (start_beat < clip_end && end_beat > clip.start_beat) {
-                has_overlap = true;
-                break;
-            }
+        if (track_idx >= track_index_.size()) {
+            return track_idx;
         }
+
+        const auto& track = track_index_[track_idx];
+        auto upper = std::lower_bound(track.entries.begin(), track.entries.end(), end_beat,
+            [](const IndexEntry& entry, double value) { return entry.start < value; });
+
+        bool has_overlap = false;
+        visit_candidates(track, static_cast<size_t>(upper - track.entries.begin()), start_beat,
+            [&](const IndexEntry&) { has_overlap = true; });
         if (!has_overlap) {
             return track_idx;
         }
@@ -172,23 +278,146 @@ size_t TimelineData::find_available_track(double start_beat, double duration_bea
     return tracks_.size();
 }
 
+void TimelineData::ensure_index() const {
+    if (index_dirty_ || indexed_spans_.size() != clips_.size()) {
+        rebuild_index();
+    }
+}
+
+void TimelineData::rebuild_index() const {
+    track_index_.clear();
+    indexed_spans_.assign(clips_.size(), IndexEntry{});
+    indexed_tracks_.assign(clips_.size(), 0);
+
+    for (size_t i = 0; i < clips_.size(); ++i) {
+        const auto& clip = clips_[i];
+        if (clip.track_index >= track_index_.size()) {
+            track_index_.resize(clip.track_index + 1);
+        }
+        IndexEntry entry{clip.start_beat, clip.end_beat(), i};
+        track_index_[clip.track_index].entries.push_back(entry);
+        indexed_spans_[i] = entry;
+        indexed_tracks_[i] = clip.track_index;
+    }
+
+    for (auto& track : track_index_) {
+        std::stable_sort(track.entries.begin(), track.entries.end(),
+            [](const IndexEntry& a, const IndexEntry& b) { return a.start < b.start; });
+        track.max_end.resize(track.entries.size());
+        double running = -std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < track.entries.size(); ++i) {
+            running = std::max(running, track.entries[i].end);
+            track.max_end[i] = running;
+        }
+    }
+
+    index_dirty_ = false;
+}
+
+void TimelineData::index_insert(size_t clip) const {
+    const auto& source = clips_[clip];
+    if (source.track_index >= track_index_.size()) {
+        track_index_.resize(source.track_index + 1);
+    }
+    if (clip >= indexed_spans_.size()) {
+        indexed_spans_.resize(clip + 1);
+        indexed_tracks_.resize(clip + 1);
+    }
+
+    IndexEntry entry{source.start_beat, source.end_beat(), clip};
+    auto& track = track_index_[source.track_index];
+    auto pos = std::upper_bound(track.entries.begin(), track.entries.end(), entry.start,
+        [](double value, const IndexEntry& e) { return value < e.start; });
+    size_t at = static_cast<size_t>(pos - track.entries.begin());
+    track.entries.insert(pos, entry);
+    track.max_end.insert(track.max_end.begin() + static_cast<ptrdiff_t>(at), 0.0);
+
+    double running = at > 0 ? track.max_end[at - 1] : -std::numeric_limits<double>::infinity();
+    for (size_t i = at; i < track.entries.size(); ++i) {
+        running = std::max(running, track.entries[i].end);
+        track.max_end[i] = running;
+    }
+
+    indexed_spans_[clip] = entry;
+    indexed_tracks_[clip] = source.track_index;
+}
+
+void TimelineData::index_remove(size_t clip) const {
+    auto& track = track_index_[indexed_tracks_[clip]];
+    auto [first, last] = std::equal_range(track.entries.begin(), track.entries.end(),
+        indexed_spans_[clip],
+        [](const IndexEntry& a, const IndexEntry& b) { return a.start < b.start; });
+    auto it = std::find_if(first, last, [clip](const IndexEntry& e) { return e.clip == clip; });
+    if (it == last) return;
+
+    size_t at = static_cast<size_t>(it - track.entries.begin());
+    track.entries.erase(it);
+    track.max_end.erase(track.max_end.begin() + static_cast<ptrdiff_t>(at));
+
+    double running = at > 0 ? track.max_end[at - 1] : -std::numeric_limits<double>::infinity();
+    for (size_t i = at; i < track.entries.size(); ++i) {
+        running = std::max(running, track.entries[i].end);
+        track.max_end[i] = running;
+    }
+}
+
+void TimelineData::reindex(size_t clip) {
+    if (!index_dirty_ && indexed_spans_.size() == clips_.size()) {
+        index_remove(clip);
+        index_insert(clip);
+    }
+    ++generation_;
+}
+
+void TimelineData::bind_handle(size_t clip) {
+    ClipHandle handle = handles_.intern(clips_[clip].id);
+    if (clip >= clip_handles_.size()) {
+        clip_handles_.resize(clip + 1);
+    }
+    clip_handles_[clip] = handle;
+    if (handles_.slot(handle) == HandleTable<ClipTag>::NO_SLOT) {
+        handles_.bind(handle, clip);
+    }
+}
+
+void TimelineData::rebind_handles() {
+    handles_.unbind_all();
+    clip_handles_.resize(clips_.size());
+    for (size_t i = 0; i < clips_.size(); ++i) {
+        bind_handle(i);
+    }
+    handles_.release_unbound();
+}
+
 void TimelineData::set_tracks(const std::vector<Track>& tracks) {
     tracks_ = tracks;
+    ++generation_;
 }
 
 void TimelineData::set_clips(const std::vector<TimelineClip>& clips) {
     clips_ = clips;
+    rebind_handles();
+    index_dirty_ = true;
+    ++generation_;
 }
 
 void TimelineData::clear() {
     clips_.clear();
+    clip_handles_.clear();
+    handles_.clear();
     tracks_.clear();
+    index_dirty_ = true;
+    ++generation_;
     add_track("Track 1");
 }
 
 void TimelineData::clear_all() {
     clips_.clear();
+    clip_handles_.clear();
+    handles_.clear();
     tracks_.clear();
+    index_dirty_ = true;
+    ++generation_;
 }
 
 std::string TimelineData::generate_id() {
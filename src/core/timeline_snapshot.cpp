@@ -0,0 +1,119 @@
+#include "furious/core/timeline_snapshot.hpp"
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+namespace furious {
+
+namespace {
+
+bool same_tracks(const std::vector<Track>& a, const std::vector<Track>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const Track& x, const Track& y) {
+        return x.name == y.name && x.visible == y.visible && x.locked == y.locked;
+    });
+}
+
+// Compares what gets serialized; the handle caches are left out.
+bool same_clip(const TimelineClip& a, const TimelineClip& b) {
+    auto same_effect = [](const ClipEffect& x, const ClipEffect& y) {
+        return x.effect_id == y.effect_id && x.enabled == y.enabled && x.parameters == y.parameters;
+    };
+    auto same_pattern = [](const ClipPatternReference& x, const ClipPatternReference& y) {
+        return x.pattern_id == y.pattern_id && x.enabled == y.enabled &&
+               x.offset_subdivisions == y.offset_subdivisions;
+    };
+
+    return a.id == b.id && a.source_id == b.source_id && a.track_index == b.track_index &&
+           a.start_beat == b.start_beat && a.duration_beats == b.duration_beats &&
+           a.source_start_seconds == b.source_start_seconds &&
+           a.position_x == b.position_x && a.position_y == b.position_y &&
+           a.scale_x == b.scale_x && a.scale_y == b.scale_y && a.rotation == b.rotation &&
+           std::equal(a.effects.begin(), a.effects.end(), b.effects.begin(), b.effects.end(), same_effect) &&
+           std::equal(a.patterns.begin(), a.patterns.end(), b.patterns.begin(), b.patterns.end(), same_pattern);
+}
+
+} // namespace
+
+std::shared_ptr<const TimelineSnapshot> TimelineSnapshot::create(
+    uint64_t generation, const std::vector<Track>& tracks,
+    const std::vector<TimelineClip>& clips, const std::vector<ClipHandle>& handles,
+    const TimelineSnapshot* previous) {
+    auto snapshot = std::make_shared<TimelineSnapshot>();
+    snapshot->generation_ = generation;
+
+    if (previous && same_tracks(*previous->tracks_, tracks)) {
+        snapshot->tracks_ = previous->tracks_;
+    } else {
+        snapshot->tracks_ = std::make_shared<const std::vector<Track>>(tracks);
+    }
+
+    std::unordered_map<std::string_view, const ClipPtr*> reusable;
+    if (previous) {
+        reusable.reserve(previous->clips_.size());
+        for (const ClipPtr& clip : previous->clips_) {
+            reusable.emplace(clip->id, &clip);
+        }
+    }
+
+    snapshot->clips_.reserve(clips.size());
+    for (const TimelineClip& clip : clips) {
+        auto it = reusable.find(clip.id);
+        if (it != reusable.end() && same_clip(**it->second, clip)) {
+            snapshot->clips_.push_back(*it->second);
+        } else {
+            snapshot->clips_.push_back(std::make_shared<const TimelineClip>(clip));
+        }
+    }
+    snapshot->handles_ = handles;
+
+    snapshot->by_track_.resize(clips.size());
+    for (size_t i = 0; i < clips.size(); ++i) {
+        snapshot->by_track_[i] = i;
+    }
+    std::stable_sort(snapshot->by_track_.begin(), snapshot->by_track_.end(),
+        [&clips](size_t a, size_t b) {
+            if (clips[a].track_index != clips[b].track_index) {
+                return clips[a].track_index < clips[b].track_index;
+            }
+            return clips[a].start_beat < clips[b].start_beat;
+        });
+
+    return snapshot;
+}
+
+const TimelineClip* TimelineSnapshot::find_clip(std::string_view clip_id) const {
+    for (const ClipPtr& clip : clips_) {
+        if (clip->id == clip_id) return clip.get();
+    }
+    return nullptr;
+}
+
+const TimelineClip* TimelineSnapshot::find_clip(ClipHandle handle) const {
+    for (size_t i = 0; i < handles_.size(); ++i) {
+        if (handles_[i] == handle) return clips_[i].get();
+    }
+    return nullptr;
+}
+
+std::vector<const TimelineClip*> TimelineSnapshot::clips_at_beat(double beat) const {
+    std::vector<const TimelineClip*> result;
+    for (size_t index : by_track_) {
+        if (clips_[index]->contains_beat(beat)) {
+            result.push_back(clips_[index].get());
+        }
+    }
+    return result;
+}
+
+std::vector<const TimelineClip*> TimelineSnapshot::clips_in_range(double start_beat, double end_beat) const {
+    std::vector<const TimelineClip*> result;
+    for (size_t index : by_track_) {
+        const TimelineClip& clip = *clips_[index];
+        if (clip.start_beat < end_beat && clip.end_beat() > start_beat) {
+            result.push_back(&clip);
+        }
+    }
+    return result;
+}
+
+} // namespace furious
@@ -0,0 +1,229 @@
+#include "furious/scripting/automation_baker.hpp"
+#include "furious/core/key_hasher.hpp"
+#include "furious/core/pattern_library.hpp"
+#include "furious/core/tempo.hpp"
+#include "furious/core/timeline_data.hpp"
+#include "furious/scripting/script_engine.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iterator>
+#include <thread>
+
+namespace furious {
+
+namespace {
+
+// Below this many samples the bake runs inline; thread startup costs more.
+constexpr size_t MIN_PARALLEL_SAMPLES = 4096;
+
+struct BakeJob {
+    const TimelineClip* clip = nullptr;
+    ClipHandle handle;
+    uint64_t key = 0;
+    std::vector<EffectResult> effects;  // per sample, empty without effects
+    BakedClipAutomation baked;
+};
+
+size_t sample_count(const TimelineClip& clip) {
+    double subdivisions = clip.duration_beats * AutomationBaker::SUBDIVISIONS_PER_BEAT;
+    return std::max<size_t>(1, static_cast<size_t>(std::ceil(subdivisions)));
+}
+
+void bake_samples(BakeJob& job, const PatternEvaluator& evaluator, const Tempo& tempo) {
+    const TimelineClip& clip = *job.clip;
+    size_t count = sample_count(clip);
+
+    job.baked.start_beat = clip.start_beat;
+    job.baked.samples.resize(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        double clip_local_beats = static_cast<double>(i) / AutomationBaker::SUBDIVISIONS_PER_BEAT;
+        PatternEvaluationResult pattern = evaluator.evaluate(clip, clip_local_beats);
+        const EffectResult* effect = job.effects.empty() ? nullptr : &job.effects[i];
+
+        auto pick = [effect](std::optional<float> EffectResult::*effect_value,
+                             const std::optional<float>& pattern_value, float base) {
+            if (effect && (effect->*effect_value).has_value()) return *(effect->*effect_value);
+            return pattern_value.value_or(base);
+        };
+
+        AutomationSample& sample = job.baked.samples[i];
+        sample.position_x = pick(&EffectResult::position_x, pattern.position_x, clip.position_x);
+        sample.position_y = pick(&EffectResult::position_y, pattern.position_y, clip.position_y);
+        sample.scale_x = pick(&EffectResult::scale_x, pattern.scale_x, clip.scale_x);
+        sample.scale_y = pick(&EffectResult::scale_y, pattern.scale_y, clip.scale_y);
+        sample.rotation = pick(&EffectResult::rotation, pattern.rotation, clip.rotation);
+        sample.flip_h = pattern.flip_h.value_or(false);
+        sample.flip_v = pattern.flip_v.value_or(false);
+        sample.restart = pattern.restart_clip;
+
+        double source_seconds;
+        if (effect && effect->use_looped_frame) {
+            source_seconds = effect->loop_start_seconds + effect->position_in_loop_seconds;
+            sample.looped = true;
+        } else if (pattern.use_looped_playback) {
+            source_seconds = clip.source_start_seconds + tempo.beats_to_time(pattern.position_in_loop_beats);
+            sample.looped = true;
+        } else {
+            source_seconds = clip.source_start_seconds + tempo.beats_to_time(clip_local_beats);
+        }
+        sample.source_seconds = static_cast<float>(source_seconds);
+    }
+}
+
+} // namespace
+
+const AutomationSample* BakedClipAutomation::sample_at(double beat) const {
+    if (samples.empty()) return nullptr;
+    double offset = (beat - start_beat) * AutomationBaker::SUBDIVISIONS_PER_BEAT;
+    if (offset < 0.0) return nullptr;
+    auto index = static_cast<size_t>(offset);
+    return index < samples.size() ? &samples[index] : nullptr;
+}
+
+void AutomationBaker::set_pattern_library(PatternLibrary* library) {
+    pattern_library_ = library;
+    pattern_evaluator_.set_pattern_library(library);
+    cache_.clear();
+}
+
+uint64_t AutomationBaker::cache_key(const TimelineClip& clip) const {
+    KeyHasher hasher;
+    hasher.add(tempo_->bpm());
+    hasher.add(clip.id);
+    hasher.add(clip.source_id);
+    hasher.add(static_cast<uint64_t>(clip.track_index));
+    hasher.add(clip.start_beat);
+    hasher.add(clip.duration_beats);
+    hasher.add(clip.source_start_seconds);
+    hasher.add(clip.position_x);
+    hasher.add(clip.position_y);
+    hasher.add(clip.scale_x);
+    hasher.add(clip.scale_y);
+    hasher.add(clip.rotation);
+
+    for (const auto& effect : clip.effects) {
+        hasher.add(effect.effect_id);
+        hasher.add(static_cast<uint64_t>(effect.enabled));
+        hasher.add(effect.parameters);
+    }
+
+    for (const auto& ref : clip.patterns) {
+        hasher.add(ref.pattern_id);
+        hasher.add(static_cast<uint64_t>(ref.enabled));
+        hasher.add(static_cast<uint64_t>(static_cast<int64_t>(ref.offset_subdivisions)));
+        hasher.add(pattern_library_ ? pattern_library_->pattern_revision(ref) : 0);
+    }
+
+    return hasher.value();
+}
+
+size_t AutomationBaker::bake_range(double start_beat, double end_beat) {
+    if (!timeline_data_ || !tempo_) return 0;
+
+    if (timeline_data_->generation() != pruned_generation_) {
+        cache_.prune([this](ClipHandle handle) { return timeline_data_->find_clip(handle) != nullptr; });
+        pruned_generation_ = timeline_data_->generation();
+    }
+
+    std::vector<BakeJob> jobs;
+    for (TimelineClip* clip : timeline_data_->clips_in_range(start_beat, end_beat)) {
+        ClipHandle handle = timeline_data_->handle_of(*clip);
+        uint64_t key = cache_key(*clip);
+        if (const Entry* entry = cache_.find(handle); entry && entry->key == key) {
+            continue;
+        }
+
+        BakeJob job;
+        job.clip = clip;
+        job.handle = handle;
+        job.key = key;
+        jobs.push_back(std::move(job));
+    }
+
+    if (jobs.empty()) return 0;
+
+    // Pattern lookups resolve and compile lazily, so warm them here before
+    // the lookups go wide. Effects go through the script engine's own pool.
+    size_t total_samples = 0;
+    std::vector<EffectJob> effect_jobs;
+    for (auto& job : jobs) {
+        const TimelineClip& clip = *job.clip;
+        size_t count = sample_count(clip);
+        total_samples += count;
+
+        if (pattern_library_) {
+            for (const auto& ref : clip.patterns) {
+                (void)pattern_library_->compiled_pattern(ref);
+            }
+        }
+
+        if (script_engine_ && !clip.effects.empty()) {
+            EffectJob effect_job;
+            effect_job.effects = &clip.effects;
+            effect_job.context.clip = &clip;
+            effect_job.context.tempo = tempo_;
+            effect_job.context.current_beats = clip.start_beat;
+            effect_job.clip_local_beats.resize(count);
+            for (size_t i = 0; i < count; ++i) {
+                effect_job.clip_local_beats[i] = static_cast<double>(i) / SUBDIVISIONS_PER_BEAT;
+            }
+            effect_jobs.push_back(std::move(effect_job));
+        }
+    }
+
+    if (!effect_jobs.empty()) {
+        std::vector<EffectResult> effect_results;
+        script_engine_->evaluate_effects_batch(effect_jobs, effect_results);
+
+        size_t next_result = 0;
+        for (auto& job : jobs) {
+            if (job.clip->effects.empty()) continue;
+            size_t count = sample_count(*job.clip);
+            auto first = effect_results.begin() + static_cast<std::ptrdiff_t>(next_result);
+            job.effects.assign(std::make_move_iterator(first),
+                               std::make_move_iterator(first + static_cast<std::ptrdiff_t>(count)));
+            next_result += count;
+        }
+    }
+
+    unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+    workers = std::min<unsigned>(workers, static_cast<unsigned>(jobs.size()));
+    if (total_samples < MIN_PARALLEL_SAMPLES) {
+        workers = 1;
+    }
+
+    std::atomic<size_t> next_job{0};
+    auto run = [&] {
+        for (size_t i = next_job.fetch_add(1); i < jobs.size(); i = next_job.fetch_add(1)) {
+            bake_samples(jobs[i], pattern_evaluator_, *tempo_);
+        }
+    };
+
+    if (workers == 1) {
+        run();
+    } else {
+        std::vector<std::thread> threads;
+        threads.reserve(workers - 1);
+        for (unsigned i = 1; i < workers; ++i) {
+            threads.emplace_back(run);
+        }
+        run();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    for (auto& job : jobs) {
+        cache_.replace(job.handle, Entry{job.key, std::move(job.baked)});
+    }
+    return jobs.size();
+}
+
+const BakedClipAutomation* AutomationBaker::find(ClipHandle clip) const {
+    const Entry* entry = cache_.find(clip);
+    return entry ? &entry->baked : nullptr;
+}
+
+} // namespace furious
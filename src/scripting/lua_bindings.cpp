@@ -32,16 +32,19 @@ void register_lua_bindings(lua_State* L) {
     };
 }
 
-void bind_project(lua_State* L, Project* project) {
+void bind_project(lua_State* L, Project* project, ProjectAccess access) {
     if (!project) return;
 
     sol::state_view lua(L);
     sol::table furious = lua["furious"];
 
-    furious["project"] = lua.create_table_with(
-        "bpm", [project]() { return project->tempo().bpm(); },
-        "set_bpm", [project](double bpm) { project->tempo().set_bpm(bpm); }
+    sol::table table = lua.create_table_with(
+        "bpm", [project]() { return project->tempo().bpm(); }
     );
+    if (access == ProjectAccess::ReadWrite) {
+        table.set_function("set_bpm", [project](double bpm) { project->tempo().set_bpm(bpm); });
+    }
+    furious["project"] = table;
 }
 
 void bind_timeline_data(lua_State* L, TimelineData* data) {
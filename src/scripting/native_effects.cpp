@@ -0,0 +1,195 @@
+#include "furious/scripting/native_effect.hpp"
+#include "furious/core/tempo.hpp"
+#include <array>
+#include <cmath>
+
+namespace furious {
+
+namespace {
+
+constexpr double PI = 3.14159265359;
+
+EffectParameter declare(std::string name, std::string type, std::string default_value,
+                        EffectParameterType kind, std::vector<std::string> values = {}) {
+    EffectParameter param;
+    param.name = std::move(name);
+    param.type = std::move(type);
+    param.default_value = std::move(default_value);
+    param.enum_values = std::move(values);
+    param.kind = kind;
+    return param;
+}
+
+// Lua's float modulo: the result takes the sign of the divisor.
+double lua_mod(double a, double b) {
+    double m = std::fmod(a, b);
+    if (m != 0.0 && (m < 0.0) != (b < 0.0)) m += b;
+    return m;
+}
+
+bool is_odd(double whole) {
+    return lua_mod(whole, 2.0) == 1.0;
+}
+
+// Indexed by 1-based enum ordinal; anything out of range uses the fallback,
+// like a nil table lookup in the scripts.
+template<size_t N>
+double lookup(const std::array<double, N>& table, int ordinal, double fallback) {
+    if (ordinal < 1 || ordinal > static_cast<int>(N)) return fallback;
+    return table[static_cast<size_t>(ordinal - 1)];
+}
+
+class AutoYtpmvEffect final : public NativeEffect {
+public:
+    AutoYtpmvEffect() {
+        info_.id = "auto_ytpmv";
+        info_.name = "Auto YTPMV";
+        info_.native = true;
+        info_.parameters = {
+            declare("Sync Period", "enum", "1/4", EffectParameterType::Enum,
+                    {"1/16", "1/8", "1/4", "1/2", "measure"}),
+            declare("Flip Horizontal", "bool", "false", EffectParameterType::Bool),
+            declare("Flip Vertical", "bool", "false", EffectParameterType::Bool),
+        };
+    }
+
+    [[nodiscard]] const EffectInfo& info() const override { return info_; }
+
+    [[nodiscard]] EffectResult evaluate(const EffectContext& context,
+                                        std::span<const EffectParameterValue> params) const override {
+        EffectResult result;
+        if (!context.clip || !context.tempo || params.size() < 3) return result;
+
+        static constexpr std::array<double, 5> PERIOD_BEATS = {0.25, 0.5, 1.0, 2.0, 4.0};
+        double period_beats = lookup(PERIOD_BEATS, params[0].ordinal, 1.0);
+        double period_seconds = context.tempo->beats_to_time(period_beats);
+
+        double position_in_period = lua_mod(context.clip_local_beats, period_beats);
+        double position_seconds = context.tempo->beats_to_time(position_in_period);
+
+        bool odd_period = is_odd(std::floor(context.clip_local_beats / period_beats));
+
+        float scale_x = context.accumulated.scale_x;
+        float scale_y = context.accumulated.scale_y;
+        if (params[1].flag && odd_period) scale_x = -scale_x;
+        if (params[2].flag && odd_period) scale_y = -scale_y;
+
+        result.use_looped_frame = true;
+        result.loop_start_seconds = context.clip->source_start_seconds;
+        result.loop_duration_seconds = period_seconds;
+        result.position_in_loop_seconds = position_seconds;
+        result.use_looped_audio = true;
+        result.audio_loop_start_seconds = context.clip->source_start_seconds;
+        result.audio_loop_duration_seconds = period_seconds;
+        result.scale_x = scale_x;
+        result.scale_y = scale_y;
+        return result;
+    }
+
+private:
+    EffectInfo info_;
+};
+
+double ease(int easing, double t) {
+    switch (easing) {
+        case 2: return 1 - std::cos((t * PI) / 2);
+        case 3: return std::sin((t * PI) / 2);
+        case 4: return -(std::cos(PI * t) - 1) / 2;
+
+        case 5: return t * t;
+        case 6: return 1 - (1 - t) * (1 - t);
+        case 7: return t < 0.5 ? 2 * t * t : 1 - std::pow(-2 * t + 2, 2) / 2;
+
+        case 8: return t * t * t;
+        case 9: return 1 - std::pow(1 - t, 3);
+        case 10: return t < 0.5 ? 4 * t * t * t : 1 - std::pow(-2 * t + 2, 3) / 2;
+
+        case 11: return t * t * t * t;
+        case 12: return 1 - std::pow(1 - t, 4);
+        case 13: return t < 0.5 ? 8 * t * t * t * t : 1 - std::pow(-2 * t + 2, 4) / 2;
+
+        case 14: return t * t * t * t * t;
+        case 15: return 1 - std::pow(1 - t, 5);
+        case 16: return t < 0.5 ? 16 * t * t * t * t * t : 1 - std::pow(-2 * t + 2, 5) / 2;
+
+        default: return t;
+    }
+}
+
+class LerpTransformEffect final : public NativeEffect {
+public:
+    LerpTransformEffect() {
+        info_.id = "lerp_transform";
+        info_.name = "Lerp Transform";
+        info_.native = true;
+        info_.parameters = {
+            declare("Duration", "enum", "1", EffectParameterType::Enum,
+                    {"1/16", "1/8", "1/4", "1/2", "1", "2", "4", "8"}),
+            declare("Easing", "enum", "linear", EffectParameterType::Enum,
+                    {"linear", "ease_in_sine", "ease_out_sine", "ease_in_out_sine",
+                     "ease_in_quad", "ease_out_quad", "ease_in_out_quad",
+                     "ease_in_cubic", "ease_out_cubic", "ease_in_out_cubic",
+                     "ease_in_quart", "ease_out_quart", "ease_in_out_quart",
+                     "ease_in_quint", "ease_out_quint", "ease_in_out_quint"}),
+            declare("Target X", "number", "@clip.position_x", EffectParameterType::Number),
+            declare("Target Y", "number", "@clip.position_y", EffectParameterType::Number),
+            declare("Target Scale X", "number", "@clip.scale_x", EffectParameterType::Number),
+            declare("Target Scale Y", "number", "@clip.scale_y", EffectParameterType::Number),
+            declare("Target Rotation", "number", "@clip.rotation", EffectParameterType::Number),
+            declare("Loop", "bool", "false", EffectParameterType::Bool),
+            declare("Ping Pong", "bool", "false", EffectParameterType::Bool),
+        };
+    }
+
+    [[nodiscard]] const EffectInfo& info() const override { return info_; }
+
+    [[nodiscard]] EffectResult evaluate(const EffectContext& context,
+                                        std::span<const EffectParameterValue> params) const override {
+        EffectResult result;
+        if (!context.clip || params.size() < 9) return result;
+        const TimelineClip& base = *context.clip;
+
+        // Matches the script's duration table, ordinal for ordinal.
+        static constexpr std::array<double, 8> DURATION_BEATS = {0.25, 0.5, 1.0, 2.0, 1.0, 2.0, 4.0, 8.0};
+        double duration_beats = lookup(DURATION_BEATS, params[0].ordinal, 1.0);
+
+        double t = context.clip_local_beats / duration_beats;
+        if (params[7].flag) {
+            double cycle = std::floor(t);
+            t -= cycle;
+            if (params[8].flag && is_odd(cycle)) {
+                t = 1 - t;
+            }
+        } else {
+            t = std::min(t, 1.0);
+        }
+        t = ease(params[1].ordinal, t);
+
+        auto lerp = [t](double from, double to) { return from + (to - from) * t; };
+        double scale_x = lerp(base.scale_x, params[4].number);
+        double scale_y = lerp(base.scale_y, params[5].number);
+        double sign_x = context.accumulated.scale_x >= 0 ? 1.0 : -1.0;
+        double sign_y = context.accumulated.scale_y >= 0 ? 1.0 : -1.0;
+
+        result.position_x = static_cast<float>(lerp(base.position_x, params[2].number));
+        result.position_y = static_cast<float>(lerp(base.position_y, params[3].number));
+        result.scale_x = static_cast<float>(std::abs(scale_x) * sign_x);
+        result.scale_y = static_cast<float>(std::abs(scale_y) * sign_y);
+        result.rotation = static_cast<float>(lerp(base.rotation, params[6].number));
+        return result;
+    }
+
+private:
+    EffectInfo info_;
+};
+
+} // namespace
+
+std::vector<std::unique_ptr<NativeEffect>> builtin_native_effects() {
+    std::vector<std::unique_ptr<NativeEffect>> effects;
+    effects.push_back(std::make_unique<AutoYtpmvEffect>());
+    effects.push_back(std::make_unique<LerpTransformEffect>());
+    return effects;
+}
+
+} // namespace furious
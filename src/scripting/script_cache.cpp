@@ -0,0 +1,84 @@
+#include "furious/scripting/script_cache.hpp"
+#include "furious/core/key_hasher.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+namespace furious {
+
+ScriptCache::ScriptCache()
+    : directory_(default_directory()) {}
+
+ScriptCache::ScriptCache(std::filesystem::path directory)
+    : directory_(std::move(directory)) {}
+
+std::filesystem::path ScriptCache::entry_path(std::string_view source) const {
+    KeyHasher hasher;
+    hasher.add(format_);
+    hasher.add(source);
+
+    std::ostringstream name;
+    name << std::hex << std::setfill('0') << std::setw(16) << hasher.value()
+         << '-' << std::setw(8) << source.size() << ".luac";
+    return directory_ / name.str();
+}
+
+std::optional<std::string> ScriptCache::load(std::string_view source) const {
+    if (!enabled_ || directory_.empty()) return std::nullopt;
+
+    std::ifstream file(entry_path(source), std::ios::binary);
+    if (!file) return std::nullopt;
+
+    std::string bytecode((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytecode.empty()) return std::nullopt;
+    return bytecode;
+}
+
+bool ScriptCache::store(std::string_view source, std::string_view bytecode) const {
+    if (!enabled_ || directory_.empty() || bytecode.empty()) return false;
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) return false;
+
+    // Written beside the entry and renamed into place, so a concurrent
+    // reader never sees a partial chunk.
+    auto path = entry_path(source);
+    auto temp = path;
+    temp += ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(bytecode.data(), static_cast<std::streamsize>(bytecode.size()));
+        if (!file) return false;
+    }
+
+    std::filesystem::rename(temp, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+std::filesystem::path ScriptCache::default_directory() {
+#ifdef _WIN32
+    if (const char* local = std::getenv("LOCALAPPDATA"); local && *local) {
+        return std::filesystem::path(local) / "furious" / "script_cache";
+    }
+#else
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+        return std::filesystem::path(xdg) / "furious" / "scripts";
+    }
+    if (const char* home = std::getenv("HOME"); home && *home) {
+        return std::filesystem::path(home) / ".cache" / "furious" / "scripts";
+    }
+#endif
+    // Bytecode is loaded unverified, so a shared location such as the temp
+    // directory is never used; without a per-user one the cache stays off.
+    return {};
+}
+
+} // namespace furious
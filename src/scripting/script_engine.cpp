@@ -1,5 +1,9 @@
 #include "furious/scripting/script_engine.hpp"
+#include "furious/scripting/native_effect.hpp"
+#include "furious/scripting/script_cache.hpp"
 #include "furious/scripting/lua_bindings.hpp"
+#include "furious/core/key_hasher.hpp"
+#include "furious/core/lru_cache.hpp"
 #include "furious/core/project.hpp"
 #include "furious/core/timeline_data.hpp"
 #include "furious/core/tempo.hpp"
@@ -7,53 +11,1211 @@
 #define SOL_ALL_SAFETIES_ON 1
 #include <sol/sol.hpp>
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <span>
+#include <iterator>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
 
 namespace furious {
 
-struct ScriptEngine::Impl {
+namespace {
+
+constexpr std::array<const char*, 13> RESULT_FIELDS = {
+    "source_position_seconds", "use_looped_frame", "loop_start_seconds",
+    "loop_duration_seconds", "position_in_loop_seconds", "use_looped_audio",
+    "audio_loop_start_seconds", "audio_loop_duration_seconds", "position_x",
+    "position_y", "scale_x", "scale_y", "rotation",
+};
+
+std::optional<EffectParameterType> parameter_type_from_string(std::string_view type) {
+    if (type == "string") return EffectParameterType::String;
+    if (type == "number") return EffectParameterType::Number;
+    if (type == "bool") return EffectParameterType::Bool;
+    if (type == "enum") return EffectParameterType::Enum;
+    return std::nullopt;
+}
+
+std::optional<PatternTargetProperty> clip_reference_from_string(std::string_view raw) {
+    if (raw == "@clip.position_x") return PatternTargetProperty::PositionX;
+    if (raw == "@clip.position_y") return PatternTargetProperty::PositionY;
+    if (raw == "@clip.scale_x") return PatternTargetProperty::ScaleX;
+    if (raw == "@clip.scale_y") return PatternTargetProperty::ScaleY;
+    if (raw == "@clip.rotation") return PatternTargetProperty::Rotation;
+    return std::nullopt;
+}
+
+float clip_reference_value(const TimelineClip& clip, PatternTargetProperty field) {
+    switch (field) {
+        case PatternTargetProperty::PositionX: return clip.position_x;
+        case PatternTargetProperty::PositionY: return clip.position_y;
+        case PatternTargetProperty::ScaleX: return clip.scale_x;
+        case PatternTargetProperty::ScaleY: return clip.scale_y;
+        case PatternTargetProperty::Rotation: return clip.rotation;
+        default: return 0.0f;
+    }
+}
+
+std::optional<double> parse_number(std::string_view raw) {
+    double value = 0.0;
+    auto [end, ec] = std::from_chars(raw.data(), raw.data() + raw.size(), value);
+    if (ec != std::errc{} || end != raw.data() + raw.size()) return std::nullopt;
+    return value;
+}
+
+std::optional<bool> parse_bool(std::string_view raw) {
+    if (raw == "true" || raw == "1") return true;
+    if (raw == "false" || raw == "0") return false;
+    return std::nullopt;
+}
+
+std::optional<int> parse_enum(const EffectParameter& param, std::string_view raw) {
+    for (size_t i = 0; i < param.enum_values.size(); ++i) {
+        if (param.enum_values[i] == raw) return static_cast<int>(i) + 1;
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+EffectParameterValue parse_effect_parameter(const EffectParameter& param, std::string_view raw) {
+    EffectParameterValue value;
+    value.type = param.kind;
+
+    switch (param.kind) {
+        case EffectParameterType::Number:
+            if (auto reference = clip_reference_from_string(raw)) {
+                value.clip_reference = reference;
+            } else if (auto number = parse_number(raw)) {
+                value.number = *number;
+            } else if (auto reference = clip_reference_from_string(param.default_value)) {
+                value.clip_reference = reference;
+            } else {
+                value.number = parse_number(param.default_value).value_or(0.0);
+            }
+            break;
+        case EffectParameterType::Bool:
+            value.flag = parse_bool(raw).value_or(parse_bool(param.default_value).value_or(false));
+            break;
+        case EffectParameterType::Enum:
+            value.ordinal = parse_enum(param, raw).value_or(parse_enum(param, param.default_value).value_or(1));
+            break;
+        case EffectParameterType::String:
+            value.text = raw;
+            break;
+    }
+    return value;
+}
+
+namespace {
+
+// Fewer jobs than this per extra Lua state are evaluated inline; the thread
+// handoff would cost more than the scripts.
+constexpr size_t MIN_JOBS_PER_WORKER = 16;
+constexpr size_t MAX_LUA_WORKERS = 8;
+
+// While playing, a full collection only runs once the heap has grown this
+// far past what the last full collection left behind.
+constexpr size_t GC_RUNAWAY_FACTOR = 4;
+
+// The budget hook fires every HOOK_INTERVAL Lua instructions.
+constexpr int HOOK_INTERVAL = 1000;
+
+// Pure-effect results kept per Lua state; a few seconds of a busy timeline.
+constexpr size_t EFFECT_MEMO_CAPACITY = 8192;
+
+// Keeps a beat that lands exactly on a frame boundary from flooring into the
+// previous frame after the round trip through seconds.
+constexpr double FRAME_EPSILON = 1e-6;
+
+// A pure effect's result at one project frame. state hashes everything else
+// the script is handed: effect id, parameters, tempo, the clip's fields and
+// placement on the timeline, and both transforms, plus the project fps that
+// frame is counted in.
+struct EffectMemoKey {
+    ClipHandle clip;
+    int64_t frame = 0;
+    uint64_t state = 0;
+
+    bool operator==(const EffectMemoKey&) const = default;
+};
+
+struct EffectMemoKeyHash {
+    size_t operator()(const EffectMemoKey& key) const {
+        KeyHasher hasher;
+        hasher.add((static_cast<uint64_t>(key.clip.generation) << 32) | key.clip.index);
+        hasher.add(static_cast<uint64_t>(key.frame));
+        hasher.add(key.state);
+        return static_cast<size_t>(hasher.value());
+    }
+};
+
+// Lua tables handed to one effect instance. They are created on first use
+// and rewritten in place afterwards, so a steady-state evaluation only
+// stores numbers into existing slots and never grows the Lua heap.
+struct EffectSlot {
+    sol::table context;
+    sol::table clip;
+    sol::table base;
+    sol::table params;
+    sol::table result;
+
+    std::string clip_id;
+    std::string source_id;
+    std::string effect_id;
+    std::unordered_map<std::string, std::string> parameters;
+    std::vector<std::pair<std::string, PatternTargetProperty>> clip_references;
+
+    // Handed back when a call is aborted for running over budget.
+    std::optional<EffectResult> last_good;
+};
+
+// Each effect script runs in its own environment so the globals it defines
+// (effect, evaluate, helpers) cannot collide with another script's.
+struct LoadedEffect {
+    sol::environment environment;
+    sol::protected_function evaluate;
+    sol::protected_function evaluate_batch;  // optional
+};
+
+// One independent Lua state with every effect loaded into it. A clip is
+// always evaluated in the worker its handle maps to, so its slots, last good
+// results and memo entries live in one place. Spare workers own a thread
+// that only touches them during a batch; at any other time the calling
+// thread may use any worker, so nothing in here needs locking.
+class LuaWorker {
+public:
     sol::state lua;
+    std::unordered_map<std::string, LoadedEffect> loaded;
+    HandleMap<ClipTag, std::vector<EffectSlot>> effect_slots;
+    uint64_t slots_generation = 0;  // timeline generation effect_slots was last pruned at
+    std::vector<EffectParameterValue> native_params;
+    EffectSlot scratch_slot;
+    sol::table tempo_table;
+    sol::table span_beats;
+    sol::table span_results;
+    size_t span_capacity = 0;
+    size_t span_size = 0;
+    const Tempo* current_tempo = nullptr;
+    TimelineData* timeline_data = nullptr;
+    std::string last_error;
+    std::unordered_map<std::string, EffectTiming> timings;
+    LruCache<EffectMemoKey, EffectResult, EffectMemoKeyHash> memo{EFFECT_MEMO_CAPACITY};
+    bool call_succeeded = false;  // the last run() returned the script's own result
+
+    uint32_t instruction_budget = ScriptEngine::DEFAULT_INSTRUCTION_BUDGET;
+    uint32_t hook_ticks_left = 0;  // 0 while no budget is armed
+    bool budget_exceeded = false;
+
+    bool open(Project* project, TimelineData* data) {
+        try {
+            lua.open_libraries(
+                sol::lib::base,
+                sol::lib::math,
+                sol::lib::string,
+                sol::lib::table
+            );
+            register_lua_bindings(lua.lua_state());
+            bind(project, data);
+
+            // Collection is driven from collect_garbage() between frames
+            // rather than whenever an allocation crosses the threshold.
+            lua_gc(lua.lua_state(), LUA_GCGEN, 0, 0);
+            lua_gc(lua.lua_state(), LUA_GCSTOP);
+
+            *static_cast<LuaWorker**>(lua_getextraspace(lua.lua_state())) = this;
+            lua_sethook(lua.lua_state(), &LuaWorker::budget_hook, LUA_MASKCOUNT, HOOK_INTERVAL);
+            return true;
+        } catch (const std::exception& e) {
+            last_error = e.what();
+            return false;
+        }
+    }
+
+    void bind(Project* project, TimelineData* data) {
+        if (data != timeline_data) {
+            effect_slots.clear();
+            memo.clear();
+        }
+        timeline_data = data;
+        // Workers run side by side, so effects only get to read the project.
+        bind_project(lua.lua_state(), project, ProjectAccess::ReadOnly);
+        bind_timeline_data(lua.lua_state(), data);
+    }
+
+    void release_slots() {
+        effect_slots.clear();
+        memo.clear();
+        scratch_slot = EffectSlot{};
+        tempo_table = sol::table{};
+        span_beats = sol::table{};
+        span_results = sol::table{};
+        span_capacity = 0;
+        span_size = 0;
+    }
+
+    void unload_all() {
+        release_slots();
+        loaded.clear();
+    }
+
+    // Raises a Lua error once the armed budget runs out, which unwinds the
+    // script back to the protected call that started it.
+    static void budget_hook(lua_State* L, lua_Debug*) {
+        LuaWorker* worker = *static_cast<LuaWorker**>(lua_getextraspace(L));
+        if (worker->hook_ticks_left > 0 && --worker->hook_ticks_left == 0) {
+            worker->budget_exceeded = true;
+            luaL_error(L, "instruction budget of %d exceeded", static_cast<int>(worker->instruction_budget));
+        }
+    }
+
+    // A batched call gets the budget of the single calls it replaces.
+    void arm_budget(size_t calls = 1) {
+        uint64_t ticks = static_cast<uint64_t>(instruction_budget) * calls / HOOK_INTERVAL;
+        ticks = std::clamp<uint64_t>(ticks, 1, UINT32_MAX);
+        hook_ticks_left = instruction_budget == 0 ? 0 : static_cast<uint32_t>(ticks);
+        budget_exceeded = false;
+    }
+
+    void disarm_budget() { hook_ticks_left = 0; }
+
+    size_t heap_bytes() {
+        lua_State* L = lua.lua_state();
+        return static_cast<size_t>(lua_gc(L, LUA_GCCOUNT)) * 1024 + static_cast<size_t>(lua_gc(L, LUA_GCCOUNTB));
+    }
+
+    void unload(const std::string& effect_id) {
+        release_slots();
+        loaded.erase(effect_id);
+    }
+
+    // Runs a compiled chunk in a fresh environment and returns its 'effect'
+    // table, registering its evaluate function under the declared id.
+    sol::optional<sol::table> load(const std::string& path, std::string_view bytecode) {
+        try {
+            sol::environment environment(lua, sol::create, lua.globals());
+            arm_budget();
+            sol::protected_function_result result = lua.safe_script(
+                bytecode, environment, &sol::script_pass_on_error, "@" + path, sol::load_mode::binary);
+            disarm_budget();
+            if (!result.valid()) {
+                sol::error err = result;
+                last_error = err.what();
+                return sol::nullopt;
+            }
+
+            sol::optional<sol::table> effect_table = environment.raw_get<sol::optional<sol::table>>("effect");
+            if (!effect_table) {
+                last_error = "Script missing 'effect' table: " + path;
+                return sol::nullopt;
+            }
+
+            std::string id = (*effect_table)["id"].get_or<std::string>("");
+            if (id.empty()) {
+                last_error = "Effect missing 'id' field: " + path;
+                return sol::nullopt;
+            }
+
+            LoadedEffect effect;
+            effect.evaluate = environment.raw_get<sol::protected_function>("evaluate");
+            if (auto batch = environment.raw_get<sol::optional<sol::protected_function>>("evaluate_batch")) {
+                effect.evaluate_batch = *batch;
+            }
+            effect.environment = environment;
+            loaded[id] = std::move(effect);
+            return effect_table;
+        } catch (const std::exception& e) {
+            disarm_budget();
+            last_error = std::string("Failed to load effect: ") + e.what();
+            return sol::nullopt;
+        }
+    }
+
+    // Slots are keyed by the clip's handle and the effect's position in the
+    // clip's chain. Effects that are not part of a timeline clip share the
+    // scratch slot.
+    EffectSlot& slot_for(const ClipEffect& effect, const TimelineClip* clip) {
+        if (!clip || !timeline_data) return scratch_slot;
+
+        const auto& chain = clip->effects;
+        size_t index = 0;
+        while (index < chain.size() && &chain[index] != &effect) {
+            ++index;
+        }
+        if (index == chain.size()) return scratch_slot;
+
+        ClipHandle handle = timeline_data->handle_of(*clip);
+        if (!handle.is_valid()) return scratch_slot;
+
+        // Slots of removed clips hold Lua tables; drop them once the
+        // timeline has moved on.
+        if (timeline_data->generation() != slots_generation) {
+            effect_slots.prune([this](ClipHandle live) { return timeline_data->find_clip(live) != nullptr; });
+            slots_generation = timeline_data->generation();
+        }
+
+        auto& slots = effect_slots[handle];
+        if (slots.size() < chain.size()) {
+            slots.resize(chain.size());
+        }
+        return slots[index];
+    }
+
+    sol::table& tempo_for(const Tempo& tempo) {
+        current_tempo = &tempo;
+        if (!tempo_table.valid()) {
+            tempo_table = lua.create_table();
+            tempo_table.set_function("beats_to_time", [this](double beats) {
+                return current_tempo ? current_tempo->beats_to_time(beats) : 0.0;
+            });
+            tempo_table.set_function("time_to_beats", [this](double seconds) {
+                return current_tempo ? current_tempo->time_to_beats(seconds) : 0.0;
+            });
+        }
+        tempo_table["bpm"] = tempo.bpm();
+        tempo_table["beat_duration_seconds"] = tempo.beat_duration_seconds();
+        return tempo_table;
+    }
+
+    // Only runs when the effect's stored strings change; evaluation then
+    // reads the typed values straight from the table.
+    void rebuild_params(EffectSlot& slot, const EffectInfo& info, const ClipEffect& effect) {
+        if (slot.effect_id != effect.effect_id) {
+            slot.last_good.reset();
+        }
+        slot.params = lua.create_table();
+        slot.clip_references.clear();
+
+        for (const auto& param : info.parameters) {
+            auto it = effect.parameters.find(param.name);
+            std::string_view raw = it != effect.parameters.end() ? it->second : param.default_value;
+            EffectParameterValue value = parse_effect_parameter(param, raw);
+
+            if (value.clip_reference) {
+                slot.clip_references.emplace_back(param.name, *value.clip_reference);
+                slot.params[param.name] = 0.0;
+                continue;
+            }
+            switch (value.type) {
+                case EffectParameterType::Number: slot.params[param.name] = value.number; break;
+                case EffectParameterType::Bool: slot.params[param.name] = value.flag; break;
+                case EffectParameterType::Enum: slot.params[param.name] = value.ordinal; break;
+                case EffectParameterType::String: slot.params[param.name] = value.text; break;
+            }
+        }
+
+        // Values the script does not declare are passed through untouched.
+        for (const auto& [key, raw] : effect.parameters) {
+            bool declared = std::any_of(info.parameters.begin(), info.parameters.end(),
+                [&key](const EffectParameter& param) { return param.name == key; });
+            if (!declared) {
+                slot.params[key] = raw;
+            }
+        }
+
+        slot.effect_id = effect.effect_id;
+        slot.parameters = effect.parameters;
+    }
+
+    void prepare_slot(EffectSlot& slot, const EffectInfo& info, const ClipEffect& effect,
+                      const EffectContext& context) {
+        if (!slot.context.valid()) {
+            slot.context = lua.create_table();
+            slot.clip = lua.create_table();
+            slot.base = lua.create_table();
+            slot.result = lua.create_table();
+            slot.context["result"] = slot.result;
+        }
+
+        slot.context["current_beats"] = context.current_beats;
+        slot.context["clip_local_beats"] = context.clip_local_beats;
+
+        if (const TimelineClip* clip = context.clip) {
+            // clip table contains accumulated values from previous effects
+            if (slot.clip_id != clip->id) {
+                slot.clip_id = clip->id;
+                slot.clip["id"] = clip->id;
+            }
+            if (slot.source_id != clip->source_id) {
+                slot.source_id = clip->source_id;
+                slot.clip["source_id"] = clip->source_id;
+            }
+            slot.clip["track_index"] = clip->track_index;
+            slot.clip["start_beat"] = clip->start_beat;
+            slot.clip["duration_beats"] = clip->duration_beats;
+            slot.clip["source_start_seconds"] = clip->source_start_seconds;
+            slot.clip["position_x"] = context.accumulated.position_x;
+            slot.clip["position_y"] = context.accumulated.position_y;
+            slot.clip["scale_x"] = context.accumulated.scale_x;
+            slot.clip["scale_y"] = context.accumulated.scale_y;
+            slot.clip["rotation"] = context.accumulated.rotation;
+            slot.context["clip"] = slot.clip;
+
+            // base table contains the clip's original transform values
+            slot.base["position_x"] = clip->position_x;
+            slot.base["position_y"] = clip->position_y;
+            slot.base["scale_x"] = clip->scale_x;
+            slot.base["scale_y"] = clip->scale_y;
+            slot.base["rotation"] = clip->rotation;
+            slot.context["base"] = slot.base;
+        } else {
+            slot.context["clip"] = sol::lua_nil;
+            slot.context["base"] = sol::lua_nil;
+        }
+
+        if (context.tempo) {
+            slot.context["tempo"] = tempo_for(*context.tempo);
+        } else {
+            slot.context["tempo"] = sol::lua_nil;
+        }
+
+        if (!slot.params.valid() || slot.effect_id != effect.effect_id ||
+            slot.parameters != effect.parameters) {
+            rebuild_params(slot, info, effect);
+        }
+        for (const auto& [name, field] : slot.clip_references) {
+            slot.params[name] = context.clip ? clip_reference_value(*context.clip, field) : 0.0f;
+        }
+
+        for (const char* field : RESULT_FIELDS) {
+            slot.result[field] = sol::lua_nil;
+        }
+    }
+
+    static EffectResult read_result(const sol::table& result_table) {
+        EffectResult result;
+        result.source_position_seconds = result_table["source_position_seconds"].get_or(0.0);
+        result.use_looped_frame = result_table["use_looped_frame"].get_or(false);
+        result.loop_start_seconds = result_table["loop_start_seconds"].get_or(0.0);
+        result.loop_duration_seconds = result_table["loop_duration_seconds"].get_or(0.0);
+        result.position_in_loop_seconds = result_table["position_in_loop_seconds"].get_or(0.0);
+
+        result.use_looped_audio = result_table["use_looped_audio"].get_or(false);
+        result.audio_loop_start_seconds = result_table["audio_loop_start_seconds"].get_or(0.0);
+        result.audio_loop_duration_seconds = result_table["audio_loop_duration_seconds"].get_or(0.0);
+
+        if (result_table["position_x"].valid()) {
+            result.position_x = result_table["position_x"].get<float>();
+        }
+        if (result_table["position_y"].valid()) {
+            result.position_y = result_table["position_y"].get<float>();
+        }
+        if (result_table["scale_x"].valid()) {
+            result.scale_x = result_table["scale_x"].get<float>();
+        }
+        if (result_table["scale_y"].valid()) {
+            result.scale_y = result_table["scale_y"].get<float>();
+        }
+        if (result_table["rotation"].valid()) {
+            result.rotation = result_table["rotation"].get<float>();
+        }
+        return result;
+    }
+
+    // Loads the beats into the shared span table and hands out one cleared
+    // result table per beat. Both tables only ever grow.
+    void prepare_span(std::span<const double> beats) {
+        if (!span_beats.valid()) {
+            span_beats = lua.create_table();
+            span_results = lua.create_table();
+        }
+        for (size_t i = 0; i < beats.size(); ++i) {
+            span_beats[i + 1] = beats[i];
+        }
+        for (size_t i = beats.size(); i < span_size; ++i) {
+            span_beats[i + 1] = sol::lua_nil;
+        }
+        span_size = beats.size();
+
+        while (span_capacity < beats.size()) {
+            span_results[++span_capacity] = lua.create_table();
+        }
+        for (size_t i = 0; i < beats.size(); ++i) {
+            sol::table result = span_results[i + 1];
+            for (const char* field : RESULT_FIELDS) {
+                result[field] = sol::lua_nil;
+            }
+        }
+    }
+
+    // Evaluates the effect at every beat with a single call into its
+    // evaluate_batch. Returns false when the script does not define one.
+    bool evaluate_span(const EffectInfo& info, const ClipEffect& effect, const EffectContext& context,
+                       std::span<const double> beats, std::span<EffectResult> out) {
+        auto loaded_it = loaded.find(effect.effect_id);
+        if (loaded_it == loaded.end() || !loaded_it->second.evaluate_batch.valid()) {
+            return false;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        run_span(info, effect, context, loaded_it->second.evaluate_batch, beats, out);
+
+        EffectTiming& timing = timings[effect.effect_id];
+        timing.total_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        timing.calls += static_cast<uint32_t>(beats.size());
+        return true;
+    }
+
+    void run_span(const EffectInfo& info, const ClipEffect& effect, const EffectContext& context,
+                  sol::protected_function& evaluate_batch, std::span<const double> beats,
+                  std::span<EffectResult> out) {
+        std::fill(out.begin(), out.end(), EffectResult{});
+
+        try {
+            EffectSlot& slot = slot_for(effect, context.clip);
+            prepare_slot(slot, info, effect, context);
+            prepare_span(beats);
+            slot.context["results"] = span_results;
+
+            arm_budget(beats.size());
+            sol::protected_function_result eval_result = evaluate_batch(slot.context, slot.params, span_beats);
+            disarm_budget();
+            if (!eval_result.valid()) {
+                sol::error err = eval_result;
+                last_error = err.what();
+                if (budget_exceeded) {
+                    ++timings[effect.effect_id].aborted;
+                    std::fill(out.begin(), out.end(), slot.last_good.value_or(EffectResult{}));
+                }
+                return;
+            }
+
+            for (size_t i = 0; i < beats.size(); ++i) {
+                sol::table result_table = span_results[i + 1];
+                out[i] = read_result(result_table);
+            }
+            if (!out.empty()) {
+                slot.last_good = out.back();
+            }
+        } catch (const std::exception& e) {
+            disarm_budget();
+            last_error = e.what();
+        }
+    }
+
+    EffectResult evaluate(const EffectInfo& info, const ClipEffect& effect, const EffectContext& context) {
+        auto start = std::chrono::steady_clock::now();
+        EffectResult result = run(info, effect, context);
+
+        EffectTiming& timing = timings[effect.effect_id];
+        timing.total_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        ++timing.calls;
+        return result;
+    }
+
+    EffectResult run(const EffectInfo& info, const ClipEffect& effect, const EffectContext& context) {
+        EffectResult result;
+        call_succeeded = false;
+
+        try {
+            auto loaded_it = loaded.find(effect.effect_id);
+            if (loaded_it == loaded.end() || !loaded_it->second.evaluate.valid()) {
+                last_error = "Effect missing 'evaluate' function: " + effect.effect_id;
+                return result;
+            }
+            sol::protected_function& evaluate = loaded_it->second.evaluate;
+
+            EffectSlot& slot = slot_for(effect, context.clip);
+            prepare_slot(slot, info, effect, context);
+
+            arm_budget();
+            sol::protected_function_result eval_result = evaluate(slot.context, slot.params);
+            disarm_budget();
+            if (!eval_result.valid()) {
+                sol::error err = eval_result;
+                last_error = err.what();
+                if (budget_exceeded) {
+                    ++timings[effect.effect_id].aborted;
+                    return slot.last_good.value_or(result);
+                }
+                return result;
+            }
+
+            sol::table result_table = eval_result;
+            if (result_table.valid()) {
+                result = read_result(result_table);
+            }
+
+            slot.last_good = result;
+            call_succeeded = true;
+            return result;
+        } catch (const std::exception& e) {
+            disarm_budget();
+            last_error = e.what();
+            return result;
+        }
+    }
+};
+
+// Tells the engine when something in the effect directories may have
+// changed. Linux uses inotify; elsewhere, or when inotify is unavailable,
+// it reports a possible change once per POLL_INTERVAL.
+class DirectoryWatcher {
+public:
+    static constexpr std::chrono::seconds POLL_INTERVAL{1};
+
+    DirectoryWatcher() = default;
+    ~DirectoryWatcher() { close(); }
+
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+    void watch(const std::vector<std::string>& directories) {
+        close();
+#ifdef __linux__
+        fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd_ < 0) return;
+        for (const auto& dir : directories) {
+            (void)inotify_add_watch(fd_, dir.c_str(),
+                IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE);
+        }
+#else
+        (void)directories;
+#endif
+        last_poll_ = std::chrono::steady_clock::now();
+    }
+
+    bool changed() {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            bool any = false;
+            alignas(inotify_event) char buffer[4096];
+            while (::read(fd_, buffer, sizeof(buffer)) > 0) {
+                any = true;
+            }
+            return any;
+        }
+#endif
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_poll_ < POLL_INTERVAL) return false;
+        last_poll_ = now;
+        return true;
+    }
+
+    void close() {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+#endif
+    }
+
+private:
+#ifdef __linux__
+    int fd_ = -1;
+#endif
+    std::chrono::steady_clock::time_point last_poll_ = std::chrono::steady_clock::now();
+};
+
+// What the engine remembers about a loaded script file: enough to spot an
+// edit without reading it, and the compiled chunk spare workers load from.
+struct ScriptFile {
+    std::filesystem::file_time_type write_time;
+    uintmax_t size = 0;
+    std::string effect_id;
+    std::string bytecode;
+    bool cached = false;
+};
+
+AccumulatedTransform base_transform(const EffectContext& context) {
+    AccumulatedTransform transform = context.accumulated;
+    if (context.clip) {
+        transform.position_x = context.clip->position_x;
+        transform.position_y = context.clip->position_y;
+        transform.scale_x = context.clip->scale_x;
+        transform.scale_y = context.clip->scale_y;
+        transform.rotation = context.clip->rotation;
+    }
+    return transform;
+}
+
+// Folds one effect's output into the chain's result. Later effects win,
+// and see the transform so far as their clip values.
+void merge_effect_result(EffectResult& combined, AccumulatedTransform& accumulated,
+                         const EffectResult& effect_result) {
+    if (effect_result.use_looped_frame) {
+        combined.use_looped_frame = true;
+        combined.loop_start_seconds = effect_result.loop_start_seconds;
+        combined.loop_duration_seconds = effect_result.loop_duration_seconds;
+        combined.position_in_loop_seconds = effect_result.position_in_loop_seconds;
+    }
+
+    if (effect_result.use_looped_audio) {
+        combined.use_looped_audio = true;
+        combined.audio_loop_start_seconds = effect_result.audio_loop_start_seconds;
+        combined.audio_loop_duration_seconds = effect_result.audio_loop_duration_seconds;
+    }
+
+    if (effect_result.position_x) {
+        accumulated.position_x = *effect_result.position_x;
+        combined.position_x = effect_result.position_x;
+    }
+    if (effect_result.position_y) {
+        accumulated.position_y = *effect_result.position_y;
+        combined.position_y = effect_result.position_y;
+    }
+    if (effect_result.scale_x) {
+        accumulated.scale_x = *effect_result.scale_x;
+        combined.scale_x = effect_result.scale_x;
+    }
+    if (effect_result.scale_y) {
+        accumulated.scale_y = *effect_result.scale_y;
+        combined.scale_y = effect_result.scale_y;
+    }
+    if (effect_result.rotation) {
+        accumulated.rotation = *effect_result.rotation;
+        combined.rotation = effect_result.rotation;
+    }
+}
+
+} // namespace
+
+struct ScriptEngine::Impl {
+    std::vector<std::unique_ptr<LuaWorker>> workers;
     std::vector<EffectInfo> effects;
     std::vector<std::string> effect_directories;
-    std::unordered_map<std::string, sol::protected_function> cached_evaluate_functions;
+    std::unordered_map<std::string, ScriptFile> scripts;
+    std::vector<std::unique_ptr<NativeEffect>> native_effects;
+    ScriptCache script_cache;
+    DirectoryWatcher watcher;
     Project* project = nullptr;
     TimelineData* timeline_data = nullptr;
     std::string last_error;
     bool initialized = false;
+    size_t gc_cursor = 0;
+    size_t gc_baseline_bytes = 0;
+    uint32_t instruction_budget = DEFAULT_INSTRUCTION_BUDGET;
+
+    // threads[i] serves workers[i + 1] and sleeps between batches.
+    std::vector<std::thread> threads;
+    std::mutex batch_mutex;
+    std::condition_variable batch_ready;
+    std::condition_variable batch_done;
+    std::function<void(size_t)> batch_task;  // runs one worker's share
+    uint64_t batch_serial = 0;
+    size_t batch_pending = 0;
+    bool stopping = false;
+    std::vector<std::vector<size_t>> assigned_jobs;  // per worker, reused across batches
+
+    Impl() : native_effects(builtin_native_effects()) {
+        workers.push_back(std::make_unique<LuaWorker>());
+        script_cache.set_format(LUA_RELEASE);
+        reset_effects();
+    }
+
+    ~Impl() {
+        stop_threads();
+    }
+
+    // Native effects stay registered across rescans and come first.
+    void reset_effects() {
+        effects.clear();
+        for (const auto& native : native_effects) {
+            effects.push_back(native->info());
+        }
+    }
+
+    const NativeEffect* find_native(std::string_view effect_id) const {
+        for (const auto& native : native_effects) {
+            if (native->info().id == effect_id) {
+                return native.get();
+            }
+        }
+        return nullptr;
+    }
+
+    EffectResult evaluate_native(LuaWorker& worker, const NativeEffect& native, const ClipEffect& effect,
+                                 const EffectContext& context) {
+        auto start = std::chrono::steady_clock::now();
+
+        auto& params = worker.native_params;
+        params.clear();
+        for (const auto& param : native.info().parameters) {
+            auto it = effect.parameters.find(param.name);
+            std::string_view raw = it != effect.parameters.end() ? it->second : param.default_value;
+            EffectParameterValue& value = params.emplace_back(parse_effect_parameter(param, raw));
+            if (value.clip_reference) {
+                value.number = context.clip ? clip_reference_value(*context.clip, *value.clip_reference) : 0.0;
+            }
+        }
+        EffectResult result = native.evaluate(context, params);
+
+        EffectTiming& timing = worker.timings[effect.effect_id];
+        timing.total_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        ++timing.calls;
+        return result;
+    }
+
+    EffectResult evaluate_one(LuaWorker& worker, const EffectInfo& info, const ClipEffect& effect,
+                              const EffectContext& context) {
+        if (info.native) {
+            if (const NativeEffect* native = find_native(info.id)) {
+                return evaluate_native(worker, *native, effect, context);
+            }
+        }
+        if (info.pure) {
+            return evaluate_pure(worker, info, effect, context);
+        }
+        return worker.evaluate(info, effect, context);
+    }
+
+    static uint64_t memo_state(const ClipEffect& effect, const EffectContext& context, double fps) {
+        KeyHasher hasher;
+        hasher.add(effect.effect_id);
+        hasher.add(context.tempo->bpm());
+        hasher.add(fps);  // the frame index means a different beat at another rate
+        hasher.add(effect.parameters);
+
+        const TimelineClip& clip = *context.clip;
+        hasher.add(clip.id);
+        hasher.add(clip.source_id);
+        hasher.add(static_cast<uint64_t>(clip.track_index));
+        hasher.add(clip.start_beat);
+        hasher.add(clip.duration_beats);
+        hasher.add(clip.source_start_seconds);
+        // Where current_beats sits relative to the clip; the frame covers the rest.
+        hasher.add(context.current_beats - context.clip_local_beats);
+        for (const AccumulatedTransform& transform : {base_transform(context), context.accumulated}) {
+            hasher.add(transform.position_x);
+            hasher.add(transform.position_y);
+            hasher.add(transform.scale_x);
+            hasher.add(transform.scale_y);
+            hasher.add(transform.rotation);
+        }
+        return hasher.value();
+    }
+
+    // Evaluates at the start of the project frame the beat falls in, so every
+    // beat in that frame shares one result. Aborted or failed calls are not
+    // cached and get retried on the next evaluation.
+    EffectResult evaluate_pure(LuaWorker& worker, const EffectInfo& info, const ClipEffect& effect,
+                               const EffectContext& context) {
+        double fps = project ? project->fps() : 0.0;
+        ClipHandle clip;
+        if (context.clip && worker.timeline_data) {
+            clip = worker.timeline_data->handle_of(*context.clip);
+        }
+        if (fps <= 0.0 || !context.tempo || !clip.is_valid()) {
+            return worker.evaluate(info, effect, context);
+        }
+
+        const Tempo& tempo = *context.tempo;
+        double frame_start = std::floor(tempo.beats_to_time(context.clip_local_beats) * fps + FRAME_EPSILON);
+        EffectMemoKey key{clip, static_cast<int64_t>(frame_start), memo_state(effect, context, fps)};
+        if (const EffectResult* cached = worker.memo.find(key)) {
+            ++worker.timings[effect.effect_id].memo_hits;
+            return *cached;
+        }
+
+        EffectContext snapped = context;
+        snapped.clip_local_beats = tempo.time_to_beats(frame_start / fps);
+        snapped.current_beats = context.current_beats - context.clip_local_beats + snapped.clip_local_beats;
+        EffectResult result = worker.evaluate(info, effect, snapped);
+        if (worker.call_succeeded) {
+            worker.memo.insert(key, result);
+        }
+        return result;
+    }
+
+    LuaWorker& main_worker() { return *workers.front(); }
+
+    // Clips spread over the workers by handle index; anything without a
+    // handle goes to fallback's worker.
+    size_t worker_index(const EffectContext& context, size_t fallback) const {
+        if (workers.size() == 1) return 0;
+        ClipHandle handle;
+        if (context.clip && timeline_data) {
+            handle = timeline_data->handle_of(*context.clip);
+        }
+        size_t key = handle.is_valid() ? handle.index : fallback;
+        return key % workers.size();
+    }
+
+    LuaWorker& worker_for(const EffectContext& context) {
+        return *workers[worker_index(context, 0)];
+    }
+
+    // seen is the batch serial at creation, so a thread added after earlier
+    // batches waits for the next one.
+    void serve(size_t worker, uint64_t seen) {
+        std::unique_lock lock(batch_mutex);
+        for (;;) {
+            batch_ready.wait(lock, [&] { return stopping || batch_serial != seen; });
+            if (stopping) return;
+            seen = batch_serial;
+            lock.unlock();
+            batch_task(worker);
+            lock.lock();
+            if (--batch_pending == 0) {
+                batch_done.notify_one();
+            }
+        }
+    }
+
+    // Runs task(i) for every worker i, worker 0 on the calling thread.
+    void run_on_workers(std::function<void(size_t)> task) {
+        {
+            std::lock_guard lock(batch_mutex);
+            batch_task = std::move(task);
+            batch_pending = threads.size();
+            ++batch_serial;
+        }
+        batch_ready.notify_all();
+        batch_task(0);
+
+        std::unique_lock lock(batch_mutex);
+        batch_done.wait(lock, [&] { return batch_pending == 0; });
+        batch_task = nullptr;
+    }
+
+    void stop_threads() {
+        {
+            std::lock_guard lock(batch_mutex);
+            stopping = true;
+        }
+        batch_ready.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        threads.clear();
+        stopping = false;
+    }
+
+    // Workers pick the pointers up in open(); only live states need rebinding.
+    void bind_workers() {
+        if (!initialized) return;
+        for (auto& worker : workers) {
+            worker->bind(project, timeline_data);
+        }
+    }
+
+    const EffectInfo* find_effect(std::string_view effect_id) const {
+        for (const auto& effect : effects) {
+            if (effect.id == effect_id) {
+                return &effect;
+            }
+        }
+        return nullptr;
+    }
+
+    // Spare states are created on first demand and carry the same scripts
+    // as the main one. The pool only grows, so clips move between workers
+    // at most once per size change.
+    void ensure_workers(size_t count) {
+        count = std::min(count, MAX_LUA_WORKERS);
+        while (workers.size() < count) {
+            auto worker = std::make_unique<LuaWorker>();
+            worker->instruction_budget = instruction_budget;
+            if (!worker->open(project, timeline_data)) {
+                last_error = worker->last_error;
+                return;
+            }
+            for (const auto& [path, file] : scripts) {
+                if (!file.effect_id.empty()) {
+                    (void)worker->load(path, file.bytecode);
+                }
+            }
+            workers.push_back(std::move(worker));
+            threads.emplace_back(&Impl::serve, this, workers.size() - 1, batch_serial);
+        }
+    }
+
+    EffectResult evaluate_chain(LuaWorker& worker, const std::vector<ClipEffect>& chain,
+                                const EffectContext& context) {
+        EffectResult combined;
+
+        EffectContext running_context = context;
+        running_context.accumulated = base_transform(context);
+
+        for (const auto& effect : chain) {
+            if (!effect.enabled) {
+                continue;
+            }
+
+            const EffectInfo* info = find_effect(effect.effect_id);
+            if (!info) {
+                worker.last_error = "Effect not found: " + effect.effect_id;
+                continue;
+            }
+
+            EffectResult effect_result = evaluate_one(worker, *info, effect, running_context);
+            merge_effect_result(combined, running_context.accumulated, effect_result);
+        }
+
+        return combined;
+    }
+
+    // Same as evaluate_chain at every beat in the span. An effect with an
+    // evaluate_batch is called once for the whole span as long as nothing
+    // before it in the chain has moved the clip, since the batch call sees
+    // a single accumulated transform; otherwise it runs beat by beat.
+    void evaluate_chain_span(LuaWorker& worker, const std::vector<ClipEffect>& chain,
+                             const EffectContext& context, std::span<const double> beats,
+                             std::span<EffectResult> combined) {
+        std::fill(combined.begin(), combined.end(), EffectResult{});
+        if (beats.empty()) return;
+
+        std::vector<AccumulatedTransform> accumulated(beats.size(), base_transform(context));
+        std::vector<EffectResult> effect_results(beats.size());
+        bool transformed = false;
+
+        EffectContext span_context = context;
+        span_context.accumulated = accumulated.front();
+        span_context.clip_local_beats = beats.front();
+        span_context.current_beats = context.current_beats - context.clip_local_beats + beats.front();
+
+        for (const auto& effect : chain) {
+            if (!effect.enabled) {
+                continue;
+            }
+
+            const EffectInfo* info = find_effect(effect.effect_id);
+            if (!info) {
+                worker.last_error = "Effect not found: " + effect.effect_id;
+                continue;
+            }
+
+            if (transformed || !worker.evaluate_span(*info, effect, span_context, beats, effect_results)) {
+                EffectContext sample = context;
+                for (size_t i = 0; i < beats.size(); ++i) {
+                    sample.clip_local_beats = beats[i];
+                    sample.current_beats = context.current_beats - context.clip_local_beats + beats[i];
+                    sample.accumulated = accumulated[i];
+                    effect_results[i] = evaluate_one(worker, *info, effect, sample);
+                }
+            }
+
+            for (size_t i = 0; i < beats.size(); ++i) {
+                const EffectResult& result = effect_results[i];
+                transformed = transformed || result.position_x || result.position_y ||
+                              result.scale_x || result.scale_y || result.rotation;
+                merge_effect_result(combined[i], accumulated[i], result);
+            }
+        }
+    }
+
+    size_t heap_bytes() {
+        size_t total = 0;
+        for (auto& worker : workers) {
+            total += worker->heap_bytes();
+        }
+        return total;
+    }
+
+    void full_collection() {
+        for (auto& worker : workers) {
+            lua_gc(worker->lua.lua_state(), LUA_GCCOLLECT);
+        }
+        gc_baseline_bytes = heap_bytes();
+    }
+
+    // Moves worker-local errors into the engine so last_error() stays a
+    // single place to look after a batch.
+    void collect_errors() {
+        for (auto& worker : workers) {
+            if (!worker->last_error.empty()) {
+                last_error = std::move(worker->last_error);
+                worker->last_error.clear();
+            }
+        }
+    }
+
+    // Compiles the script to bytecode, going through the on-disk cache so an
+    // unchanged script is never parsed again.
+    bool compile(const std::string& path, ScriptFile& file, bool use_cache = true) {
+        std::ifstream stream(path, std::ios::binary);
+        if (!stream) {
+            last_error = "Cannot read effect script: " + path;
+            return false;
+        }
+        std::string source((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+        if (use_cache) {
+            if (auto cached = script_cache.load(source)) {
+                file.bytecode = std::move(*cached);
+                file.cached = true;
+                return true;
+            }
+        }
+        file.cached = false;
 
-    bool load_effect_script(const std::string& path) {
         try {
-            sol::protected_function_result result = lua.safe_script_file(path);
-            if (!result.valid()) {
-                sol::error err = result;
+            sol::load_result chunk = main_worker().lua.load(source, "@" + path, sol::load_mode::text);
+            if (!chunk.valid()) {
+                sol::error err = chunk;
                 last_error = err.what();
                 return false;
             }
+            sol::protected_function function = chunk;
+            sol::bytecode bytecode = function.dump();
+            file.bytecode.assign(bytecode.as_string_view());
+        } catch (const std::exception& e) {
+            last_error = std::string("Failed to compile effect: ") + e.what();
+            return false;
+        }
 
-            sol::table effect_table = lua["effect"];
-            if (!effect_table.valid()) {
-                last_error = "Script missing 'effect' table: " + path;
+        (void)script_cache.store(source, file.bytecode);
+        return true;
+    }
+
+    // Scripts that fail to load are still recorded, so they are retried only
+    // once they change on disk.
+    bool load_effect_script(const std::string& path) {
+        ScriptFile& file = scripts[path];
+        file = ScriptFile{};
+        std::error_code ec;
+        file.write_time = std::filesystem::last_write_time(path, ec);
+        file.size = std::filesystem::file_size(path, ec);
+        if (!compile(path, file)) {
+            return false;
+        }
+
+        LuaWorker& worker = main_worker();
+        sol::optional<sol::table> effect_table = worker.load(path, file.bytecode);
+        if (!effect_table && file.cached) {
+            // A truncated or foreign cache entry must not keep the script
+            // broken; rebuild it from source, which also replaces the entry.
+            worker.last_error.clear();
+            if (!compile(path, file, false)) {
                 return false;
             }
+            effect_table = worker.load(path, file.bytecode);
+        }
+        if (!effect_table) {
+            collect_errors();
+            return false;
+        }
 
+        try {
             EffectInfo info;
-            info.id = effect_table["id"].get_or<std::string>("");
-            info.name = effect_table["name"].get_or<std::string>("");
+            info.id = (*effect_table)["id"].get_or<std::string>("");
+            info.name = (*effect_table)["name"].get_or<std::string>("");
             info.script_path = path;
+            info.pure = (*effect_table)["pure"].get_or(false);
 
-            if (info.id.empty()) {
-                last_error = "Effect missing 'id' field: " + path;
+            if (find_native(info.id)) {
+                worker.loaded.erase(info.id);
+                last_error = "Effect '" + info.id + "' is built in; ignoring " + path;
                 return false;
             }
 
-            sol::protected_function evaluate = lua["evaluate"];
-            if (evaluate.valid()) {
-                cached_evaluate_functions[info.id] = evaluate;
-            }
-
-            sol::optional<sol::table> params_table = effect_table["parameters"];
+            sol::optional<sol::table> params_table = (*effect_table)["parameters"];
             if (params_table) {
                 for (auto& kv : *params_table) {
                     sol::table param = kv.second.as<sol::table>();
@@ -62,6 +1224,12 @@ struct ScriptEngine::Impl {
                     ep.type = param["type"].get_or<std::string>("string");
                     ep.default_value = param["default"].get_or<std::string>("");
 
+                    if (auto kind = parameter_type_from_string(ep.type)) {
+                        ep.kind = *kind;
+                    } else {
+                        last_error = "Unknown parameter type '" + ep.type + "' in " + path;
+                    }
+
                     sol::optional<sol::table> values = param["values"];
                     if (values) {
                         for (auto& v : *values) {
@@ -69,12 +1237,22 @@ struct ScriptEngine::Impl {
                         }
                     }
 
+                    if (ep.kind == EffectParameterType::Enum &&
+                        !parse_enum(ep, ep.default_value) && !ep.enum_values.empty()) {
+                        last_error = "Enum default '" + ep.default_value + "' not in values: " + path;
+                        ep.default_value = ep.enum_values.front();
+                    }
+
                     if (!ep.name.empty()) {
                         info.parameters.push_back(std::move(ep));
                     }
                 }
             }
 
+            for (size_t i = 1; i < workers.size(); ++i) {
+                (void)workers[i]->load(path, file.bytecode);
+            }
+            file.effect_id = info.id;
             effects.push_back(std::move(info));
             return true;
         } catch (const std::exception& e) {
@@ -82,6 +1260,63 @@ struct ScriptEngine::Impl {
             return false;
         }
     }
+
+    void unload_script(const std::string& path) {
+        auto it = scripts.find(path);
+        if (it == scripts.end()) return;
+
+        if (!it->second.effect_id.empty()) {
+            std::erase_if(effects, [&path](const EffectInfo& info) { return info.script_path == path; });
+            for (auto& worker : workers) {
+                worker->unload(it->second.effect_id);
+            }
+        }
+        scripts.erase(it);
+    }
+
+    std::vector<std::string> script_files() const {
+        std::vector<std::string> files;
+        for (const auto& dir : effect_directories) {
+            std::error_code ec;
+            for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+                if (entry.path().extension() == ".lua") {
+                    files.push_back(entry.path().string());
+                }
+            }
+        }
+        return files;
+    }
+
+    bool reload_changed() {
+        std::vector<std::string> files = script_files();
+        std::unordered_set<std::string> present(files.begin(), files.end());
+        bool changed = false;
+
+        std::vector<std::string> removed;
+        for (const auto& [path, file] : scripts) {
+            if (!present.contains(path)) {
+                removed.push_back(path);
+            }
+        }
+        for (const auto& path : removed) {
+            unload_script(path);
+            changed = true;
+        }
+
+        for (const auto& path : files) {
+            std::error_code ec;
+            auto write_time = std::filesystem::last_write_time(path, ec);
+            auto size = std::filesystem::file_size(path, ec);
+            if (auto it = scripts.find(path);
+                it != scripts.end() && it->second.write_time == write_time && it->second.size == size) {
+                continue;
+            }
+            unload_script(path);
+            load_effect_script(path);
+            changed = true;
+        }
+        return changed;
+    }
 };
 
 ScriptEngine::ScriptEngine() : impl_(std::make_unique<Impl>()) {}
@@ -95,26 +1330,23 @@ bool ScriptEngine::initialize() {
         return true;
     }
 
-    try {
-        impl_->lua.open_libraries(
-            sol::lib::base,
-            sol::lib::math,
-            sol::lib::string,
-            sol::lib::table
-        );
-
-        register_lua_bindings(impl_->lua.lua_state());
-
-        impl_->initialized = true;
-        return true;
-    } catch (const std::exception& e) {
-        impl_->last_error = e.what();
+    if (!impl_->main_worker().open(impl_->project, impl_->timeline_data)) {
+        impl_->collect_errors();
         return false;
     }
+
+    impl_->initialized = true;
+    return true;
 }
 
 void ScriptEngine::shutdown() {
-    impl_->effects.clear();
+    impl_->stop_threads();
+    impl_->workers.clear();
+    impl_->workers.push_back(std::make_unique<LuaWorker>());
+    impl_->reset_effects();
+    impl_->scripts.clear();
+    impl_->watcher.close();
+    impl_->gc_baseline_bytes = 0;
     impl_->initialized = false;
 }
 
@@ -123,20 +1355,103 @@ void ScriptEngine::add_effect_directory(const std::string& path) {
 }
 
 void ScriptEngine::scan_effect_directories() {
-    impl_->effects.clear();
-    impl_->cached_evaluate_functions.clear();
+    for (auto& worker : impl_->workers) {
+        worker->unload_all();
+    }
+    impl_->reset_effects();
+    impl_->scripts.clear();
+
+    for (const auto& path : impl_->script_files()) {
+        impl_->load_effect_script(path);
+    }
+    impl_->watcher.watch(impl_->effect_directories);
+    impl_->gc_baseline_bytes = 0;
+}
+
+bool ScriptEngine::reload_changed_effects() {
+    return impl_->reload_changed();
+}
+
+bool ScriptEngine::poll_effect_changes() {
+    return impl_->watcher.changed() && impl_->reload_changed();
+}
+
+ScriptGcStats ScriptEngine::collect_garbage(double budget_ms, bool idle) {
+    ScriptGcStats stats;
+    if (!impl_->initialized) return stats;
+
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed_ms = [&start] {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    size_t heap = impl_->heap_bytes();
+    size_t growth = idle ? 2 : GC_RUNAWAY_FACTOR;
+    if (impl_->gc_baseline_bytes == 0) {
+        impl_->gc_baseline_bytes = heap;
+    } else if (heap > impl_->gc_baseline_bytes * growth) {
+        impl_->full_collection();
+        stats.full_collection = true;
+    }
+
+    // Each step is one minor collection; states take turns so a tight
+    // budget still reaches every one of them over a few frames.
+    auto& workers = impl_->workers;
+    for (size_t n = 0; !stats.full_collection && n < workers.size(); ++n) {
+        impl_->gc_cursor %= workers.size();
+        lua_gc(workers[impl_->gc_cursor++]->lua.lua_state(), LUA_GCSTEP, 0);
+        ++stats.steps;
+        if (elapsed_ms() >= budget_ms) break;
+    }
+
+    stats.collect_ms = elapsed_ms();
+    stats.heap_bytes = impl_->heap_bytes();
+    return stats;
+}
+
+void ScriptEngine::set_instruction_budget(uint32_t instructions) {
+    impl_->instruction_budget = instructions;
+    for (auto& worker : impl_->workers) {
+        worker->instruction_budget = instructions;
+    }
+}
 
-    for (const auto& dir : impl_->effect_directories) {
-        if (!std::filesystem::exists(dir)) {
-            continue;
+uint32_t ScriptEngine::instruction_budget() const {
+    return impl_->instruction_budget;
+}
+
+std::vector<EffectTiming> ScriptEngine::take_effect_timings() {
+    std::unordered_map<std::string, EffectTiming> merged;
+    for (auto& worker : impl_->workers) {
+        for (const auto& [id, timing] : worker->timings) {
+            EffectTiming& total = merged[id];
+            total.total_ms += timing.total_ms;
+            total.calls += timing.calls;
+            total.aborted += timing.aborted;
+            total.memo_hits += timing.memo_hits;
         }
+        worker->timings.clear();
+    }
 
-        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
-            if (entry.path().extension() == ".lua") {
-                impl_->load_effect_script(entry.path().string());
+    std::vector<EffectTiming> timings;
+    timings.reserve(merged.size());
+    for (auto& [id, timing] : merged) {
+        if (timing.aborted > 0) {
+            for (auto& info : impl_->effects) {
+                if (info.id == id) info.slow = true;
             }
         }
+        timing.effect_id = id;
+        timings.push_back(std::move(timing));
     }
+    std::sort(timings.begin(), timings.end(), [](const EffectTiming& a, const EffectTiming& b) {
+        return a.total_ms > b.total_ms;
+    });
+    return timings;
+}
+
+ScriptCache& ScriptEngine::script_cache() {
+    return impl_->script_cache;
 }
 
 const std::vector<EffectInfo>& ScriptEngine::available_effects() const {
@@ -144,195 +1459,98 @@ const std::vector<EffectInfo>& ScriptEngine::available_effects() const {
 }
 
 const EffectInfo* ScriptEngine::find_effect(const std::string& effect_id) const {
-    for (const auto& effect : impl_->effects) {
-        if (effect.id == effect_id) {
-            return &effect;
-        }
-    }
-    return nullptr;
+    return impl_->find_effect(effect_id);
 }
 
 void ScriptEngine::set_project(Project* project) {
     impl_->project = project;
-    bind_project(impl_->lua.lua_state(), project);
+    impl_->bind_workers();
 }
 
 void ScriptEngine::set_timeline_data(TimelineData* data) {
     impl_->timeline_data = data;
-    bind_timeline_data(impl_->lua.lua_state(), data);
+    impl_->bind_workers();
 }
 
 EffectResult ScriptEngine::evaluate_effect(
     const ClipEffect& effect,
     const EffectContext& context
 ) {
-    EffectResult result;
-
-    const EffectInfo* info = find_effect(effect.effect_id);
+    const EffectInfo* info = impl_->find_effect(effect.effect_id);
     if (!info) {
         impl_->last_error = "Effect not found: " + effect.effect_id;
-        return result;
+        return {};
     }
 
-    try {
-        auto cached_it = impl_->cached_evaluate_functions.find(effect.effect_id);
-        if (cached_it == impl_->cached_evaluate_functions.end()) {
-            impl_->last_error = "Effect missing cached 'evaluate' function: " + effect.effect_id;
-            return result;
-        }
-        sol::protected_function evaluate = cached_it->second;
-
-        sol::table lua_context = impl_->lua.create_table();
-        lua_context["current_beats"] = context.current_beats;
-        lua_context["clip_local_beats"] = context.clip_local_beats;
-
-        if (context.clip) {
-            // clip table contains accumulated values from previous effects
-            sol::table clip_table = impl_->lua.create_table();
-            clip_table["id"] = context.clip->id;
-            clip_table["source_id"] = context.clip->source_id;
-            clip_table["track_index"] = context.clip->track_index;
-            clip_table["start_beat"] = context.clip->start_beat;
-            clip_table["duration_beats"] = context.clip->duration_beats;
-            clip_table["source_start_seconds"] = context.clip->source_start_seconds;
-            clip_table["position_x"] = context.accumulated.position_x;
-            clip_table["position_y"] = context.accumulated.position_y;
-            clip_table["scale_x"] = context.accumulated.scale_x;
-            clip_table["scale_y"] = context.accumulated.scale_y;
-            clip_table["rotation"] = context.accumulated.rotation;
-            lua_context["clip"] = clip_table;
-
-            // base table contains the clip's original transform values
-            sol::table base_table = impl_->lua.create_table();
-            base_table["position_x"] = context.clip->position_x;
-            base_table["position_y"] = context.clip->position_y;
-            base_table["scale_x"] = context.clip->scale_x;
-            base_table["scale_y"] = context.clip->scale_y;
-            base_table["rotation"] = context.clip->rotation;
-            lua_context["base"] = base_table;
-        }
-
-        if (context.tempo) {
-            sol::table tempo_table = impl_->lua.create_table();
-            tempo_table["bpm"] = context.tempo->bpm();
-            tempo_table["beat_duration_seconds"] = context.tempo->beat_duration_seconds();
-
-            tempo_table["beats_to_time"] = [tempo = context.tempo](double beats) {
-                return tempo->beats_to_time(beats);
-            };
-            tempo_table["time_to_beats"] = [tempo = context.tempo](double seconds) {
-                return tempo->time_to_beats(seconds);
-            };
-
-            lua_context["tempo"] = tempo_table;
-        }
-
-        sol::table lua_params = impl_->lua.create_table();
-        for (const auto& [key, value] : effect.parameters) {
-            lua_params[key] = value;
-        }
-
-        sol::protected_function_result eval_result = evaluate(lua_context, lua_params);
-        if (!eval_result.valid()) {
-            sol::error err = eval_result;
-            impl_->last_error = err.what();
-            return result;
-        }
-
-        sol::table result_table = eval_result;
-        if (result_table.valid()) {
-            result.source_position_seconds = result_table["source_position_seconds"].get_or(0.0);
-            result.use_looped_frame = result_table["use_looped_frame"].get_or(false);
-            result.loop_start_seconds = result_table["loop_start_seconds"].get_or(0.0);
-            result.loop_duration_seconds = result_table["loop_duration_seconds"].get_or(0.0);
-            result.position_in_loop_seconds = result_table["position_in_loop_seconds"].get_or(0.0);
-
-            result.use_looped_audio = result_table["use_looped_audio"].get_or(false);
-            result.audio_loop_start_seconds = result_table["audio_loop_start_seconds"].get_or(0.0);
-            result.audio_loop_duration_seconds = result_table["audio_loop_duration_seconds"].get_or(0.0);
-
-            if (result_table["position_x"].valid()) {
-                result.position_x = result_table["position_x"].get<float>();
-            }
-            if (result_table["position_y"].valid()) {
-                result.position_y = result_table["position_y"].get<float>();
-            }
-            if (result_table["scale_x"].valid()) {
-                result.scale_x = result_table["scale_x"].get<float>();
-            }
-            if (result_table["scale_y"].valid()) {
-                result.scale_y = result_table["scale_y"].get<float>();
-            }
-            if (result_table["rotation"].valid()) {
-                result.rotation = result_table["rotation"].get<float>();
-            }
-        }
-
-        return result;
-    } catch (const std::exception& e) {
-        impl_->last_error = e.what();
-        return result;
-    }
+    EffectResult result = impl_->evaluate_one(impl_->worker_for(context), *info, effect, context);
+    impl_->collect_errors();
+    return result;
 }
 
 EffectResult ScriptEngine::evaluate_effects(
     const std::vector<ClipEffect>& effects,
     const EffectContext& context
 ) {
-    EffectResult combined;
+    EffectResult result = impl_->evaluate_chain(impl_->worker_for(context), effects, context);
+    impl_->collect_errors();
+    return result;
+}
 
-    EffectContext running_context = context;
-    if (context.clip) {
-        running_context.accumulated.position_x = context.clip->position_x;
-        running_context.accumulated.position_y = context.clip->position_y;
-        running_context.accumulated.scale_x = context.clip->scale_x;
-        running_context.accumulated.scale_y = context.clip->scale_y;
-        running_context.accumulated.rotation = context.clip->rotation;
+void ScriptEngine::evaluate_effects_batch(
+    const std::vector<EffectJob>& jobs,
+    std::vector<EffectResult>& results
+) {
+    std::vector<size_t> offsets(jobs.size());
+    size_t total = 0;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        offsets[i] = total;
+        total += jobs[i].clip_local_beats.empty() ? 1 : jobs[i].clip_local_beats.size();
     }
 
-    for (const auto& effect : effects) {
-        if (!effect.enabled) {
-            continue;
-        }
+    results.assign(total, EffectResult{});
+    if (jobs.empty()) return;
 
-        EffectResult effect_result = evaluate_effect(effect, running_context);
+    // The pool is sized for the machine the first time a batch is big
+    // enough to split, so the clip-to-worker mapping settles early.
+    size_t wanted = std::max<size_t>(1, total / MIN_JOBS_PER_WORKER);
+    if (wanted > 1 && jobs.size() > 1 && impl_->initialized) {
+        impl_->ensure_workers(std::max(1u, std::thread::hardware_concurrency()));
+    }
 
-        if (effect_result.use_looped_frame) {
-            combined.use_looped_frame = true;
-            combined.loop_start_seconds = effect_result.loop_start_seconds;
-            combined.loop_duration_seconds = effect_result.loop_duration_seconds;
-            combined.position_in_loop_seconds = effect_result.position_in_loop_seconds;
-        }
+    auto& assigned = impl_->assigned_jobs;
+    assigned.resize(impl_->workers.size());
+    for (auto& list : assigned) {
+        list.clear();
+    }
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        assigned[impl_->worker_index(jobs[i].context, i)].push_back(i);
+    }
 
-        if (effect_result.use_looped_audio) {
-            combined.use_looped_audio = true;
-            combined.audio_loop_start_seconds = effect_result.audio_loop_start_seconds;
-            combined.audio_loop_duration_seconds = effect_result.audio_loop_duration_seconds;
+    auto run = [&](size_t worker_index) {
+        LuaWorker& worker = *impl_->workers[worker_index];
+        for (size_t i : assigned[worker_index]) {
+            const EffectJob& job = jobs[i];
+            if (!job.effects) continue;
+            if (job.clip_local_beats.empty()) {
+                results[offsets[i]] = impl_->evaluate_chain(worker, *job.effects, job.context);
+            } else {
+                std::span<EffectResult> out(results.data() + offsets[i], job.clip_local_beats.size());
+                impl_->evaluate_chain_span(worker, *job.effects, job.context, job.clip_local_beats, out);
+            }
         }
+    };
 
-        if (effect_result.position_x) {
-            running_context.accumulated.position_x = *effect_result.position_x;
-            combined.position_x = effect_result.position_x;
-        }
-        if (effect_result.position_y) {
-            running_context.accumulated.position_y = *effect_result.position_y;
-            combined.position_y = effect_result.position_y;
-        }
-        if (effect_result.scale_x) {
-            running_context.accumulated.scale_x = *effect_result.scale_x;
-            combined.scale_x = effect_result.scale_x;
-        }
-        if (effect_result.scale_y) {
-            running_context.accumulated.scale_y = *effect_result.scale_y;
-            combined.scale_y = effect_result.scale_y;
-        }
-        if (effect_result.rotation) {
-            running_context.accumulated.rotation = *effect_result.rotation;
-            combined.rotation = effect_result.rotation;
+    // Small batches are not worth waking the pool; the calling thread runs
+    // each job in its own worker's state instead.
+    if (wanted > 1 && !impl_->threads.empty()) {
+        impl_->run_on_workers(run);
+    } else {
+        for (size_t i = 0; i < assigned.size(); ++i) {
+            run(i);
         }
     }
 
-    return combined;
+    impl_->collect_errors();
 }
 
 bool ScriptEngine::is_initialized() const {
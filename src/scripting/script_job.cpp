@@ -0,0 +1,415 @@
+#include "furious/scripting/script_job.hpp"
+#include "furious/scripting/lua_bindings.hpp"
+#include "furious/core/clip_commands.hpp"
+#include "furious/core/timeline_data.hpp"
+
+#define SOL_ALL_SAFETIES_ON 1
+#include <sol/sol.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace furious {
+
+namespace {
+
+// Edits a job has made so far. Added clips are kept whole, changed clips as
+// their complete new state; nothing touches the timeline until the job ends.
+struct StagedEdits {
+    std::vector<TimelineClip> added;
+    std::unordered_map<std::string, size_t> added_index;
+    std::unordered_map<std::string, TimelineClip> modified;
+    std::unordered_set<std::string> removed;
+    size_t count = 0;
+
+    void clear() { *this = StagedEdits{}; }
+
+    void drop_added(const std::string& id) {
+        auto it = added_index.find(id);
+        if (it == added_index.end()) return;
+        added.erase(added.begin() + static_cast<std::ptrdiff_t>(it->second));
+        added_index.clear();
+        for (size_t i = 0; i < added.size(); ++i) {
+            added_index.emplace(added[i].id, i);
+        }
+    }
+};
+
+bool overlaps(const TimelineClip& clip, double start_beat, double end_beat) {
+    return clip.start_beat < end_beat && clip.end_beat() > start_beat;
+}
+
+void apply_clip_fields(TimelineClip& clip, const sol::table& fields) {
+    if (auto value = fields.get<sol::optional<std::string>>("source_id")) clip.source_id = *value;
+    if (auto value = fields.get<sol::optional<double>>("track_index")) {
+        clip.track_index = static_cast<size_t>(std::max(0.0, *value));
+    }
+    if (auto value = fields.get<sol::optional<double>>("start_beat")) clip.start_beat = *value;
+    if (auto value = fields.get<sol::optional<double>>("duration_beats")) clip.duration_beats = *value;
+    if (auto value = fields.get<sol::optional<double>>("source_start_seconds")) clip.source_start_seconds = *value;
+    if (auto value = fields.get<sol::optional<float>>("position_x")) clip.position_x = *value;
+    if (auto value = fields.get<sol::optional<float>>("position_y")) clip.position_y = *value;
+    if (auto value = fields.get<sol::optional<float>>("scale_x")) clip.scale_x = *value;
+    if (auto value = fields.get<sol::optional<float>>("scale_y")) clip.scale_y = *value;
+    if (auto value = fields.get<sol::optional<float>>("rotation")) clip.rotation = *value;
+}
+
+sol::table clip_table(sol::state_view lua, const TimelineClip& clip) {
+    return lua.create_table_with(
+        "id", clip.id,
+        "source_id", clip.source_id,
+        "track_index", clip.track_index,
+        "start_beat", clip.start_beat,
+        "duration_beats", clip.duration_beats,
+        "source_start_seconds", clip.source_start_seconds,
+        "position_x", clip.position_x,
+        "position_y", clip.position_y,
+        "scale_x", clip.scale_x,
+        "scale_y", clip.scale_y,
+        "rotation", clip.rotation
+    );
+}
+
+} // namespace
+
+struct ScriptJobRunner::Impl {
+    Project* project = nullptr;
+    TimelineData* timeline_data = nullptr;
+    std::vector<std::string> job_directories;
+
+    // A fresh state per job, so nothing one job defines survives into the next.
+    std::unique_ptr<sol::state> lua;
+    sol::thread thread;
+    int pending_args = 0;
+    std::chrono::steady_clock::time_point deadline;
+
+    ScriptJobStatus status = ScriptJobStatus::Idle;
+    std::string job_name;
+    std::string last_error;
+    double progress = 0.0;
+    StagedEdits edits;
+    std::unique_ptr<Command> finished_command;
+
+    // Yields the job's coroutine back to resume() once the frame's budget is
+    // spent. Calls made from inside a C function cannot yield and carry on
+    // until the next check.
+    static void yield_hook(lua_State* L, lua_Debug*) {
+        Impl* impl = *static_cast<Impl**>(lua_getextraspace(L));
+        if (std::chrono::steady_clock::now() >= impl->deadline && lua_isyieldable(L)) {
+            lua_yield(L, 0);
+        }
+    }
+
+    void reset() {
+        thread = sol::thread{};
+        lua.reset();
+        pending_args = 0;
+        status = ScriptJobStatus::Idle;
+        job_name.clear();
+        progress = 0.0;
+        edits.clear();
+        finished_command.reset();
+    }
+
+    bool fail(std::string message) {
+        last_error = std::move(message);
+        thread = sol::thread{};
+        lua.reset();
+        edits.clear();
+        status = ScriptJobStatus::Failed;
+        return false;
+    }
+
+    const TimelineClip* staged_clip(const std::string& id) const {
+        if (auto it = edits.added_index.find(id); it != edits.added_index.end()) {
+            return &edits.added[it->second];
+        }
+        if (edits.removed.contains(id)) return nullptr;
+        if (auto it = edits.modified.find(id); it != edits.modified.end()) {
+            return &it->second;
+        }
+        return timeline_data ? timeline_data->find_clip(id) : nullptr;
+    }
+
+    void validate(const TimelineClip& clip) const {
+        if (clip.source_id.empty()) {
+            throw sol::error("clip needs a source_id");
+        }
+        if (clip.duration_beats <= 0.0) {
+            throw sol::error("clip duration_beats must be positive");
+        }
+        if (timeline_data && clip.track_index >= timeline_data->track_count()) {
+            throw sol::error("track_index " + std::to_string(clip.track_index) + " does not exist");
+        }
+    }
+
+    std::string add_clip(const sol::table& fields) {
+        TimelineClip clip;
+        clip.id = TimelineData::generate_id();
+        apply_clip_fields(clip, fields);
+        validate(clip);
+
+        edits.added_index.emplace(clip.id, edits.added.size());
+        edits.added.push_back(std::move(clip));
+        ++edits.count;
+        return edits.added.back().id;
+    }
+
+    void modify_clip(const std::string& id, const sol::table& fields) {
+        const TimelineClip* current = staged_clip(id);
+        if (!current) {
+            throw sol::error("no clip with id " + id);
+        }
+        TimelineClip clip = *current;
+        apply_clip_fields(clip, fields);
+        validate(clip);
+
+        if (auto it = edits.added_index.find(id); it != edits.added_index.end()) {
+            edits.added[it->second] = std::move(clip);
+        } else {
+            edits.modified[id] = std::move(clip);
+        }
+        ++edits.count;
+    }
+
+    void remove_clip(const std::string& id) {
+        if (!staged_clip(id)) return;
+        if (edits.added_index.contains(id)) {
+            edits.drop_added(id);
+        } else {
+            edits.modified.erase(id);
+            edits.removed.insert(id);
+        }
+        ++edits.count;
+    }
+
+    sol::table clips_in_range(double start_beat, double end_beat) {
+        sol::table result = lua->create_table();
+        std::unordered_set<std::string> listed;
+        auto append = [&](const TimelineClip& clip) {
+            if (overlaps(clip, start_beat, end_beat) && listed.insert(clip.id).second) {
+                result.add(clip_table(*lua, clip));
+            }
+        };
+
+        if (timeline_data) {
+            for (const TimelineClip* clip : timeline_data->clips_in_range(start_beat, end_beat)) {
+                if (edits.removed.contains(clip->id)) continue;
+                auto it = edits.modified.find(clip->id);
+                append(it != edits.modified.end() ? it->second : *clip);
+            }
+        }
+        for (const auto& [id, clip] : edits.modified) {
+            append(clip);
+        }
+        for (const auto& clip : edits.added) {
+            append(clip);
+        }
+        return result;
+    }
+
+    // The job's calls live on the existing furious.timeline table next to
+    // the read-only counts every state gets.
+    void bind_job_api() {
+        sol::state_view view(*lua);
+        sol::table furious = view["furious"];
+        sol::table timeline = furious["timeline"].get_or_create<sol::table>();
+
+        timeline.set_function("add_clip", [this](const sol::table& fields) { return add_clip(fields); });
+        timeline.set_function("modify_clip", [this](const std::string& id, const sol::table& fields) {
+            modify_clip(id, fields);
+        });
+        timeline.set_function("remove_clip", [this](const std::string& id) { remove_clip(id); });
+        timeline.set_function("clip", [this](const std::string& id) -> sol::object {
+            const TimelineClip* clip = staged_clip(id);
+            if (!clip) return sol::lua_nil;
+            return clip_table(*lua, *clip);
+        });
+        timeline.set_function("clips_in_range", [this](double start_beat, double end_beat) {
+            return clips_in_range(start_beat, end_beat);
+        });
+
+        furious["job"] = view.create_table_with(
+            "set_progress", [this](double fraction) { progress = std::clamp(fraction, 0.0, 1.0); }
+        );
+    }
+
+    bool start(const std::string& path, const ScriptJobContext& context) {
+        if (status == ScriptJobStatus::Running) {
+            last_error = "A script job is already running";
+            return false;
+        }
+        reset();
+
+        try {
+            lua = std::make_unique<sol::state>();
+            lua->open_libraries(sol::lib::base, sol::lib::math, sol::lib::string, sol::lib::table);
+            lua_State* L = lua->lua_state();
+            register_lua_bindings(L);
+            bind_project(L, project, ProjectAccess::ReadWrite);
+            bind_timeline_data(L, timeline_data);
+            bind_job_api();
+
+            sol::protected_function_result result = lua->safe_script_file(path, &sol::script_pass_on_error);
+            if (!result.valid()) {
+                sol::error err = result;
+                return fail(err.what());
+            }
+
+            job_name = std::filesystem::path(path).stem().string();
+            if (sol::optional<sol::table> job = (*lua)["job"]) {
+                job_name = (*job)["name"].get_or(job_name);
+            }
+
+            // The coroutine inherits the main thread's extra space, so the
+            // hook can find this runner from either.
+            *static_cast<Impl**>(lua_getextraspace(L)) = this;
+            thread = sol::thread::create(L);
+            lua_State* co = thread.thread_state();
+            lua_sethook(co, &Impl::yield_hook, LUA_MASKCOUNT, YIELD_CHECK_INTERVAL);
+
+            if (lua_getglobal(co, "run") != LUA_TFUNCTION) {
+                return fail("Job script missing 'run' function: " + path);
+            }
+            sol::table job_context = lua->create_table_with(
+                "playhead_beats", context.playhead_beats,
+                "selected_clip_id", context.selected_clip_id
+            );
+            job_context.push(co);
+            pending_args = 1;
+        } catch (const std::exception& e) {
+            return fail(std::string("Failed to start job: ") + e.what());
+        }
+
+        status = ScriptJobStatus::Running;
+        return true;
+    }
+
+    ScriptJobStatus resume(double budget_ms) {
+        if (status != ScriptJobStatus::Running) return status;
+
+        deadline = std::chrono::steady_clock::now() +
+                   std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                       std::chrono::duration<double, std::milli>(budget_ms));
+
+        lua_State* co = thread.thread_state();
+        int results = 0;
+        int rc = lua_resume(co, lua->lua_state(), pending_args, &results);
+        pending_args = 0;
+
+        if (rc == LUA_YIELD) {
+            lua_pop(co, results);
+            return status;
+        }
+        if (rc != LUA_OK) {
+            const char* message = lua_tostring(co, -1);
+            fail(message ? message : "Job script failed");
+            return status;
+        }
+
+        finished_command = build_command();
+        thread = sol::thread{};
+        lua.reset();
+        edits.clear();
+        progress = 1.0;
+        status = ScriptJobStatus::Finished;
+        return status;
+    }
+
+    // Changes and removals are checked against the timeline as it is now,
+    // since the user may have edited it while the job ran.
+    std::unique_ptr<Command> build_command() {
+        if (!timeline_data) return nullptr;
+
+        auto compound = std::make_unique<CompoundCommand>("Run " + job_name);
+        for (auto& [id, clip] : edits.modified) {
+            if (const TimelineClip* current = timeline_data->find_clip(id)) {
+                compound->add(std::make_unique<ModifyClipCommand>(*timeline_data, id, *current, std::move(clip)));
+            }
+        }
+        for (const auto& id : edits.removed) {
+            if (timeline_data->find_clip(id)) {
+                compound->add(std::make_unique<RemoveClipCommand>(*timeline_data, id));
+            }
+        }
+        for (auto& clip : edits.added) {
+            compound->add(std::make_unique<AddClipCommand>(*timeline_data, std::move(clip)));
+        }
+
+        if (compound->empty()) return nullptr;
+        return compound;
+    }
+};
+
+ScriptJobRunner::ScriptJobRunner() : impl_(std::make_unique<Impl>()) {}
+
+ScriptJobRunner::~ScriptJobRunner() = default;
+
+void ScriptJobRunner::set_project(Project* project) {
+    impl_->project = project;
+}
+
+void ScriptJobRunner::set_timeline_data(TimelineData* data) {
+    impl_->timeline_data = data;
+}
+
+void ScriptJobRunner::add_job_directory(const std::string& path) {
+    impl_->job_directories.push_back(path);
+}
+
+std::vector<std::string> ScriptJobRunner::job_scripts() const {
+    std::vector<std::string> files;
+    for (const auto& dir : impl_->job_directories) {
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+            if (entry.path().extension() == ".lua") {
+                files.push_back(entry.path().string());
+            }
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+bool ScriptJobRunner::start(const std::string& path, const ScriptJobContext& context) {
+    return impl_->start(path, context);
+}
+
+ScriptJobStatus ScriptJobRunner::resume(double budget_ms) {
+    return impl_->resume(budget_ms);
+}
+
+void ScriptJobRunner::cancel() {
+    if (impl_->status == ScriptJobStatus::Running) {
+        impl_->reset();
+    }
+}
+
+std::unique_ptr<Command> ScriptJobRunner::take_command() {
+    return std::move(impl_->finished_command);
+}
+
+ScriptJobStatus ScriptJobRunner::status() const {
+    return impl_->status;
+}
+
+const std::string& ScriptJobRunner::job_name() const {
+    return impl_->job_name;
+}
+
+size_t ScriptJobRunner::staged_edits() const {
+    return impl_->edits.count;
+}
+
+double ScriptJobRunner::progress() const {
+    return impl_->progress;
+}
+
+const std::string& ScriptJobRunner::last_error() const {
+    return impl_->last_error;
+}
+
+} // namespace furious
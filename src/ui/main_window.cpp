@@ -1,6 +1,7 @@
 #include "furious/ui/main_window.hpp"
 #include "furious/core/project_data.hpp"
 #include "furious/core/clip_commands.hpp"
+#include "furious/core/key_hasher.hpp"
 #include "furious/core/pattern_commands.hpp"
 #include "imgui.h"
 #include "imgui_internal.h"
@@ -8,9 +9,55 @@
 #include <nfd.h>
 #include <algorithm>
 #include <cmath>
+#include <filesystem>
 
 namespace furious {
 
+namespace {
+
+// Time the Lua collector may take at the end of a frame.
+constexpr double SCRIPT_GC_BUDGET_MS = 0.5;
+
+// Time a running script job may take per frame.
+constexpr double SCRIPT_JOB_BUDGET_MS = 4.0;
+
+// Loop frames decoded per engine-lock hold while building clip caches.
+constexpr size_t CACHE_FRAMES_PER_STEP = 4;
+
+// Everything about a clip that its resolved state at a fixed beat depends
+// on. Edits made in place through the clip panel or viewport only show up
+// here, not in the timeline's generation.
+uint64_t clip_fingerprint(const TimelineClip& clip, const PatternLibrary& patterns, const MediaSource* source) {
+    KeyHasher hasher;
+    hasher.add(clip.source_id);
+    hasher.add(static_cast<uint64_t>(clip.track_index));
+    hasher.add(clip.start_beat);
+    hasher.add(clip.duration_beats);
+    hasher.add(clip.source_start_seconds);
+    hasher.add(clip.position_x);
+    hasher.add(clip.position_y);
+    hasher.add(clip.scale_x);
+    hasher.add(clip.scale_y);
+    hasher.add(clip.rotation);
+    hasher.add(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(source ? source->audio_buffer.get() : nullptr)));
+
+    for (const auto& effect : clip.effects) {
+        hasher.add(effect.effect_id);
+        hasher.add(static_cast<uint64_t>(effect.enabled));
+        hasher.add(effect.parameters);
+    }
+
+    for (const auto& ref : clip.patterns) {
+        hasher.add(ref.pattern_id);
+        hasher.add(static_cast<uint64_t>(ref.enabled));
+        hasher.add(static_cast<uint64_t>(static_cast<int64_t>(ref.offset_subdivisions)));
+        hasher.add(patterns.pattern_revision(ref));
+    }
+    return hasher.value();
+}
+
+} // namespace
+
 MainWindow::MainWindow()
     : project_("FURIOUS Project")
     , timeline_(project_)
@@ -25,12 +72,15 @@ MainWindow::MainWindow()
     script_engine_.set_project(&project_);
     script_engine_.set_timeline_data(&timeline_data_);
 
+    script_jobs_.add_job_directory("scripts/jobs");
+    script_jobs_.set_project(&project_);
+    script_jobs_.set_timeline_data(&timeline_data_);
+    job_scripts_ = script_jobs_.job_scripts();
+
     timeline_.set_timeline_data(&timeline_data_);
     timeline_.set_source_library(&source_library_);
 
-    viewport_.set_video_engine(&video_engine_);
     viewport_.set_timeline_data(&timeline_data_);
-    viewport_.set_source_library(&source_library_);
 
     patterns_window_.set_pattern_library(&pattern_library_);
     patterns_window_.set_tempo(&project_.tempo());
@@ -39,9 +89,18 @@ MainWindow::MainWindow()
     });
 
     pattern_evaluator_.set_pattern_library(&pattern_library_);
+
+    automation_baker_.set_timeline_data(&timeline_data_);
+    automation_baker_.set_pattern_library(&pattern_library_);
+    automation_baker_.set_script_engine(&script_engine_);
+    automation_baker_.set_tempo(&project_.tempo());
+    timeline_.set_automation_baker(&automation_baker_);
+
+    profiler_.set_audio_stats(&audio_engine_.callback_stats());
 }
 
 MainWindow::~MainWindow() {
+    render_thread_.stop();
     script_engine_.shutdown();
     video_engine_.shutdown();
     audio_engine_.shutdown();
@@ -57,14 +116,16 @@ void MainWindow::render() {
 
     if (cache_building_) {
         render_loading_modal();
-        if (!cache_next_clip()) {
+        cache_next_clip();
+        if (cache_finished_clips_->load() >= cache_total_clips_) {
             cache_building_ = false;
         }
         return;
     }
 
     profiler_.update();
-    profiler_.set_video_decoder_info(video_engine_.get_active_decoder_info());
+    profiler_.set_video_decoder_info(render_thread_.decoder_info());
+    profiler_.set_preview_render_ms(render_thread_.last_render_ms(), render_thread_.last_draw_calls());
     if (ImGui::IsKeyPressed(ImGuiKey_F3)) {
         profiler_.toggle_visible();
     }
@@ -119,11 +180,43 @@ void MainWindow::render() {
 
     auto t2 = std::chrono::high_resolution_clock::now();
 
+    // Commands from last frame's UI have landed by now.
+    timeline_data_.publish_snapshot();
+    if (auto snapshot = timeline_data_.snapshot(); snapshot && snapshot->generation() != retained_generation_) {
+        retained_generation_ = snapshot->generation();
+        render_thread_.post([snapshot](VideoEngine& engine) {
+            std::vector<uint32_t> live;  // generation per handle index
+            for (ClipHandle handle : snapshot->handles()) {
+                if (handle.index >= live.size()) live.resize(handle.index + 1, 0);
+                live[handle.index] = handle.generation;
+            }
+            engine.retain_clips([&live](ClipHandle handle) {
+                return handle.index < live.size() && live[handle.index] == handle.generation;
+            });
+        });
+    }
+
     video_engine_.set_interactive_mode(timeline_.is_dragging_clip());
-    video_engine_.begin_frame();
-    sync_video_to_playhead();
-    sync_audio_to_playhead();
-    video_engine_.update();
+    if (script_engine_.poll_effect_changes()) {
+        automation_baker_.clear();
+        ++effects_generation_;
+    }
+    // Swapped buffers change the clip fingerprints, which resyncs audio.
+    (void)source_library_.poll_reencoded_audio();
+
+    // A paused editor with no edits resolves nothing; the render thread
+    // keeps the last submission and finishes any loop caches by itself.
+    bool clips_changed = resolve_active_clips();
+    bool resized = project_.width() != preview_width_ || project_.height() != preview_height_;
+    if (clips_changed || resized) {
+        render_thread_.set_fps(project_.fps());
+        sync_video_to_playhead();
+    }
+    if (clips_changed) {
+        sync_audio_to_playhead();
+    }
+    viewport_.set_selected_clip_id(timeline_.selected_clip_id());
+    viewport_.set_preview(&render_thread_.acquire());
 
     auto t3 = std::chrono::high_resolution_clock::now();
 
@@ -133,6 +226,7 @@ void MainWindow::render() {
     render_audio_panel();
     render_sources_panel();
     render_effects_panel();
+    render_scripts_panel();
     patterns_window_.render();
 
     auto t4 = std::chrono::high_resolution_clock::now();
@@ -173,6 +267,8 @@ void MainWindow::render() {
             timeline_data_, old_clip_state.id, old_clip_state, new_clip_state, "Move clip in viewport"));
     }
 
+    run_script_jobs();
+
     is_playing = transport_controls_.is_playing();
 
     if (transport_controls_.reset_requested()) {
@@ -200,129 +296,200 @@ void MainWindow::render() {
     if (is_playing && transport_controls_.follow_playhead()) {
         timeline_.ensure_playhead_visible();
     }
+
+    bool idle = !is_playing && !is_seeking && !timeline_.is_dragging_clip();
+    ScriptGcStats gc = script_engine_.collect_garbage(SCRIPT_GC_BUDGET_MS, idle);
+    profiler_.set_script_gc_stats(static_cast<float>(gc.collect_ms), gc.heap_bytes);
+    profiler_.set_effect_timings(script_engine_.take_effect_timings());
 }
 
-void MainWindow::sync_video_to_playhead() {
+bool MainWindow::resolve_active_clips() {
     double current_beats = timeline_.playhead_position();
+    const Tempo& tempo = project_.tempo();
+
+    SyncInputs inputs;
+    inputs.playhead_beats = current_beats;
+    inputs.timeline_generation = timeline_data_.generation();
+    inputs.tempo_generation = tempo.generation();
+    inputs.effects_generation = effects_generation_;
+    inputs.dragging = timeline_.is_dragging_clip();
+    bool inputs_changed = inputs != sync_inputs_;
+    sync_inputs_ = inputs;
+
+    // Clips come back in the same order while the timeline is unchanged, so
+    // a clip's previous state sits at the same position.
+    previous_clips_.swap(resolved_clips_);
+    resolved_clips_.clear();
+    pending_clips_.clear();
+    effect_jobs_.clear();
+
+    std::vector<TimelineClip*> clips = timeline_data_.clips_at_beat(current_beats);
+    bool changed = inputs_changed || clips.size() != previous_clips_.size();
+    for (size_t i = 0; i < clips.size(); ++i) {
+        TimelineClip* clip = clips[i];
+        uint64_t fingerprint = clip_fingerprint(*clip, pattern_library_, source_library_.find_source(*clip));
+
+        if (!inputs_changed && i < previous_clips_.size() && previous_clips_[i].clip == clip &&
+            previous_clips_[i].fingerprint == fingerprint) {
+            resolved_clips_.push_back(previous_clips_[i]);
+            continue;
+        }
+        changed = true;
 
-    auto active_clips = timeline_data_.clips_at_beat(current_beats);
+        ResolvedClipState state;
+        state.clip = clip;
+        state.clip_handle = timeline_data_.handle_of(*clip);
+        state.source_handle = source_library_.source_handle(*clip);
+        state.clip_local_beats = current_beats - clip->start_beat;
+        state.fingerprint = fingerprint;
 
-    viewport_.clear_transform_overrides();
+        if (!clip->effects.empty()) {
+            EffectJob job;
+            job.effects = &clip->effects;
+            job.context.clip = clip;
+            job.context.tempo = &tempo;
+            job.context.current_beats = current_beats;
+            job.context.clip_local_beats = state.clip_local_beats;
+            effect_jobs_.push_back(job);
+        }
 
-    std::vector<const TimelineClip*> const_clips;
-    for (TimelineClip* clip : active_clips) {
-        double clip_local_beats = current_beats - clip->start_beat;
-
-        PatternEvaluationResult pattern_result = pattern_evaluator_.evaluate(*clip, clip_local_beats);
-
-        const std::vector<ClipEffect>& effects = clip->effects;
-
-        if (!effects.empty()) {
-            EffectContext context;
-            context.clip = clip;
-            context.tempo = &project_.tempo();
-            context.current_beats = current_beats;
-            context.clip_local_beats = clip_local_beats;
-
-            EffectResult result = script_engine_.evaluate_effects(effects, context);
-
-            ClipTransformOverride override;
-            override.position_x = result.position_x.has_value() ? result.position_x : pattern_result.position_x;
-            override.position_y = result.position_y.has_value() ? result.position_y : pattern_result.position_y;
-            override.scale_x = result.scale_x.has_value() ? result.scale_x : pattern_result.scale_x;
-            override.scale_y = result.scale_y.has_value() ? result.scale_y : pattern_result.scale_y;
-            override.rotation = result.rotation.has_value() ? result.rotation : pattern_result.rotation;
-            override.flip_h = pattern_result.flip_h;
-            override.flip_v = pattern_result.flip_v;
-
-            if (override.scale_x.has_value() || override.scale_y.has_value() ||
-                override.rotation.has_value() || override.position_x.has_value() ||
-                override.position_y.has_value() || override.flip_h.has_value() ||
-                override.flip_v.has_value()) {
-                viewport_.set_clip_transform_override(clip->id, override);
-            }
+        pending_clips_.push_back(resolved_clips_.size());
+        resolved_clips_.push_back(std::move(state));
+    }
 
-            if (result.use_looped_frame) {
-                video_engine_.request_looped_frame(clip->id, clip->source_id,
-                                                   result.loop_start_seconds,
-                                                   result.loop_duration_seconds,
-                                                   result.position_in_loop_seconds);
-            } else if (pattern_result.use_looped_playback) {
-                double loop_start = clip->source_start_seconds;
-                double loop_duration = project_.tempo().beats_to_time(pattern_result.loop_duration_beats);
-                double position_in_loop = project_.tempo().beats_to_time(pattern_result.position_in_loop_beats);
-                video_engine_.request_looped_frame(clip->id, clip->source_id,
-                                                   loop_start, loop_duration, position_in_loop);
-            } else {
-                double clip_local_seconds = project_.tempo().beats_to_time(clip_local_beats);
-                clip_local_seconds += clip->source_start_seconds;
+    if (!changed) {
+        profiler_.set_script_stats(0.0f, 0);
+        return false;
+    }
 
-                double source_duration = video_engine_.get_source_duration(clip->source_id);
-                if (source_duration > 0.0 && clip_local_seconds >= source_duration) {
-                    clip_local_seconds = source_duration - 0.001;
-                }
+    auto script_start = std::chrono::steady_clock::now();
+    script_engine_.evaluate_effects_batch(effect_jobs_, effect_results_);
+    auto script_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - script_start);
+    profiler_.set_script_stats(script_ms.count(), static_cast<uint32_t>(effect_jobs_.size()));
+
+    size_t next_effect_result = 0;
+    for (size_t index : pending_clips_) {
+        ResolvedClipState& state = resolved_clips_[index];
+        const TimelineClip* clip = state.clip;
+        PatternEvaluationResult pattern_result = pattern_evaluator_.evaluate(*clip, state.clip_local_beats);
+
+        ClipTransformOverride override;
+        override.position_x = pattern_result.position_x;
+        override.position_y = pattern_result.position_y;
+        override.scale_x = pattern_result.scale_x;
+        override.scale_y = pattern_result.scale_y;
+        override.rotation = pattern_result.rotation;
+        override.flip_h = pattern_result.flip_h;
+        override.flip_v = pattern_result.flip_v;
 
-                video_engine_.request_frame(clip->id, clip->source_id, clip_local_seconds);
+        if (pattern_result.use_looped_playback) {
+            state.use_looped_frame = true;
+            state.loop_start_seconds = clip->source_start_seconds;
+            state.loop_duration_seconds = tempo.beats_to_time(pattern_result.loop_duration_beats);
+            state.position_in_loop_seconds = tempo.beats_to_time(pattern_result.position_in_loop_beats);
+
+            state.use_looped_audio = true;
+            state.audio_loop_start_seconds = state.loop_start_seconds;
+            state.audio_loop_duration_seconds = state.loop_duration_seconds;
+        }
+
+        if (!clip->effects.empty()) {
+            const EffectResult& result = effect_results_[next_effect_result++];
+
+            if (result.position_x.has_value()) override.position_x = result.position_x;
+            if (result.position_y.has_value()) override.position_y = result.position_y;
+            if (result.scale_x.has_value()) override.scale_x = result.scale_x;
+            if (result.scale_y.has_value()) override.scale_y = result.scale_y;
+            if (result.rotation.has_value()) override.rotation = result.rotation;
+
+            if (result.use_looped_frame) {
+                state.use_looped_frame = true;
+                state.loop_start_seconds = result.loop_start_seconds;
+                state.loop_duration_seconds = result.loop_duration_seconds;
+                state.position_in_loop_seconds = result.position_in_loop_seconds;
             }
-        } else {
-            if (pattern_result.scale_x.has_value() || pattern_result.scale_y.has_value() ||
-                pattern_result.rotation.has_value() || pattern_result.position_x.has_value() ||
-                pattern_result.position_y.has_value() || pattern_result.flip_h.has_value() ||
-                pattern_result.flip_v.has_value()) {
-                ClipTransformOverride override;
-                override.position_x = pattern_result.position_x;
-                override.position_y = pattern_result.position_y;
-                override.scale_x = pattern_result.scale_x;
-                override.scale_y = pattern_result.scale_y;
-                override.rotation = pattern_result.rotation;
-                override.flip_h = pattern_result.flip_h;
-                override.flip_v = pattern_result.flip_v;
-                viewport_.set_clip_transform_override(clip->id, override);
+
+            if (result.use_looped_audio && result.audio_loop_duration_seconds > 0.0) {
+                state.use_looped_audio = true;
+                state.audio_loop_start_seconds = result.audio_loop_start_seconds;
+                state.audio_loop_duration_seconds = result.audio_loop_duration_seconds;
             }
+        }
 
-            if (pattern_result.use_looped_playback) {
-                double loop_start = clip->source_start_seconds;
-                double loop_duration = project_.tempo().beats_to_time(pattern_result.loop_duration_beats);
-                double position_in_loop = project_.tempo().beats_to_time(pattern_result.position_in_loop_beats);
-                video_engine_.request_looped_frame(clip->id, clip->source_id,
-                                                   loop_start, loop_duration, position_in_loop);
-            } else {
-                double clip_local_seconds = project_.tempo().beats_to_time(clip_local_beats);
-                clip_local_seconds += clip->source_start_seconds;
+        if (override.scale_x.has_value() || override.scale_y.has_value() ||
+            override.rotation.has_value() || override.position_x.has_value() ||
+            override.position_y.has_value() || override.flip_h.has_value() ||
+            override.flip_v.has_value()) {
+            state.transform = override;
+        }
+    }
+    return true;
+}
 
-                double source_duration = video_engine_.get_source_duration(clip->source_id);
-                if (source_duration > 0.0 && clip_local_seconds >= source_duration) {
-                    clip_local_seconds = source_duration - 0.001;
-                }
+void MainWindow::sync_video_to_playhead() {
+    PreviewFrame frame;
+    frame.width = project_.width();
+    frame.height = project_.height();
+    preview_width_ = frame.width;
+    preview_height_ = frame.height;
 
-                video_engine_.request_frame(clip->id, clip->source_id, clip_local_seconds);
-            }
+    std::vector<const TimelineClip*> const_clips;
+    for (const ResolvedClipState& state : resolved_clips_) {
+        const TimelineClip* clip = state.clip;
+
+        PreviewClip preview;
+        preview.clip_handle = state.clip_handle;
+        preview.source_handle = state.source_handle;
+        preview.placement.position_x = clip->position_x;
+        preview.placement.position_y = clip->position_y;
+        preview.placement.scale_x = clip->scale_x;
+        preview.placement.scale_y = clip->scale_y;
+        preview.placement.rotation = clip->rotation;
+
+        if (state.transform) {
+            const ClipTransformOverride& ovr = *state.transform;
+            if (ovr.scale_x.has_value()) preview.placement.scale_x = ovr.scale_x.value();
+            if (ovr.scale_y.has_value()) preview.placement.scale_y = ovr.scale_y.value();
+            if (ovr.rotation.has_value()) preview.placement.rotation = ovr.rotation.value();
+            if (ovr.position_x.has_value()) preview.placement.position_x = ovr.position_x.value();
+            if (ovr.position_y.has_value()) preview.placement.position_y = ovr.position_y.value();
+            if (ovr.flip_h.has_value()) preview.placement.flip_h = ovr.flip_h.value();
+            if (ovr.flip_v.has_value()) preview.placement.flip_v = ovr.flip_v.value();
+        }
+
+        if (state.use_looped_frame) {
+            preview.looped = true;
+            preview.loop_start_seconds = state.loop_start_seconds;
+            preview.loop_duration_seconds = state.loop_duration_seconds;
+            preview.position_in_loop_seconds = state.position_in_loop_seconds;
+        } else {
+            preview.source_seconds = project_.tempo().beats_to_time(state.clip_local_beats) +
+                                     clip->source_start_seconds;
         }
 
+        frame.clips.push_back(preview);
         const_clips.push_back(clip);
     }
 
+    render_thread_.submit(std::move(frame));
     viewport_.set_active_clips(const_clips);
-    viewport_.set_selected_clip_id(timeline_.selected_clip_id());
 }
 
 void MainWindow::sync_audio_to_playhead() {
-    double current_beats = timeline_.playhead_position();
     uint32_t sample_rate = audio_engine_.sample_rate();
 
-    auto active_clips = timeline_data_.clips_at_beat(current_beats);
-
     std::vector<ClipAudioState> audio_clips;
 
-    for (TimelineClip* clip : active_clips) {
-        const MediaSource* source = source_library_.find_source(clip->source_id);
+    for (const ResolvedClipState& state : resolved_clips_) {
+        const TimelineClip* clip = state.clip;
+        const MediaSource* source = source_library_.find_source(*clip);
         if (!source || !source->has_audio()) {
             continue;
         }
 
         double clip_start_seconds = project_.tempo().beats_to_time(clip->start_beat);
         double clip_duration_seconds = project_.tempo().beats_to_time(clip->duration_beats);
-        double clip_local_beats = current_beats - clip->start_beat;
+        uint32_t source_rate = source->audio_buffer->sample_rate();
 
         ClipAudioState audio_state;
         audio_state.buffer = source->audio_buffer;
@@ -330,35 +497,14 @@ void MainWindow::sync_audio_to_playhead() {
         audio_state.duration_frames = static_cast<int64_t>(clip_duration_seconds * sample_rate);
         audio_state.volume = 1.0f;
 
-        PatternEvaluationResult pattern_result = pattern_evaluator_.evaluate(*clip, clip_local_beats);
-
-        if (pattern_result.use_looped_playback) {
-            double loop_start_seconds = clip->source_start_seconds;
-            double loop_duration_seconds = project_.tempo().beats_to_time(pattern_result.loop_duration_beats);
-
+        if (state.use_looped_audio) {
             audio_state.use_looped_audio = true;
-            audio_state.loop_start_frames = static_cast<int64_t>(loop_start_seconds * source->audio_buffer->sample_rate());
-            audio_state.loop_duration_frames = static_cast<int64_t>(loop_duration_seconds * source->audio_buffer->sample_rate());
+            audio_state.loop_start_frames = static_cast<int64_t>(state.audio_loop_start_seconds * source_rate);
+            audio_state.loop_duration_frames = static_cast<int64_t>(state.audio_loop_duration_seconds * source_rate);
             audio_state.loop_phase_offset_frames = 0;
             audio_state.source_offset_frames = 0;
         } else {
-            audio_state.source_offset_frames = static_cast<int64_t>(clip->source_start_seconds * source->audio_buffer->sample_rate());
-        }
-
-        if (!clip->effects.empty()) {
-            EffectContext context;
-            context.clip = clip;
-            context.tempo = &project_.tempo();
-            context.current_beats = current_beats;
-            context.clip_local_beats = clip_local_beats;
-
-            EffectResult result = script_engine_.evaluate_effects(clip->effects, context);
-
-            if (result.use_looped_audio && result.audio_loop_duration_seconds > 0.0) {
-                audio_state.use_looped_audio = true;
-                audio_state.loop_start_frames = static_cast<int64_t>(result.audio_loop_start_seconds * source->audio_buffer->sample_rate());
-                audio_state.loop_duration_frames = static_cast<int64_t>(result.audio_loop_duration_seconds * source->audio_buffer->sample_rate());
-            }
+            audio_state.source_offset_frames = static_cast<int64_t>(clip->source_start_seconds * source_rate);
         }
 
         audio_clips.push_back(std::move(audio_state));
@@ -413,6 +559,7 @@ void MainWindow::build_default_layout(ImGuiID dockspace_id) {
     ImGui::DockBuilderDockWindow("Audio", dock_right);
     ImGui::DockBuilderDockWindow("Clip", dock_right);
     ImGui::DockBuilderDockWindow("Patterns", dock_right);
+    ImGui::DockBuilderDockWindow("Scripts", dock_right);
     ImGui::DockBuilderDockWindow("Profiler", dock_right);
     ImGui::DockBuilderDockWindow("Project", dock_right);
 
@@ -431,6 +578,11 @@ VideoEngine& MainWindow::video_engine() {
     return video_engine_;
 }
 
+bool MainWindow::start_render_thread(GLFWwindow* context) {
+    render_thread_.set_fps(project_.fps());
+    return render_thread_.start(context);
+}
+
 SourceLibrary& MainWindow::source_library() {
     return source_library_;
 }
@@ -462,12 +614,14 @@ bool MainWindow::load_audio_file(const std::string& filepath) {
 std::string MainWindow::import_source(const std::string& filepath) {
     std::string source_id = source_library_.add_source(filepath);
 
-    if (MediaSource* source = source_library_.find_source(source_id)) {
-        video_engine_.register_source(*source);
+    SourceHandle handle = source_library_.handle_of(source_id);
+    if (MediaSource* source = source_library_.find_source(handle)) {
+        auto engine_lock = render_thread_.lock_engine();
+        video_engine_.register_source(handle, *source);
 
         if (source->type == MediaType::Video) {
-            source->duration_seconds = video_engine_.get_source_duration(source_id);
-            source->fps = video_engine_.get_source_fps(source_id);
+            source->duration_seconds = video_engine_.get_source_duration(handle);
+            source->fps = video_engine_.get_source_fps(handle);
         }
         dirty_ = true;
     }
@@ -523,7 +677,11 @@ void MainWindow::render_sources_panel() {
             clip.track_index = available_track;
 
             execute_command(std::make_unique<AddClipCommand>(timeline_data_, clip));
-            video_engine_.prefetch_clip(clip.id, clip.source_id, clip.source_start_seconds);
+            render_thread_.post([clip_handle = timeline_data_.handle_of(clip),
+                                 source_handle = source_library_.handle_of(source.id),
+                                 start = clip.source_start_seconds](VideoEngine& engine) {
+                engine.prefetch_clip(clip_handle, source_handle, start);
+            });
         }
         ImGui::SameLine();
         if (ImGui::SmallButton("X")) {
@@ -531,7 +689,9 @@ void MainWindow::render_sources_panel() {
                 pending_source_removal_ = source.id;
                 open_remove_popup = true;
             } else {
-                video_engine_.unregister_source(source.id);
+                render_thread_.post([handle = source_library_.handle_of(source.id)](VideoEngine& engine) {
+                    engine.unregister_source(handle);
+                });
                 source_library_.remove_source(source.id);
                 dirty_ = true;
             }
@@ -553,7 +713,9 @@ void MainWindow::render_sources_panel() {
 
         if (ImGui::Button("Yes, Remove")) {
             timeline_data_.remove_clips_by_source(pending_source_removal_);
-            video_engine_.unregister_source(pending_source_removal_);
+            render_thread_.post([handle = source_library_.handle_of(pending_source_removal_)](VideoEngine& engine) {
+                engine.unregister_source(handle);
+            });
             source_library_.remove_source(pending_source_removal_);
             pending_source_removal_.clear();
             dirty_ = true;
@@ -594,7 +756,7 @@ void MainWindow::render_effects_panel() {
         return;
     }
 
-    const MediaSource* source = source_library_.find_source(clip->source_id);
+    const MediaSource* source = source_library_.find_source(*clip);
     if (source) {
         ImGui::Text("Clip: %s", source->name.c_str());
     } else {
@@ -710,6 +872,13 @@ void MainWindow::render_effects_panel() {
             bool is_enabled = active_effect != nullptr && active_effect->enabled;
 
             ImGui::Text("%s", effect_info.name.c_str());
+            if (effect_info.slow) {
+                ImGui::SameLine();
+                ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "(slow)");
+                if (ImGui::IsItemHovered()) {
+                    ImGui::SetTooltip("This effect ran over its instruction budget and was cut short");
+                }
+            }
 
             bool was_enabled = is_enabled;
             if (ImGui::Checkbox("Enabled", &is_enabled)) {
@@ -745,7 +914,9 @@ void MainWindow::render_effects_panel() {
                     active_effect = nullptr;
 
                     if (source && source->duration_seconds > 0) {
-                        clip->duration_beats = project_.tempo().time_to_beats(source->duration_seconds);
+                        timeline_data_.set_clip_span(clip->id, clip->start_beat,
+                                                     project_.tempo().time_to_beats(source->duration_seconds),
+                                                     clip->track_index);
                     }
                     execute_command(std::make_unique<ModifyClipCommand>(
                         timeline_data_, clip->id, old_state, *clip, "Disable effect"));
@@ -844,7 +1015,7 @@ void MainWindow::render_effects_panel() {
         } else {
             for (size_t i = 0; i < clip->patterns.size(); ++i) {
                 auto& ref = clip->patterns[i];
-                const Pattern* pattern = pattern_library_.find_pattern(ref.pattern_id);
+                const Pattern* pattern = pattern_library_.find_pattern(ref);
                 if (!pattern) continue;
 
                 ImGui::PushID(static_cast<int>(i));
@@ -911,6 +1082,60 @@ void MainWindow::render_effects_panel() {
     ImGui::End();
 }
 
+void MainWindow::render_scripts_panel() {
+    ImGui::Begin("Scripts");
+
+    if (script_jobs_.is_running()) {
+        ImGui::Text("Running: %s", script_jobs_.job_name().c_str());
+        ImGui::ProgressBar(static_cast<float>(script_jobs_.progress()), ImVec2(-1.0f, 0.0f));
+        ImGui::Text("%zu edits staged", script_jobs_.staged_edits());
+        if (ImGui::Button("Cancel")) {
+            script_jobs_.cancel();
+        }
+        ImGui::End();
+        return;
+    }
+
+    if (ImGui::Button("Refresh")) {
+        job_scripts_ = script_jobs_.job_scripts();
+    }
+    ImGui::Separator();
+
+    if (job_scripts_.empty()) {
+        ImGui::TextDisabled("No scripts in scripts/jobs");
+    }
+    for (const auto& path : job_scripts_) {
+        ImGui::PushID(path.c_str());
+        std::string label = std::filesystem::path(path).stem().string();
+        if (ImGui::Button(label.c_str())) {
+            ScriptJobContext context;
+            context.playhead_beats = timeline_.playhead_position();
+            context.selected_clip_id = timeline_.selected_clip_id();
+            script_jobs_.start(path, context);
+        }
+        ImGui::PopID();
+    }
+
+    if (script_jobs_.status() == ScriptJobStatus::Failed) {
+        ImGui::Separator();
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.3f, 1.0f), "Script failed:");
+        ImGui::TextWrapped("%s", script_jobs_.last_error().c_str());
+    }
+
+    ImGui::End();
+}
+
+// A job's edits reach the timeline only once it finishes, as a single
+// command, so a long job never leaves half its clips on the undo stack.
+void MainWindow::run_script_jobs() {
+    if (!script_jobs_.is_running()) return;
+
+    script_jobs_.resume(SCRIPT_JOB_BUDGET_MS);
+    if (auto cmd = script_jobs_.take_command()) {
+        execute_command(std::move(cmd));
+    }
+}
+
 void MainWindow::render_audio_panel() {
     ImGui::Begin("Audio");
 
@@ -987,6 +1212,29 @@ void MainWindow::render_audio_panel() {
         }
     }
 
+    ImGui::Separator();
+    ImGui::Text("Source Audio Storage");
+
+    constexpr const char* format_labels[] = {"32-bit float", "16-bit integer", "16-bit float"};
+    int format_index = static_cast<int>(source_library_.sample_format());
+    ImGui::SetNextItemWidth(150.0f);
+    if (ImGui::Combo("##sample_format", &format_index, format_labels, IM_ARRAYSIZE(format_labels))) {
+        source_library_.set_sample_format(static_cast<SampleFormat>(format_index));
+        dirty_ = true;
+    }
+    if (source_library_.reencoding()) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("Re-encoding...");
+    }
+
+    size_t source_audio_bytes = 0;
+    for (const auto& source : source_library_.sources()) {
+        if (source.audio_buffer) {
+            source_audio_bytes += source.audio_buffer->size_bytes();
+        }
+    }
+    ImGui::Text("Source audio: %.1f MB", static_cast<double>(source_audio_bytes) / (1024.0 * 1024.0));
+
     ImGui::End();
 }
 
@@ -997,6 +1245,8 @@ bool MainWindow::save_project(const std::string& filepath) {
     data.bpm = project_.tempo().bpm();
     data.grid_subdivision = project_.grid_subdivision();
     data.fps = project_.fps();
+    data.output_width = project_.width();
+    data.output_height = project_.height();
     data.metronome_enabled = transport_controls_.metronome_enabled();
     data.follow_playhead = transport_controls_.follow_playhead();
     data.loop_enabled = transport_controls_.loop_enabled();
@@ -1012,6 +1262,7 @@ bool MainWindow::save_project(const std::string& filepath) {
         data.clip_end_seconds = audio_engine_.clip_end_seconds();
     }
 
+    data.audio_sample_format = source_library_.sample_format();
     data.sources = source_library_.sources();
     data.tracks = timeline_data_.tracks();
     data.clips = timeline_data_.clips();
@@ -1044,6 +1295,7 @@ bool MainWindow::load_project(const std::string& filepath) {
     project_.tempo().set_bpm(data.bpm);
     project_.set_grid_subdivision(data.grid_subdivision);
     project_.set_fps(data.fps);
+    project_.set_resolution(data.output_width, data.output_height);
     transport_controls_.set_metronome_enabled(data.metronome_enabled);
     transport_controls_.set_follow_playhead(data.follow_playhead);
     transport_controls_.set_loop_enabled(data.loop_enabled);
@@ -1058,9 +1310,26 @@ bool MainWindow::load_project(const std::string& filepath) {
     }
 
     source_library_.clear();
-    for (const auto& source : data.sources) {
-        source_library_.add_source_direct(source);
-        video_engine_.register_source(source);
+    source_library_.set_sample_format(data.audio_sample_format);
+    {
+        auto engine_lock = render_thread_.lock_engine();
+        for (const auto& source : data.sources) {
+            source_library_.add_source_direct(source);
+            video_engine_.register_source(source_library_.handle_of(source.id), source);
+        }
+    }
+    // Handles were reissued, so the previous project's sources no longer
+    // match any of them and can release their decoders.
+    {
+        std::vector<SourceHandle> live;
+        for (const auto& source : source_library_.sources()) {
+            live.push_back(source_library_.handle_of(source.id));
+        }
+        render_thread_.post([live = std::move(live)](VideoEngine& engine) {
+            engine.retain_sources([&live](SourceHandle handle) {
+                return std::ranges::find(live, handle) != live.end();
+            });
+        });
     }
 
     timeline_data_.clear_all();
@@ -1075,6 +1344,7 @@ bool MainWindow::load_project(const std::string& filepath) {
     for (const auto& pattern : data.patterns) {
         pattern_library_.add_pattern(pattern);
     }
+    automation_baker_.clear();
 
     timeline_.set_playhead_position(data.playhead_beat);
     timeline_.set_zoom(data.timeline_zoom);
@@ -1101,12 +1371,14 @@ bool MainWindow::load_project(const std::string& filepath) {
     current_project_path_ = filepath;
     transport_controls_.set_current_project_path(filepath);
     command_history_.clear();
+    script_jobs_.cancel();
     dirty_ = false;
     return true;
 }
 
 bool MainWindow::needs_continuous_rendering() const {
-    return transport_controls_.is_playing() || audio_engine_.is_playing();
+    return transport_controls_.is_playing() || audio_engine_.is_playing() || script_jobs_.is_running() ||
+           cache_building_;
 }
 
 std::string MainWindow::window_title() const {
@@ -1132,31 +1404,14 @@ void MainWindow::mark_dirty() {
 
 void MainWindow::cache_all_clips() {
     for (const auto& clip : timeline_data_.clips()) {
-        if (!clip.effects.empty()) {
-            EffectContext context;
-            context.clip = &clip;
-            context.tempo = &project_.tempo();
-            context.current_beats = clip.start_beat;
-            context.clip_local_beats = 0.0;
-
-            EffectResult result = script_engine_.evaluate_effects(clip.effects, context);
-
-            if (result.use_looped_frame && !video_engine_.is_loop_cache_complete(clip.id)) {
-                video_engine_.prebuild_loop_cache(clip.id, clip.source_id,
-                                                   result.loop_start_seconds,
-                                                   result.loop_duration_seconds);
-            }
-        }
-
-        if (!video_engine_.is_clip_cached(clip.id)) {
-            video_engine_.prefetch_clip(clip.id, clip.source_id, clip.source_start_seconds);
-        }
+        cache_clip(clip);
     }
 }
 
 void MainWindow::start_cache_building() {
     cache_total_clips_ = timeline_data_.clips().size();
     cache_current_clip_ = 0;
+    cache_finished_clips_ = std::make_shared<std::atomic<size_t>>(0);
     cache_building_ = cache_total_clips_ > 0;
 }
 
@@ -1165,9 +1420,18 @@ bool MainWindow::cache_next_clip() {
         return false;
     }
 
-    const auto& clips = timeline_data_.clips();
-    const auto& clip = clips[cache_current_clip_];
+    cache_clip(timeline_data_.clips()[cache_current_clip_]);
+
+    ++cache_current_clip_;
+    return cache_current_clip_ < cache_total_clips_;
+}
+
+void MainWindow::cache_clip(const TimelineClip& clip) {
+    ClipHandle clip_handle = timeline_data_.handle_of(clip);
+    SourceHandle source_handle = source_library_.source_handle(clip);
 
+    // Effects run here; the decoding is queued for the render thread.
+    EffectResult result;
     if (!clip.effects.empty()) {
         EffectContext context;
         context.clip = &clip;
@@ -1175,21 +1439,25 @@ bool MainWindow::cache_next_clip() {
         context.current_beats = clip.start_beat;
         context.clip_local_beats = 0.0;
 
-        EffectResult result = script_engine_.evaluate_effects(clip.effects, context);
-
-        if (result.use_looped_frame && !video_engine_.is_loop_cache_complete(clip.id)) {
-            video_engine_.prebuild_loop_cache(clip.id, clip.source_id,
-                                               result.loop_start_seconds,
-                                               result.loop_duration_seconds);
-        }
-    }
-
-    if (!video_engine_.is_clip_cached(clip.id)) {
-        video_engine_.prefetch_clip(clip.id, clip.source_id, clip.source_start_seconds);
+        result = script_engine_.evaluate_effects(clip.effects, context);
     }
 
-    ++cache_current_clip_;
-    return cache_current_clip_ < cache_total_clips_;
+    render_thread_.post_steps([clip_handle, source_handle, result, start = clip.source_start_seconds,
+                               finished = cache_finished_clips_](VideoEngine& engine) {
+        bool done = true;
+        if (result.use_looped_frame) {
+            done = engine.prebuild_loop_cache(clip_handle, source_handle,
+                                              result.loop_start_seconds,
+                                              result.loop_duration_seconds,
+                                              CACHE_FRAMES_PER_STEP);
+        } else if (!engine.is_clip_cached(clip_handle)) {
+            engine.prefetch_clip(clip_handle, source_handle, start);
+        }
+        if (done && finished) {
+            ++*finished;
+        }
+        return done;
+    });
 }
 
 void MainWindow::render_loading_modal() {
@@ -1205,13 +1473,14 @@ void MainWindow::render_loading_modal() {
         ImGui::Text("Building clip caches...");
         ImGui::Spacing();
 
+        size_t finished = cache_finished_clips_ ? cache_finished_clips_->load() : 0;
         float progress = cache_total_clips_ > 0
-            ? static_cast<float>(cache_current_clip_) / static_cast<float>(cache_total_clips_)
+            ? static_cast<float>(finished) / static_cast<float>(cache_total_clips_)
             : 0.0f;
 
         ImGui::ProgressBar(progress, ImVec2(-1, 0));
 
-        ImGui::Text("%zu / %zu clips", cache_current_clip_, cache_total_clips_);
+        ImGui::Text("%zu / %zu clips", finished, cache_total_clips_);
 
         ImGui::EndPopup();
     }
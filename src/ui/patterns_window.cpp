@@ -361,10 +361,14 @@ void PatternsWindow::render_grid(Pattern& pattern) {
                 float normalized = 1.0f - (rel_y / canvas_size.y);
                 normalized = std::clamp(normalized, 0.0f, 1.0f);
 
-                if (!editing_) {
-                    begin_edit(pattern);
+                float value = denormalize_value(normalized, current_property_);
+                if (value != trigger.value) {
+                    if (!editing_) {
+                        begin_edit(pattern);
+                    }
+                    trigger.value = value;
+                    library_->mark_pattern_modified(pattern.id);
                 }
-                trigger.value = denormalize_value(normalized, current_property_);
             }
         }
     }
@@ -396,6 +400,7 @@ void PatternsWindow::render_trigger_properties(Pattern& pattern) {
         if (!editing_) {
             begin_edit(pattern);
         }
+        library_->mark_pattern_modified(pattern.id);
     }
     if (ImGui::IsItemDeactivatedAfterEdit()) {
         end_edit(pattern);
@@ -26,6 +26,8 @@ ProfilerWindow::ProfilerWindow() {
     memory_history_.fill(0.0f);
     frame_time_history_.fill(0.0f);
     alloc_history_.fill(0.0f);
+    script_history_.fill(0.0f);
+    script_gc_history_.fill(0.0f);
 }
 
 void ProfilerWindow::update() {
@@ -49,6 +51,10 @@ void ProfilerWindow::sample_metrics() {
     current_memory_mb_ = get_process_memory_mb();
     current_cpu_ = get_cpu_usage();
 
+    if (audio_stats_) {
+        audio_snapshot_ = audio_stats_->snapshot();
+    }
+
     if (current_memory_mb_ > peak_memory_mb_) {
         peak_memory_mb_ = current_memory_mb_;
     }
@@ -57,6 +63,8 @@ void ProfilerWindow::sample_metrics() {
     memory_history_[history_index_] = current_memory_mb_;
     frame_time_history_[history_index_] = current_frame_time_ms_;
     alloc_history_[history_index_] = static_cast<float>(last_frame_allocs_);
+    script_history_[history_index_] = script_ms_;
+    script_gc_history_[history_index_] = script_gc_ms_;
     history_index_ = (history_index_ + 1) % HISTORY_SIZE;
 
     float sum = 0.0f;
@@ -111,6 +119,33 @@ float ProfilerWindow::get_cpu_usage() {
     return 0.0f;
 }
 
+void ProfilerWindow::render_audio_stats() {
+    const auto& audio = audio_snapshot_;
+    if (!audio_stats_ || audio.history_count == 0) {
+        ImGui::Text("Audio Callback: no data");
+        return;
+    }
+
+    ImGui::Text("DSP Load: %.1f%% (period %.2f ms)", audio.last_load * 100.0f, audio.period_us / 1000.0f);
+    ImGui::Text("Callback: p50 %.0f us, p99 %.0f us, max %.0f us",
+                audio.p50_us, audio.p99_us, audio.max_us);
+    ImGui::Text("Late: %llu  Xruns: %llu  Clips: %u",
+                static_cast<unsigned long long>(audio.late_callbacks),
+                static_cast<unsigned long long>(audio.xruns),
+                audio.active_clips);
+
+    std::array<float, AudioCallbackStats::CAPACITY> load_percent;
+    float max_load = 100.0f;
+    for (size_t i = 0; i < audio.history_count; ++i) {
+        load_percent[i] = audio.load_history[i] * 100.0f;
+        max_load = std::max(max_load, load_percent[i]);
+    }
+
+    ImGui::PlotLines("##dsp_load", load_percent.data(), static_cast<int>(audio.history_count),
+                     0, "DSP Load %", 0.0f, max_load,
+                     ImVec2(ImGui::GetContentRegionAvail().x, 50));
+}
+
 void ProfilerWindow::render() {
     if (!visible_) return;
 
@@ -118,6 +153,7 @@ void ProfilerWindow::render() {
     ImGui::Begin("Profiler", &visible_, ImGuiWindowFlags_NoCollapse);
 
     ImGui::Text("Video Decoder: %s", video_decoder_info_.c_str());
+    ImGui::Text("Preview Render: %.2f ms, %d draw calls (render thread)", preview_render_ms_, preview_draw_calls_);
     ImGui::Separator();
 
     ImGui::Text("Frame Time: %.2f ms (%.1f FPS)",
@@ -164,6 +200,57 @@ void ProfilerWindow::render() {
 
     ImGui::Separator();
 
+    ImGui::Text("Scripts: %.2f ms/frame (%u effect calls)", script_ms_, script_calls_);
+
+    {
+        std::array<float, HISTORY_SIZE> ordered;
+        for (size_t i = 0; i < HISTORY_SIZE; ++i) {
+            ordered[i] = script_history_[(history_index_ + i) % HISTORY_SIZE];
+        }
+        float max_script = *std::max_element(ordered.begin(), ordered.end());
+        max_script = std::max(max_script, 1.0f);
+
+        ImGui::PlotLines("##scripts", ordered.data(), static_cast<int>(HISTORY_SIZE),
+                         0, "Script ms/frame", 0.0f, max_script * 1.2f,
+                         ImVec2(ImGui::GetContentRegionAvail().x, 50));
+    }
+
+    constexpr size_t MAX_LISTED_EFFECTS = 5;
+    for (size_t i = 0; i < std::min(effect_timings_.size(), MAX_LISTED_EFFECTS); ++i) {
+        const EffectTiming& timing = effect_timings_[i];
+        ImGui::Text("  %s: %.2f ms (%u calls)", timing.effect_id.c_str(), timing.total_ms, timing.calls);
+        if (timing.memo_hits > 0) {
+            ImGui::SameLine();
+            ImGui::TextDisabled("%u cached", timing.memo_hits);
+        }
+        if (timing.aborted > 0) {
+            ImGui::SameLine();
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.3f, 1.0f), "%u aborted", timing.aborted);
+        }
+    }
+
+    ImGui::Text("Lua GC: %.2f ms/frame (heap %.1f KB)",
+                script_gc_ms_, static_cast<float>(script_heap_bytes_) / 1024.0f);
+
+    {
+        std::array<float, HISTORY_SIZE> ordered;
+        for (size_t i = 0; i < HISTORY_SIZE; ++i) {
+            ordered[i] = script_gc_history_[(history_index_ + i) % HISTORY_SIZE];
+        }
+        float max_gc = *std::max_element(ordered.begin(), ordered.end());
+        max_gc = std::max(max_gc, 0.5f);
+
+        ImGui::PlotLines("##script_gc", ordered.data(), static_cast<int>(HISTORY_SIZE),
+                         0, "Lua GC ms/frame", 0.0f, max_gc * 1.2f,
+                         ImVec2(ImGui::GetContentRegionAvail().x, 50));
+    }
+
+    ImGui::Separator();
+
+    render_audio_stats();
+
+    ImGui::Separator();
+
     ImGui::Text("CPU Usage: %.1f%%", current_cpu_);
     {
         std::array<float, HISTORY_SIZE> ordered;
@@ -480,6 +480,11 @@ void Timeline::render_clips(ImVec2 canvas_pos, float canvas_width, float canvas_
     float track_height = TRACK_HEIGHT * zoom_y_;
     float track_stride = track_height + TRACK_SPACING;
 
+    if (automation_baker_) {
+        automation_baker_->bake_range(scroll_offset_ / pixels_per_beat,
+                                      (scroll_offset_ + canvas_width) / pixels_per_beat);
+    }
+
     for (const auto& clip : timeline_data_->clips()) {
         float track_y = canvas_pos.y + static_cast<float>(clip.track_index) * track_stride - scroll_offset_y_;
 
@@ -517,9 +522,12 @@ void Timeline::render_clips(ImVec2 canvas_pos, float canvas_width, float canvas_
             0.0f, 0, 1.0f
         );
 
+        render_clip_automation(clip, clip_x, clip_end_x, visible_top, visible_bottom,
+                               canvas_pos.x - scroll_offset_);
+
         std::string clip_name = "Clip";
         if (source_library_) {
-            if (const MediaSource* src = source_library_->find_source(clip.source_id)) {
+            if (const MediaSource* src = source_library_->find_source(clip)) {
                 clip_name = src->name;
             }
         }
@@ -540,6 +548,42 @@ void Timeline::render_clips(ImVec2 canvas_pos, float canvas_width, float canvas_
     }
 }
 
+void Timeline::render_clip_automation(const TimelineClip& clip, float clip_x, float clip_end_x,
+                                      float visible_top, float visible_bottom, float origin_x) {
+    if (!automation_baker_) return;
+
+    const BakedClipAutomation* baked = automation_baker_->find(timeline_data_->handle_of(clip));
+    if (!baked) return;
+
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    float pixels_per_sample = 100.0f * zoom_ / AutomationBaker::SUBDIVISIONS_PER_BEAT;
+    float base_x = origin_x + static_cast<float>(baked->start_beat) * 100.0f * zoom_;
+
+    // Restart markers along the bottom edge, looped spans as a strip under them.
+    for (size_t i = 0; i < baked->samples.size(); ++i) {
+        const AutomationSample& sample = baked->samples[i];
+        float x = base_x + static_cast<float>(i) * pixels_per_sample;
+        if (x + pixels_per_sample < clip_x) continue;
+        if (x > clip_end_x) break;
+
+        if (sample.looped) {
+            draw_list->AddRectFilled(
+                ImVec2(std::max(x, clip_x), visible_bottom - 2.0f),
+                ImVec2(std::min(x + pixels_per_sample, clip_end_x), visible_bottom),
+                IM_COL32(240, 200, 80, 160)
+            );
+        }
+        if (sample.restart && x >= clip_x) {
+            draw_list->AddLine(
+                ImVec2(x, std::max(visible_bottom - 8.0f, visible_top)),
+                ImVec2(x, visible_bottom),
+                IM_COL32(255, 255, 255, 200),
+                1.0f
+            );
+        }
+    }
+}
+
 void Timeline::handle_clip_interaction(ImVec2 canvas_pos, float canvas_width, float canvas_height) {
     if (!timeline_data_) return;
 
@@ -581,7 +625,7 @@ void Timeline::handle_clip_interaction(ImVec2 canvas_pos, float canvas_width, fl
         selected_clip_id_.clear();
         drag_mode_ = DragMode::None;
 
-        for (auto& clip : timeline_data_->clips()) {
+        for (const auto& clip : timeline_data_->clips()) {
             float track_y = canvas_pos.y + static_cast<float>(clip.track_index) * track_stride - scroll_offset_y_;
             float clip_x = canvas_pos.x + static_cast<float>(clip.start_beat) * pixels_per_beat - scroll_offset_;
             float clip_w = static_cast<float>(clip.duration_beats) * pixels_per_beat;
@@ -657,12 +701,11 @@ void Timeline::handle_clip_interaction(ImVec2 canvas_pos, float canvas_width, fl
                     if (snap) {
                         new_start = snap_to_grid(new_start, grid);
                     }
-                    clip->start_beat = std::max(0.0, new_start);
-
                     float mouse_y_rel = mouse_pos.y - canvas_pos.y + scroll_offset_y_;
                     size_t new_track = static_cast<size_t>(mouse_y_rel / track_stride);
                     new_track = std::min(new_track, timeline_data_->track_count() - 1);
-                    clip->track_index = new_track;
+                    timeline_data_->set_clip_span(clip->id, std::max(0.0, new_start),
+                                                  clip->duration_beats, new_track);
                     break;
                 }
 
@@ -690,9 +733,9 @@ void Timeline::handle_clip_interaction(ImVec2 canvas_pos, float canvas_width, fl
                         new_start_beat = drag_initial_start_beat_ + max_change_beats;
                     }
 
-                    clip->start_beat = new_start_beat;
-                    clip->duration_beats = end_beat - new_start_beat;
                     clip->source_start_seconds = new_source_start;
+                    timeline_data_->set_clip_span(clip->id, new_start_beat,
+                                                  end_beat - new_start_beat, clip->track_index);
                     break;
                 }
 
@@ -707,7 +750,7 @@ void Timeline::handle_clip_interaction(ImVec2 canvas_pos, float canvas_width, fl
                     new_duration = std::max(MIN_CLIP_DURATION, new_duration);
 
                     if (source_library_) {
-                        if (const MediaSource* source = source_library_->find_source(clip->source_id)) {
+                        if (const MediaSource* source = source_library_->find_source(*clip)) {
                             if (source->type == MediaType::Video && source->duration_seconds > 0.0) {
                                 double remaining_source_seconds = source->duration_seconds - clip->source_start_seconds;
                                 double max_duration_beats = project_.tempo().time_to_beats(remaining_source_seconds);
@@ -716,7 +759,8 @@ void Timeline::handle_clip_interaction(ImVec2 canvas_pos, float canvas_width, fl
                         }
                     }
 
-                    clip->duration_beats = new_duration;
+                    timeline_data_->set_clip_span(clip->id, clip->start_beat, new_duration,
+                                                  clip->track_index);
                     break;
                 }
 
@@ -63,6 +63,21 @@ void TransportControls::render() {
         project_.set_fps(fps_values[fps_current]);
     }
 
+    const char* resolution_options[] = {"1280x720", "1920x1080", "2560x1440", "3840x2160"};
+    const int resolution_widths[] = {1280, 1920, 2560, 3840};
+    const int resolution_heights[] = {720, 1080, 1440, 2160};
+    int resolution_current = 1;
+    for (int i = 0; i < 4; ++i) {
+        if (project_.width() == resolution_widths[i] && project_.height() == resolution_heights[i]) {
+            resolution_current = i;
+            break;
+        }
+    }
+
+    if (ImGui::Combo("Resolution", &resolution_current, resolution_options, 4)) {
+        project_.set_resolution(resolution_widths[resolution_current], resolution_heights[resolution_current]);
+    }
+
     ImGui::Separator();
 
     bool snap = project_.snap_enabled();
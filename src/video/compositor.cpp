@@ -0,0 +1,283 @@
+#include "furious/video/compositor.hpp"
+#include "furious/video/gl_api.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <utility>
+
+namespace furious {
+
+namespace {
+
+// Each instance is one layer: its corners and uvs come from the Layers
+// block and its pixels from the texture unit of the same index.
+constexpr const char* VERTEX_SHADER = R"(#version 330 core
+struct Layer {
+    vec4 corners[2];
+    vec4 uvs[2];
+};
+layout(std140) uniform Layers {
+    Layer u_layers[32];
+};
+uniform vec2 u_target_size;
+out vec2 v_uv;
+flat out int v_layer;
+const int CORNERS[6] = int[6](0, 1, 2, 0, 2, 3);
+vec2 pick(vec4 pairs[2], int i) {
+    vec4 pair = pairs[i / 2];
+    return (i % 2 == 0) ? pair.xy : pair.zw;
+}
+void main() {
+    int corner = CORNERS[gl_VertexID];
+    vec2 ndc = pick(u_layers[gl_InstanceID].corners, corner) / u_target_size * 2.0 - 1.0;
+    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);
+    v_uv = pick(u_layers[gl_InstanceID].uvs, corner);
+    v_layer = gl_InstanceID;
+}
+)";
+
+// Matches the u_layers size above. A batch also needs a texture unit per
+// layer; GL 3.3 guarantees 16 to the fragment stage.
+constexpr int MAX_BATCH = 32;
+constexpr GLuint LAYERS_BINDING = 0;
+
+// GLSL 3.30 only indexes sampler arrays with constants, so each layer
+// gets its own case.
+std::string fragment_shader(int units) {
+    std::string source =
+        "#version 330 core\n"
+        "in vec2 v_uv;\n"
+        "flat in int v_layer;\n"
+        "uniform sampler2D u_textures[" + std::to_string(units) + "];\n"
+        "out vec4 frag_color;\n"
+        "void main() {\n"
+        "    switch (v_layer) {\n";
+    for (int i = 0; i < units; ++i) {
+        std::string unit = std::to_string(i);
+        source += "    case " + unit + ": frag_color = texture(u_textures[" + unit + "], v_uv); break;\n";
+    }
+    source +=
+        "    }\n"
+        "}\n";
+    return source;
+}
+
+// Matches the std140 layout of Layer.
+struct LayerTransform {
+    float corners[8];
+    float uvs[8];
+};
+static_assert(sizeof(LayerTransform) == 64);
+
+// Matches the viewport's backdrop so empty areas look the same as before.
+constexpr float CLEAR_GRAY = 30.0f / 255.0f;
+
+GLuint compile_shader(GLenum type, const char* source) {
+    const GlApi& gl = gl_api();
+    GLuint shader = gl.CreateShader(type);
+    gl.ShaderSource(shader, 1, &source, nullptr);
+    gl.CompileShader(shader);
+
+    GLint status = 0;
+    gl.GetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (!status) {
+        char log[512] = {};
+        gl.GetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        std::fprintf(stderr, "Compositor shader failed: %s\n", log);
+        gl.DeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+} // namespace
+
+bool ClipQuad::contains(float x, float y) const {
+    bool any_negative = false;
+    bool any_positive = false;
+    for (size_t i = 0; i < corners.size(); ++i) {
+        const QuadPoint& a = corners[i];
+        const QuadPoint& b = corners[(i + 1) % corners.size()];
+        float cross = (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+        any_negative |= cross < 0.0f;
+        any_positive |= cross > 0.0f;
+    }
+    return !(any_negative && any_positive);
+}
+
+ClipQuad place_clip(const ClipPlacement& placement, int texture_width, int texture_height) {
+    float scaled_w = static_cast<float>(texture_width) * std::fabs(placement.scale_x);
+    float scaled_h = static_cast<float>(texture_height) * std::fabs(placement.scale_y);
+    float hw = scaled_w * 0.5f;
+    float hh = scaled_h * 0.5f;
+    float center_x = placement.position_x + hw;
+    float center_y = placement.position_y + hh;
+
+    float rad = placement.rotation * 3.14159265f / 180.0f;
+    float cos_r = std::cos(rad);
+    float sin_r = std::sin(rad);
+    auto rotate_point = [&](float dx, float dy) {
+        return QuadPoint{center_x + dx * cos_r - dy * sin_r, center_y + dx * sin_r + dy * cos_r};
+    };
+
+    ClipQuad quad;
+    quad.corners = {rotate_point(-hw, -hh), rotate_point(hw, -hh), rotate_point(hw, hh), rotate_point(-hw, hh)};
+    quad.uvs = {QuadPoint{0, 0}, QuadPoint{1, 0}, QuadPoint{1, 1}, QuadPoint{0, 1}};
+
+    if ((placement.scale_x < 0) != placement.flip_h) {
+        std::swap(quad.uvs[0].x, quad.uvs[1].x);
+        std::swap(quad.uvs[3].x, quad.uvs[2].x);
+    }
+    if ((placement.scale_y < 0) != placement.flip_v) {
+        std::swap(quad.uvs[0].y, quad.uvs[3].y);
+        std::swap(quad.uvs[1].y, quad.uvs[2].y);
+    }
+    return quad;
+}
+
+struct Compositor::Impl {
+    GLuint program = 0;
+    GLuint vao = 0;  // core profile needs one bound, even without attributes
+    GLuint ubo = 0;
+    GLint target_size_location = -1;
+    int batch_size = 0;  // layers per draw, one texture unit each
+
+    // Always uploaded whole: the buffer bound to Layers must cover the
+    // entire block, however few layers a batch uses.
+    std::array<LayerTransform, MAX_BATCH> transforms{};
+
+    void upload_transforms(const CompositeLayer* layers, int count);
+};
+
+void Compositor::Impl::upload_transforms(const CompositeLayer* layers, int count) {
+    for (int i = 0; i < count; ++i) {
+        const CompositeLayer& layer = layers[i];
+        LayerTransform& transform = transforms[static_cast<size_t>(i)];
+        for (size_t c = 0; c < 4; ++c) {
+            transform.corners[c * 2] = layer.quad.corners[c].x;
+            transform.corners[c * 2 + 1] = layer.quad.corners[c].y;
+            transform.uvs[c * 2] = layer.quad.uvs[c].x;
+            transform.uvs[c * 2 + 1] = layer.quad.uvs[c].y;
+        }
+    }
+
+    const GlApi& gl = gl_api();
+    gl.BindBuffer(GL_UNIFORM_BUFFER, ubo);
+    gl.BufferData(GL_UNIFORM_BUFFER, static_cast<std::ptrdiff_t>(sizeof(transforms)), transforms.data(),
+                  GL_STREAM_DRAW);
+    gl.BindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+Compositor::Compositor() : impl_(std::make_unique<Impl>()) {}
+
+Compositor::~Compositor() = default;
+
+bool Compositor::initialize() {
+    const GlApi& gl = gl_api();
+
+    GLint units = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &units);
+    impl_->batch_size = std::clamp(static_cast<int>(units), 1, MAX_BATCH);
+
+    GLuint vertex = compile_shader(GL_VERTEX_SHADER, VERTEX_SHADER);
+    GLuint fragment = compile_shader(GL_FRAGMENT_SHADER, fragment_shader(impl_->batch_size).c_str());
+    if (!vertex || !fragment) {
+        if (vertex) gl.DeleteShader(vertex);
+        if (fragment) gl.DeleteShader(fragment);
+        return false;
+    }
+
+    impl_->program = gl.CreateProgram();
+    gl.AttachShader(impl_->program, vertex);
+    gl.AttachShader(impl_->program, fragment);
+    gl.LinkProgram(impl_->program);
+    gl.DeleteShader(vertex);
+    gl.DeleteShader(fragment);
+
+    GLint status = 0;
+    gl.GetProgramiv(impl_->program, GL_LINK_STATUS, &status);
+    GLuint block = status ? gl.GetUniformBlockIndex(impl_->program, "Layers") : GL_INVALID_INDEX;
+    if (block == GL_INVALID_INDEX) {
+        char log[512] = {};
+        gl.GetProgramInfoLog(impl_->program, sizeof(log), nullptr, log);
+        std::fprintf(stderr, "Compositor program failed: %s\n", log);
+        shutdown();
+        return false;
+    }
+
+    gl.UniformBlockBinding(impl_->program, block, LAYERS_BINDING);
+    impl_->target_size_location = gl.GetUniformLocation(impl_->program, "u_target_size");
+    gl.UseProgram(impl_->program);
+    for (int i = 0; i < impl_->batch_size; ++i) {
+        std::string name = "u_textures[" + std::to_string(i) + "]";
+        gl.Uniform1i(gl.GetUniformLocation(impl_->program, name.c_str()), i);
+    }
+    gl.UseProgram(0);
+
+    gl.GenVertexArrays(1, &impl_->vao);
+    gl.GenBuffers(1, &impl_->ubo);
+    return true;
+}
+
+void Compositor::shutdown() {
+    const GlApi& gl = gl_api();
+    if (impl_->ubo != 0) gl.DeleteBuffers(1, &impl_->ubo);
+    if (impl_->vao != 0) gl.DeleteVertexArrays(1, &impl_->vao);
+    if (impl_->program != 0) gl.DeleteProgram(impl_->program);
+    *impl_ = Impl{};
+}
+
+int Compositor::batch_size() const {
+    return impl_->batch_size;
+}
+
+void Compositor::draw(uint32_t framebuffer, int width, int height, const std::vector<CompositeLayer>& layers) {
+    const GlApi& gl = gl_api();
+    draw_calls_ = 0;
+
+    gl.BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, width, height);
+    glClearColor(CLEAR_GRAY, CLEAR_GRAY, CLEAR_GRAY, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if (impl_->program != 0 && !layers.empty()) {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        gl.UseProgram(impl_->program);
+        gl.Uniform2f(impl_->target_size_location, static_cast<float>(width), static_cast<float>(height));
+        gl.BindVertexArray(impl_->vao);
+
+        // Each clip is sampled straight from its own texture, at its own size.
+        int total = static_cast<int>(layers.size());
+        int bound = 0;
+        for (int first = 0; first < total; first += impl_->batch_size) {
+            int count = std::min(impl_->batch_size, total - first);
+            impl_->upload_transforms(layers.data() + first, count);
+            gl.BindBufferBase(GL_UNIFORM_BUFFER, LAYERS_BINDING, impl_->ubo);
+            for (int i = 0; i < count; ++i) {
+                gl.ActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(i));
+                glBindTexture(GL_TEXTURE_2D, layers[static_cast<size_t>(first + i)].texture);
+            }
+            bound = std::max(bound, count);
+
+            // Instances draw in order, so blending stays back to front.
+            gl.DrawArraysInstanced(GL_TRIANGLES, 0, 6, count);
+            ++draw_calls_;
+        }
+
+        for (int i = 0; i < bound; ++i) {
+            gl.ActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(i));
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+        gl.ActiveTexture(GL_TEXTURE0);
+        gl.BindBufferBase(GL_UNIFORM_BUFFER, LAYERS_BINDING, 0);
+        gl.BindVertexArray(0);
+        gl.UseProgram(0);
+        glDisable(GL_BLEND);
+    }
+
+    gl.BindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+} // namespace furious
@@ -0,0 +1,71 @@
+#include "furious/video/gl_api.hpp"
+#include <cstdio>
+
+namespace furious {
+
+namespace {
+
+GlApi g_api;
+
+template<typename Fn>
+bool resolve(Fn& fn, const char* name) {
+    fn = reinterpret_cast<Fn>(glfwGetProcAddress(name));
+    if (!fn) {
+        std::fprintf(stderr, "Missing GL entry point: %s\n", name);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool load_gl_api() {
+    GlApi& gl = g_api;
+    bool ok = true;
+    ok &= resolve(gl.GenFramebuffers, "glGenFramebuffers");
+    ok &= resolve(gl.DeleteFramebuffers, "glDeleteFramebuffers");
+    ok &= resolve(gl.BindFramebuffer, "glBindFramebuffer");
+    ok &= resolve(gl.FramebufferTexture2D, "glFramebufferTexture2D");
+    ok &= resolve(gl.CheckFramebufferStatus, "glCheckFramebufferStatus");
+
+    ok &= resolve(gl.CreateShader, "glCreateShader");
+    ok &= resolve(gl.ShaderSource, "glShaderSource");
+    ok &= resolve(gl.CompileShader, "glCompileShader");
+    ok &= resolve(gl.GetShaderiv, "glGetShaderiv");
+    ok &= resolve(gl.GetShaderInfoLog, "glGetShaderInfoLog");
+    ok &= resolve(gl.DeleteShader, "glDeleteShader");
+    ok &= resolve(gl.CreateProgram, "glCreateProgram");
+    ok &= resolve(gl.AttachShader, "glAttachShader");
+    ok &= resolve(gl.LinkProgram, "glLinkProgram");
+    ok &= resolve(gl.GetProgramiv, "glGetProgramiv");
+    ok &= resolve(gl.GetProgramInfoLog, "glGetProgramInfoLog");
+    ok &= resolve(gl.DeleteProgram, "glDeleteProgram");
+    ok &= resolve(gl.UseProgram, "glUseProgram");
+    ok &= resolve(gl.GetUniformLocation, "glGetUniformLocation");
+    ok &= resolve(gl.Uniform1i, "glUniform1i");
+    ok &= resolve(gl.Uniform2f, "glUniform2f");
+    ok &= resolve(gl.GetUniformBlockIndex, "glGetUniformBlockIndex");
+    ok &= resolve(gl.UniformBlockBinding, "glUniformBlockBinding");
+
+    ok &= resolve(gl.GenVertexArrays, "glGenVertexArrays");
+    ok &= resolve(gl.DeleteVertexArrays, "glDeleteVertexArrays");
+    ok &= resolve(gl.BindVertexArray, "glBindVertexArray");
+    ok &= resolve(gl.GenBuffers, "glGenBuffers");
+    ok &= resolve(gl.DeleteBuffers, "glDeleteBuffers");
+    ok &= resolve(gl.BindBuffer, "glBindBuffer");
+    ok &= resolve(gl.BindBufferBase, "glBindBufferBase");
+    ok &= resolve(gl.BufferData, "glBufferData");
+    ok &= resolve(gl.ActiveTexture, "glActiveTexture");
+    ok &= resolve(gl.DrawArraysInstanced, "glDrawArraysInstanced");
+
+    ok &= resolve(gl.FenceSync, "glFenceSync");
+    ok &= resolve(gl.DeleteSync, "glDeleteSync");
+    ok &= resolve(gl.WaitSync, "glWaitSync");
+    return ok;
+}
+
+const GlApi& gl_api() {
+    return g_api;
+}
+
+} // namespace furious
@@ -0,0 +1,394 @@
+#include "furious/video/render_thread.hpp"
+#include "furious/video/gl_api.hpp"
+#include "furious/video/video_engine.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <thread>
+
+namespace furious {
+
+namespace {
+
+struct Slot {
+    GLuint texture = 0;
+    GLuint framebuffer = 0;  // render context only; framebuffers are not shared
+    int width = 0;
+    int height = 0;
+    void* fence = nullptr;   // whoever takes the slot next waits on this first
+    PreviewImage image;
+};
+
+void wait_and_clear(void*& fence) {
+    if (fence) {
+        const GlApi& gl = gl_api();
+        gl.WaitSync(fence, 0, GL_TIMEOUT_IGNORED);
+        gl.DeleteSync(fence);
+        fence = nullptr;
+    }
+}
+
+} // namespace
+
+struct RenderThread::Impl {
+    explicit Impl(VideoEngine& video_engine) : engine(video_engine) {}
+
+    VideoEngine& engine;
+    GLFWwindow* context = nullptr;
+    std::thread thread;
+    std::atomic<bool> running{false};
+
+    std::mutex engine_mutex;
+
+    // Guarded by state_mutex.
+    std::mutex state_mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    bool frame_pending = false;
+    PreviewFrame pending_frame;
+    std::vector<std::function<void(VideoEngine&)>> tasks;
+    std::deque<std::function<bool(VideoEngine&)>> steps;
+    double fps = 30.0;
+    float render_ms = 0.0f;
+    int draw_calls = 0;
+    std::string decoder_info = "None";
+
+    // Guarded by slot_mutex. back is written by the render thread, front
+    // read by the UI; ready holds the newest finished frame between them.
+    std::mutex slot_mutex;
+    std::array<Slot, 3> slots;
+    size_t back = 0;
+    size_t ready = 1;
+    size_t front = 2;
+    bool ready_fresh = false;
+
+    // Render thread only.
+    Compositor compositor;
+    PreviewFrame frame;
+    bool has_frame = false;
+    bool settled = true;
+    std::vector<CompositeLayer> layers;
+
+    void run(std::promise<bool>& started);
+    bool run_step(const std::function<bool(VideoEngine&)>& step);
+    void render(const std::vector<std::function<void(VideoEngine&)>>& work);
+    void prepare_slot(Slot& slot, int width, int height);
+    void release_gl();
+};
+
+void RenderThread::Impl::run(std::promise<bool>& started) {
+    glfwMakeContextCurrent(context);
+    if (!compositor.initialize()) {
+        glfwMakeContextCurrent(nullptr);
+        started.set_value(false);
+        return;
+    }
+    started.set_value(true);
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point next_frame = Clock::now();
+    std::vector<std::function<void(VideoEngine&)>> work;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(state_mutex);
+            wake.wait(lock, [this] {
+                return stopping || frame_pending || !tasks.empty() || !steps.empty() || (has_frame && !settled);
+            });
+            // Steps fill the time until the next frame is due. Submissions
+            // that land meanwhile replace the pending frame.
+            while (!stopping && !steps.empty() && Clock::now() < next_frame) {
+                std::function<bool(VideoEngine&)> step = std::move(steps.front());
+                steps.pop_front();
+                lock.unlock();
+                bool done = run_step(step);
+                lock.lock();
+                if (!done) steps.push_back(std::move(step));
+            }
+            wake.wait_until(lock, next_frame, [this] { return stopping; });
+            if (stopping) break;
+
+            auto interval = std::chrono::duration<double>(1.0 / std::max(fps, 1.0));
+            next_frame = Clock::now() + std::chrono::duration_cast<Clock::duration>(interval);
+            if (!frame_pending && tasks.empty() && (!has_frame || settled)) {
+                continue;  // only steps were waiting
+            }
+
+            work.swap(tasks);
+            if (frame_pending) {
+                frame = std::move(pending_frame);
+                frame_pending = false;
+                has_frame = true;
+            }
+        }
+
+        auto start = Clock::now();
+        render(work);
+        work.clear();
+        auto render_ms_now = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(state_mutex);
+        render_ms = render_ms_now;
+        draw_calls = compositor.draw_calls();
+    }
+
+    release_gl();
+    glfwMakeContextCurrent(nullptr);
+}
+
+bool RenderThread::Impl::run_step(const std::function<bool(VideoEngine&)>& step) {
+    std::lock_guard<std::mutex> lock(engine_mutex);
+    return step(engine);
+}
+
+void RenderThread::Impl::render(const std::vector<std::function<void(VideoEngine&)>>& work) {
+    std::vector<std::pair<ClipHandle, ClipQuad>> quads;
+    std::string decoder;
+    {
+        std::lock_guard<std::mutex> lock(engine_mutex);
+        for (const auto& task : work) {
+            task(engine);
+        }
+        if (!has_frame || frame.width <= 0 || frame.height <= 0) {
+            return;
+        }
+
+        engine.begin_frame();
+        for (const PreviewClip& clip : frame.clips) {
+            if (clip.looped) {
+                engine.request_looped_frame(clip.clip_handle, clip.source_handle,
+                                            clip.loop_start_seconds, clip.loop_duration_seconds,
+                                            clip.position_in_loop_seconds);
+            } else {
+                double seconds = clip.source_seconds;
+                double source_duration = engine.get_source_duration(clip.source_handle);
+                if (source_duration > 0.0 && seconds >= source_duration) {
+                    seconds = source_duration - 0.001;
+                }
+                engine.request_frame(clip.clip_handle, clip.source_handle, seconds);
+            }
+        }
+        engine.update();
+        settled = engine.is_settled();
+
+        layers.clear();
+        for (const PreviewClip& clip : frame.clips) {
+            uint32_t texture = engine.get_texture(clip.clip_handle);
+            int width = engine.get_texture_width(clip.source_handle);
+            int height = engine.get_texture_height(clip.source_handle);
+            if (texture == 0 || width == 0 || height == 0) continue;
+
+            ClipQuad quad = place_clip(clip.placement, width, height);
+            layers.push_back({texture, width, height, quad});
+            quads.emplace_back(clip.clip_handle, quad);
+        }
+        decoder = engine.get_active_decoder_info();
+    }
+
+    Slot& slot = slots[back];
+    wait_and_clear(slot.fence);
+    prepare_slot(slot, frame.width, frame.height);
+    compositor.draw(slot.framebuffer, frame.width, frame.height, layers);
+
+    slot.image.texture = slot.texture;
+    slot.image.width = frame.width;
+    slot.image.height = frame.height;
+    slot.image.quads = std::move(quads);
+    slot.fence = gl_api().FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+
+    {
+        std::lock_guard<std::mutex> lock(slot_mutex);
+        std::swap(back, ready);
+        ready_fresh = true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        decoder_info = std::move(decoder);
+    }
+    glfwPostEmptyEvent();
+}
+
+void RenderThread::Impl::prepare_slot(Slot& slot, int width, int height) {
+    const GlApi& gl = gl_api();
+
+    if (slot.texture == 0) {
+        glGenTextures(1, &slot.texture);
+        glBindTexture(GL_TEXTURE_2D, slot.texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    if (slot.width != width || slot.height != height) {
+        glBindTexture(GL_TEXTURE_2D, slot.texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        slot.width = width;
+        slot.height = height;
+    }
+
+    if (slot.framebuffer == 0) {
+        gl.GenFramebuffers(1, &slot.framebuffer);
+        gl.BindFramebuffer(GL_FRAMEBUFFER, slot.framebuffer);
+        gl.FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, slot.texture, 0);
+        if (gl.CheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::fprintf(stderr, "Preview framebuffer is incomplete\n");
+        }
+        gl.BindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+}
+
+void RenderThread::Impl::release_gl() {
+    {
+        std::lock_guard<std::mutex> lock(engine_mutex);
+        engine.shutdown();
+    }
+
+    const GlApi& gl = gl_api();
+    for (Slot& slot : slots) {
+        wait_and_clear(slot.fence);
+        if (slot.framebuffer != 0) gl.DeleteFramebuffers(1, &slot.framebuffer);
+        if (slot.texture != 0) glDeleteTextures(1, &slot.texture);
+        slot = Slot{};
+    }
+    compositor.shutdown();
+    glFinish();
+}
+
+RenderThread::RenderThread(VideoEngine& engine) : impl_(std::make_unique<Impl>(engine)) {}
+
+RenderThread::~RenderThread() {
+    stop();
+}
+
+bool RenderThread::start(GLFWwindow* context) {
+    if (impl_->running || !context) {
+        return false;
+    }
+
+    impl_->context = context;
+    impl_->stopping = false;
+
+    std::promise<bool> started;
+    std::future<bool> result = started.get_future();
+    impl_->thread = std::thread([this, &started] { impl_->run(started); });
+    if (!result.get()) {
+        impl_->thread.join();
+        return false;
+    }
+    impl_->running = true;
+    return true;
+}
+
+void RenderThread::stop() {
+    if (!impl_->thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(impl_->state_mutex);
+        impl_->stopping = true;
+        impl_->tasks.clear();
+        impl_->steps.clear();
+    }
+    impl_->wake.notify_one();
+    impl_->thread.join();
+    impl_->running = false;
+}
+
+bool RenderThread::is_running() const {
+    return impl_->running;
+}
+
+void RenderThread::set_fps(double fps) {
+    std::lock_guard<std::mutex> lock(impl_->state_mutex);
+    impl_->fps = fps;
+}
+
+void RenderThread::submit(PreviewFrame frame) {
+    {
+        std::lock_guard<std::mutex> lock(impl_->state_mutex);
+        impl_->pending_frame = std::move(frame);
+        impl_->frame_pending = true;
+    }
+    impl_->wake.notify_one();
+}
+
+void RenderThread::post(std::function<void(VideoEngine&)> task) {
+    if (!impl_->running) {
+        std::lock_guard<std::mutex> lock(impl_->engine_mutex);
+        task(impl_->engine);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(impl_->state_mutex);
+        impl_->tasks.push_back(std::move(task));
+    }
+    impl_->wake.notify_one();
+}
+
+void RenderThread::post_steps(std::function<bool(VideoEngine&)> step) {
+    if (!impl_->running) {
+        while (!impl_->run_step(step)) {}
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(impl_->state_mutex);
+        impl_->steps.push_back(std::move(step));
+    }
+    impl_->wake.notify_one();
+}
+
+std::unique_lock<std::mutex> RenderThread::lock_engine() {
+    return std::unique_lock<std::mutex>(impl_->engine_mutex);
+}
+
+const PreviewImage& RenderThread::acquire() {
+    if (!impl_->running) {
+        return impl_->slots[impl_->front].image;
+    }
+
+    const GlApi& gl = gl_api();
+    {
+        std::lock_guard<std::mutex> lock(impl_->slot_mutex);
+        if (impl_->ready_fresh) {
+            // The UI's draws from the outgoing texture are already queued;
+            // the render thread waits for them before drawing into it.
+            Slot& released = impl_->slots[impl_->front];
+            if (released.image.texture != 0) {
+                released.fence = gl.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                glFlush();
+            }
+            std::swap(impl_->front, impl_->ready);
+            impl_->ready_fresh = false;
+        }
+    }
+
+    Slot& slot = impl_->slots[impl_->front];
+    wait_and_clear(slot.fence);
+    return slot.image;
+}
+
+float RenderThread::last_render_ms() const {
+    std::lock_guard<std::mutex> lock(impl_->state_mutex);
+    return impl_->render_ms;
+}
+
+int RenderThread::last_draw_calls() const {
+    std::lock_guard<std::mutex> lock(impl_->state_mutex);
+    return impl_->draw_calls;
+}
+
+std::string RenderThread::decoder_info() const {
+    std::lock_guard<std::mutex> lock(impl_->state_mutex);
+    return impl_->decoder_info;
+}
+
+} // namespace furious
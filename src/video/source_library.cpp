@@ -2,12 +2,56 @@
 #include "furious/audio/audio_decoder.hpp"
 #include "furious/audio/audio_buffer.hpp"
 #include <algorithm>
+#include <atomic>
 #include <random>
 #include <sstream>
 #include <iomanip>
+#include <thread>
 
 namespace furious {
 
+// One pending format change. The thread owns jobs until done is set; the
+// UI thread then swaps each result in, unless the source's buffer changed
+// in the meantime.
+struct SourceLibrary::Reencode {
+    struct Job {
+        std::string source_id;
+        std::string filepath;
+        std::shared_ptr<const AudioBuffer> current;
+        std::shared_ptr<const AudioBuffer> result;
+    };
+
+    SampleFormat format;
+    AudioCache cache;
+    std::vector<Job> jobs;
+    std::atomic<bool> done{false};
+    std::jthread thread;
+
+    void run(std::stop_token stop) {
+        for (auto& job : jobs) {
+            if (stop.stop_requested()) break;
+            job.result = reencode(job);
+        }
+        done.store(true, std::memory_order_release);
+        done.notify_all();
+    }
+
+    std::shared_ptr<const AudioBuffer> reencode(const Job& job) const {
+        const AudioBuffer& current = *job.current;
+        auto buffer = cache.load(job.filepath, format, current.sample_rate(), current.channels());
+        if (!buffer && current.format() != SampleFormat::Float32) {
+            // Converting cannot restore what a 16-bit buffer lost.
+            buffer = extract_audio(cache, job.filepath, format);
+        }
+        if (!buffer) {
+            // Kept out of the cache: entries must come straight from the
+            // decoder, or one lossy pass would stick to every later load.
+            buffer = std::make_shared<const AudioBuffer>(current.converted(format));
+        }
+        return buffer;
+    }
+};
+
 SourceLibrary::SourceLibrary() = default;
 SourceLibrary::~SourceLibrary() = default;
 
@@ -22,16 +66,11 @@ std::string SourceLibrary::add_source(const std::string& filepath) {
         source.duration_seconds = 0.0;
         source.fps = 0.0;
     } else if (source.type == MediaType::Video) {
-        AudioDecoder audio_decoder;
-        if (audio_decoder.open(filepath).has_value() && audio_decoder.has_audio_stream()) {
-            auto result = audio_decoder.extract_all();
-            if (result.has_value()) {
-                source.audio_buffer = std::make_shared<const AudioBuffer>(std::move(*result));
-            }
-        }
+        source.audio_buffer = extract_audio(filepath);
     }
 
     sources_.push_back(source);
+    bind_handle(sources_.size() - 1);
     return source.id;
 }
 
@@ -39,16 +78,11 @@ void SourceLibrary::add_source_direct(const MediaSource& source) {
     MediaSource new_source = source;
 
     if (new_source.type == MediaType::Video && !new_source.audio_buffer) {
-        AudioDecoder audio_decoder;
-        if (audio_decoder.open(new_source.filepath).has_value() && audio_decoder.has_audio_stream()) {
-            auto result = audio_decoder.extract_all();
-            if (result.has_value()) {
-                new_source.audio_buffer = std::make_shared<const AudioBuffer>(std::move(*result));
-            }
-        }
+        new_source.audio_buffer = extract_audio(new_source.filepath);
     }
 
     sources_.push_back(std::move(new_source));
+    bind_handle(sources_.size() - 1);
 }
 
 void SourceLibrary::remove_source(std::string_view source_id) {
@@ -59,26 +93,119 @@ void SourceLibrary::remove_source(std::string_view source_id) {
             }),
         sources_.end()
     );
+    rebind_handles();
 }
 
 MediaSource* SourceLibrary::find_source(std::string_view source_id) {
-    auto it = std::find_if(sources_.begin(), sources_.end(),
-        [source_id](const MediaSource& s) {
-            return s.id == source_id;
-        });
-    return it != sources_.end() ? &(*it) : nullptr;
+    return find_source(handles_.find(source_id));
 }
 
 const MediaSource* SourceLibrary::find_source(std::string_view source_id) const {
-    auto it = std::find_if(sources_.begin(), sources_.end(),
-        [source_id](const MediaSource& s) {
-            return s.id == source_id;
-        });
-    return it != sources_.end() ? &(*it) : nullptr;
+    return find_source(handles_.find(source_id));
+}
+
+MediaSource* SourceLibrary::find_source(SourceHandle handle) {
+    size_t slot = handles_.slot(handle);
+    return slot != HandleTable<SourceTag>::NO_SLOT ? &sources_[slot] : nullptr;
+}
+
+const MediaSource* SourceLibrary::find_source(SourceHandle handle) const {
+    size_t slot = handles_.slot(handle);
+    return slot != HandleTable<SourceTag>::NO_SLOT ? &sources_[slot] : nullptr;
+}
+
+SourceHandle SourceLibrary::source_handle(const TimelineClip& clip) const {
+    if (!handles_.is_current(clip.source_handle)) {
+        clip.source_handle = handles_.find(clip.source_id);
+    }
+    return clip.source_handle;
+}
+
+const MediaSource* SourceLibrary::find_source(const TimelineClip& clip) const {
+    return find_source(source_handle(clip));
 }
 
 void SourceLibrary::clear() {
     sources_.clear();
+    handles_.clear();
+}
+
+void SourceLibrary::bind_handle(size_t source) {
+    SourceHandle handle = handles_.intern(sources_[source].id);
+    if (handles_.slot(handle) == HandleTable<SourceTag>::NO_SLOT) {
+        handles_.bind(handle, source);
+    }
+}
+
+void SourceLibrary::rebind_handles() {
+    handles_.unbind_all();
+    for (size_t i = 0; i < sources_.size(); ++i) {
+        bind_handle(i);
+    }
+    handles_.release_unbound();
+}
+
+void SourceLibrary::set_sample_format(SampleFormat format) {
+    if (format == sample_format_) return;
+    sample_format_ = format;
+    reencode_.reset();
+
+    auto reencode = std::make_unique<Reencode>();
+    reencode->format = format;
+    reencode->cache = audio_cache_;
+    for (const auto& source : sources_) {
+        if (!source.audio_buffer || source.audio_buffer->format() == format) continue;
+        reencode->jobs.push_back({source.id, source.filepath, source.audio_buffer, nullptr});
+    }
+    if (reencode->jobs.empty()) return;
+
+    reencode->thread = std::jthread([raw = reencode.get()](std::stop_token stop) { raw->run(stop); });
+    reencode_ = std::move(reencode);
+}
+
+bool SourceLibrary::poll_reencoded_audio(bool wait) {
+    if (!reencode_) return false;
+    if (wait) {
+        reencode_->done.wait(false, std::memory_order_acquire);
+    } else if (!reencode_->done.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    bool changed = false;
+    for (auto& job : reencode_->jobs) {
+        MediaSource* source = find_source(job.source_id);
+        if (!source || !job.result || source->audio_buffer != job.current) continue;
+        source->audio_buffer = std::move(job.result);
+        changed = true;
+    }
+    reencode_.reset();
+    return changed;
+}
+
+std::shared_ptr<const AudioBuffer> SourceLibrary::extract_audio(const std::string& filepath) const {
+    return extract_audio(audio_cache_, filepath, sample_format_);
+}
+
+std::shared_ptr<const AudioBuffer> SourceLibrary::extract_audio(const AudioCache& cache, const std::string& filepath,
+                                                                SampleFormat format) {
+    if (auto cached = cache.load(filepath, format, 44100, 2)) {
+        return cached;
+    }
+
+    AudioDecoder audio_decoder;
+    if (!audio_decoder.open(filepath).has_value() || !audio_decoder.has_audio_stream()) {
+        return nullptr;
+    }
+
+    auto result = audio_decoder.extract_all(44100, 2, format);
+    if (!result.has_value()) {
+        return nullptr;
+    }
+
+    if (auto cached = cache.store(filepath, *result)) {
+        return cached;
+    }
+    return std::make_shared<const AudioBuffer>(std::move(*result));
 }
 
 std::string SourceLibrary::generate_id() {
@@ -1,8 +1,6 @@
 #include "furious/video/video_engine.hpp"
 #include "furious/video/video_decoder.hpp"
 #include <GLFW/glfw3.h>
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
 #include <chrono>
 #include <cstdio>
@@ -18,9 +16,10 @@ struct SourceState {
 
 constexpr double MAX_DECODE_RATE = 30.0;
 constexpr double MIN_DECODE_INTERVAL = 1.0 / MAX_DECODE_RATE;
+constexpr size_t MAX_LOOP_FRAMES = 120;
 
 struct ClipState {
-    std::string source_id;
+    SourceHandle source;
     uint32_t texture_id = 0;
     int width = 0;
     int height = 0;
@@ -43,12 +42,105 @@ struct ClipState {
 };
 
 struct VideoEngine::Impl {
-    std::unordered_map<std::string, SourceState> sources;
-    std::unordered_map<std::string, ClipState> clips;
-    std::unordered_set<std::string> active_clip_ids;
+    HandleMap<SourceTag, SourceState> sources;
+    HandleMap<ClipTag, ClipState> clips;
     bool initialized = false;
+
+    ClipState& create_clip(ClipHandle handle, SourceHandle source, const SourceState& source_state);
+
+    static void restart_loop(ClipState& clip, const SourceState& source,
+                             double source_start_seconds, double loop_duration_seconds);
+
+    // Decodes up to max_frames more frames of the clip's loop and marks the
+    // cache complete once it covers the loop or holds MAX_LOOP_FRAMES.
+    // Returns the number of decode attempts.
+    static size_t fill_loop_cache(ClipState& clip, SourceState& source, size_t max_frames);
 };
 
+void VideoEngine::Impl::restart_loop(ClipState& clip, const SourceState& source,
+                                     double source_start_seconds, double loop_duration_seconds) {
+    double fps = source.decoder->fps();
+    if (fps <= 0.0) fps = 30.0;
+
+    clip.loop_frames.clear();
+    clip.loop_source_start = source_start_seconds;
+    clip.loop_duration = loop_duration_seconds;
+    clip.loop_frame_duration = 1.0 / fps;
+    clip.loop_next_decode_time = source_start_seconds;
+    clip.loop_cache_complete = false;
+}
+
+size_t VideoEngine::Impl::fill_loop_cache(ClipState& clip, SourceState& source, size_t max_frames) {
+    if (clip.loop_cache_complete) return 0;
+
+    size_t buffer_size = static_cast<size_t>(source.width) * static_cast<size_t>(source.height) * 4;
+    std::vector<uint8_t> frame_buffer(buffer_size);
+    double end_time = clip.loop_source_start + clip.loop_duration + clip.loop_frame_duration;
+    size_t frames_decoded = 0;
+
+    while (clip.loop_next_decode_time < end_time && frames_decoded < max_frames &&
+           clip.loop_frames.size() < MAX_LOOP_FRAMES) {
+        if (source.decoder->seek_and_decode(clip.loop_next_decode_time, frame_buffer)) {
+            clip.loop_frames.push_back(std::move(frame_buffer));
+            frame_buffer.resize(buffer_size);
+        }
+        clip.loop_next_decode_time += clip.loop_frame_duration;
+        ++frames_decoded;
+    }
+
+    if (clip.loop_next_decode_time >= end_time || clip.loop_frames.size() >= MAX_LOOP_FRAMES) {
+        clip.loop_cache_complete = true;
+    }
+
+    int decoder_width = source.decoder->width();
+    int decoder_height = source.decoder->height();
+    if (decoder_width != clip.width || decoder_height != clip.height) {
+        clip.width = decoder_width;
+        clip.height = decoder_height;
+        if (clip.texture_id != 0) {
+            glDeleteTextures(1, &clip.texture_id);
+        }
+        glGenTextures(1, &clip.texture_id);
+        glBindTexture(GL_TEXTURE_2D, clip.texture_id);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
+                     clip.width, clip.height, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    return frames_decoded;
+}
+
+ClipState& VideoEngine::Impl::create_clip(ClipHandle handle, SourceHandle source,
+                                          const SourceState& source_state) {
+    ClipState clip_state;
+    clip_state.source = source;
+    clip_state.width = source_state.width;
+    clip_state.height = source_state.height;
+
+    glGenTextures(1, &clip_state.texture_id);
+    glBindTexture(GL_TEXTURE_2D, clip_state.texture_id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
+                 clip_state.width, clip_state.height, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // A clip from a cleared timeline may still hold this index.
+    if (auto displaced = clips.replace(handle, std::move(clip_state))) {
+        if (displaced->texture_id != 0) {
+            glDeleteTextures(1, &displaced->texture_id);
+        }
+    }
+    return *clips.find(handle);
+}
+
 VideoEngine::VideoEngine() : impl_(std::make_unique<Impl>()) {}
 
 VideoEngine::~VideoEngine() {
@@ -61,24 +153,24 @@ bool VideoEngine::initialize() {
 }
 
 void VideoEngine::shutdown() {
-    for (auto& [id, state] : impl_->clips) {
+    impl_->clips.for_each([](ClipState& state) {
         if (state.texture_id != 0) {
             glDeleteTextures(1, &state.texture_id);
         }
-    }
+    });
     impl_->clips.clear();
 
-    for (auto& [id, state] : impl_->sources) {
+    impl_->sources.for_each([](SourceState& state) {
         if (state.decoder) {
             state.decoder->close();
         }
-    }
+    });
     impl_->sources.clear();
     impl_->initialized = false;
 }
 
-void VideoEngine::register_source(const MediaSource& source) {
-    if (impl_->sources.count(source.id) > 0) {
+void VideoEngine::register_source(SourceHandle handle, const MediaSource& source) {
+    if (!handle.is_valid() || impl_->sources.contains(handle)) {
         return;
     }
 
@@ -101,86 +193,86 @@ void VideoEngine::register_source(const MediaSource& source) {
         state.height = source.height > 0 ? source.height : 256;
     }
 
-    impl_->sources[source.id] = std::move(state);
+    impl_->sources.replace(handle, std::move(state));
 }
 
-void VideoEngine::unregister_source(const std::string& source_id) {
-    auto it = impl_->sources.find(source_id);
-    if (it == impl_->sources.end()) return;
+void VideoEngine::unregister_source(SourceHandle handle) {
+    SourceState* source = impl_->sources.find(handle);
+    if (!source) return;
 
-    for (auto clip_it = impl_->clips.begin(); clip_it != impl_->clips.end();) {
-        if (clip_it->second.source_id == source_id) {
-            if (clip_it->second.texture_id != 0) {
-                glDeleteTextures(1, &clip_it->second.texture_id);
-            }
-            clip_it = impl_->clips.erase(clip_it);
-        } else {
-            ++clip_it;
+    impl_->clips.erase_if([handle](ClipState& clip) {
+        if (clip.source != handle) return false;
+        if (clip.texture_id != 0) {
+            glDeleteTextures(1, &clip.texture_id);
         }
-    }
+        return true;
+    });
 
-    if (it->second.decoder) {
-        it->second.decoder->close();
+    if (source->decoder) {
+        source->decoder->close();
     }
-    impl_->sources.erase(it);
+    impl_->sources.erase(handle);
+}
+
+void VideoEngine::retain_clips(const std::function<bool(ClipHandle)>& is_live) {
+    impl_->clips.prune(is_live, [](ClipState& clip) {
+        if (clip.texture_id != 0) {
+            glDeleteTextures(1, &clip.texture_id);
+        }
+    });
+}
+
+void VideoEngine::retain_sources(const std::function<bool(SourceHandle)>& is_live) {
+    impl_->sources.prune(is_live, [](SourceState& source) {
+        if (source.decoder) {
+            source.decoder->close();
+        }
+    });
+    impl_->clips.erase_if([this](ClipState& clip) {
+        if (impl_->sources.contains(clip.source)) return false;
+        if (clip.texture_id != 0) {
+            glDeleteTextures(1, &clip.texture_id);
+        }
+        return true;
+    });
 }
 
 void VideoEngine::begin_frame() {
-    for (auto& [id, state] : impl_->clips) {
+    impl_->clips.for_each([](ClipState& state) {
         state.requested_this_frame = false;
-    }
-    impl_->active_clip_ids.clear();
+    });
 }
 
-void VideoEngine::request_frame(const std::string& clip_id, const std::string& source_id, double local_seconds) {
+void VideoEngine::request_frame(ClipHandle clip_handle, SourceHandle source_handle, double local_seconds) {
     auto t_start = std::chrono::high_resolution_clock::now();
 
-    auto source_it = impl_->sources.find(source_id);
-    if (source_it == impl_->sources.end()) {
+    SourceState* source_state = impl_->sources.find(source_handle);
+    if (!source_state) {
         return;
     }
 
-    SourceState& source = source_it->second;
+    SourceState& source = *source_state;
 
     if (source.type == MediaType::Image) {
-        impl_->active_clip_ids.insert(clip_id);
         return;
     }
 
     if (source.width <= 0 || source.height <= 0) return;
 
-    auto clip_it = impl_->clips.find(clip_id);
-    if (clip_it == impl_->clips.end()) {
+    ClipState* clip_state = impl_->clips.find(clip_handle);
+    if (!clip_state) {
         auto t_tex_start = std::chrono::high_resolution_clock::now();
-        ClipState clip_state;
-        clip_state.source_id = source_id;
-        clip_state.width = source.width;
-        clip_state.height = source.height;
-
-        glGenTextures(1, &clip_state.texture_id);
-        glBindTexture(GL_TEXTURE_2D, clip_state.texture_id);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
-                     clip_state.width, clip_state.height, 0,
-                     GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        glBindTexture(GL_TEXTURE_2D, 0);
-
-        impl_->clips[clip_id] = std::move(clip_state);
-        clip_it = impl_->clips.find(clip_id);
+        clip_state = &impl_->create_clip(clip_handle, source_handle, source);
         auto t_tex_end = std::chrono::high_resolution_clock::now();
         auto tex_ms = std::chrono::duration<double, std::milli>(t_tex_end - t_tex_start).count();
         if (tex_ms > 5.0) {
-            std::printf("[PROFILE] request_frame texture_create: %.2fms clip=%s\n", tex_ms, clip_id.c_str());
+            std::printf("[PROFILE] request_frame texture_create: %.2fms clip=%u\n", tex_ms, clip_handle.index);
         }
     }
 
-    ClipState& clip = clip_it->second;
+    ClipState& clip = *clip_state;
     clip.requested_this_frame = true;
     clip.use_loop_frame = false;
-    impl_->active_clip_ids.insert(clip_id);
 
     double fps = source.decoder ? source.decoder->fps() : 30.0;
     if (fps <= 0.0) fps = 30.0;
@@ -200,8 +292,8 @@ void VideoEngine::request_frame(const std::string& clip_id, const std::string& s
         auto t_decode_end = std::chrono::high_resolution_clock::now();
         auto decode_ms = std::chrono::duration<double, std::milli>(t_decode_end - t_decode_start).count();
         if (decode_ms > 10.0) {
-            std::printf("[PROFILE] request_frame seek_and_decode: %.2fms clip=%s time=%.3fs\n",
-                       decode_ms, clip_id.c_str(), local_seconds);
+            std::printf("[PROFILE] request_frame seek_and_decode: %.2fms clip=%u time=%.3fs\n",
+                       decode_ms, clip_handle.index, local_seconds);
         }
 
         int decoder_width = source.decoder->width();
@@ -230,36 +322,21 @@ void VideoEngine::request_frame(const std::string& clip_id, const std::string& s
     auto t_end = std::chrono::high_resolution_clock::now();
     auto total_ms = std::chrono::duration<double, std::milli>(t_end - t_start).count();
     if (total_ms > 16.0) {
-        std::printf("[PROFILE] request_frame TOTAL: %.2fms clip=%s\n", total_ms, clip_id.c_str());
+        std::printf("[PROFILE] request_frame TOTAL: %.2fms clip=%u\n", total_ms, clip_handle.index);
     }
 }
 
-void VideoEngine::prefetch_clip(const std::string& clip_id, const std::string& source_id, double start_seconds) {
-    auto source_it = impl_->sources.find(source_id);
-    if (source_it == impl_->sources.end()) return;
+void VideoEngine::prefetch_clip(ClipHandle clip_handle, SourceHandle source_handle, double start_seconds) {
+    SourceState* source_state = impl_->sources.find(source_handle);
+    if (!source_state) return;
 
-    SourceState& source = source_it->second;
+    SourceState& source = *source_state;
     if (source.type == MediaType::Image) return;
     if (source.width <= 0 || source.height <= 0) return;
 
-    auto clip_it = impl_->clips.find(clip_id);
-    if (clip_it != impl_->clips.end()) return;
-
-    ClipState clip_state;
-    clip_state.source_id = source_id;
-    clip_state.width = source.width;
-    clip_state.height = source.height;
+    if (impl_->clips.contains(clip_handle)) return;
 
-    glGenTextures(1, &clip_state.texture_id);
-    glBindTexture(GL_TEXTURE_2D, clip_state.texture_id);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
-                 clip_state.width, clip_state.height, 0,
-                 GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    ClipState& clip_state = impl_->create_clip(clip_handle, source_handle, source);
 
     if (source.decoder && source.decoder->seek_and_decode(start_seconds, clip_state.frame_buffer)) {
         clip_state.texture_needs_update = true;
@@ -268,100 +345,43 @@ void VideoEngine::prefetch_clip(const std::string& clip_id, const std::string& s
     }
 
     clip_state.prebuilt = true;
-    impl_->clips[clip_id] = std::move(clip_state);
 }
 
-bool VideoEngine::is_clip_cached(const std::string& clip_id) const {
-    return impl_->clips.find(clip_id) != impl_->clips.end();
+bool VideoEngine::is_clip_cached(ClipHandle clip_handle) const {
+    return impl_->clips.contains(clip_handle);
 }
 
-bool VideoEngine::is_loop_cache_complete(const std::string& clip_id) const {
-    auto it = impl_->clips.find(clip_id);
-    if (it == impl_->clips.end()) return false;
-    return it->second.loop_cache_complete;
+bool VideoEngine::is_loop_cache_complete(ClipHandle clip_handle) const {
+    const ClipState* clip = impl_->clips.find(clip_handle);
+    return clip && clip->loop_cache_complete;
 }
 
-void VideoEngine::prebuild_loop_cache(const std::string& clip_id, const std::string& source_id,
-                                       double source_start_seconds, double loop_duration_seconds) {
-    auto source_it = impl_->sources.find(source_id);
-    if (source_it == impl_->sources.end()) {
-        return;
+bool VideoEngine::prebuild_loop_cache(ClipHandle clip_handle, SourceHandle source_handle,
+                                      double source_start_seconds, double loop_duration_seconds,
+                                      size_t max_frames) {
+    SourceState* source_state = impl_->sources.find(source_handle);
+    if (!source_state) {
+        return true;
     }
 
-    SourceState& source = source_it->second;
-    if (source.type == MediaType::Image) return;
-    if (!source.decoder) return;
-    if (source.width <= 0 || source.height <= 0) return;
-
-    auto clip_it = impl_->clips.find(clip_id);
-    if (clip_it == impl_->clips.end()) {
-        ClipState clip_state;
-        clip_state.source_id = source_id;
-        clip_state.width = source.width;
-        clip_state.height = source.height;
-
-        glGenTextures(1, &clip_state.texture_id);
-        glBindTexture(GL_TEXTURE_2D, clip_state.texture_id);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
-                     clip_state.width, clip_state.height, 0,
-                     GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        glBindTexture(GL_TEXTURE_2D, 0);
+    SourceState& source = *source_state;
+    if (source.type == MediaType::Image) return true;
+    if (!source.decoder) return true;
+    if (source.width <= 0 || source.height <= 0) return true;
 
-        impl_->clips[clip_id] = std::move(clip_state);
-        clip_it = impl_->clips.find(clip_id);
+    ClipState* clip_state = impl_->clips.find(clip_handle);
+    if (!clip_state) {
+        clip_state = &impl_->create_clip(clip_handle, source_handle, source);
     }
 
-    ClipState& clip = clip_it->second;
-
-    double fps = source.decoder->fps();
-    if (fps <= 0.0) fps = 30.0;
-
-    clip.loop_frames.clear();
-    clip.loop_source_start = source_start_seconds;
-    clip.loop_duration = loop_duration_seconds;
-    clip.loop_frame_duration = 1.0 / fps;
-    clip.loop_next_decode_time = source_start_seconds;
-    clip.loop_cache_complete = false;
-
-    size_t buffer_size = static_cast<size_t>(source.width) * static_cast<size_t>(source.height) * 4;
-    std::vector<uint8_t> frame_buffer(buffer_size);
-    double end_time = source_start_seconds + loop_duration_seconds + clip.loop_frame_duration;
-
-    while (clip.loop_next_decode_time < end_time && clip.loop_frames.size() < 120) {
-        if (source.decoder->seek_and_decode(clip.loop_next_decode_time, frame_buffer)) {
-            clip.loop_frames.push_back(std::move(frame_buffer));
-            frame_buffer.resize(buffer_size);
-        }
-        clip.loop_next_decode_time += clip.loop_frame_duration;
-    }
-
-    clip.loop_cache_complete = true;
-
-    int decoder_width = source.decoder->width();
-    int decoder_height = source.decoder->height();
-    if (decoder_width != clip.width || decoder_height != clip.height) {
-        clip.width = decoder_width;
-        clip.height = decoder_height;
-        if (clip.texture_id != 0) {
-            glDeleteTextures(1, &clip.texture_id);
-        }
-        glGenTextures(1, &clip.texture_id);
-        glBindTexture(GL_TEXTURE_2D, clip.texture_id);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
-                     clip.width, clip.height, 0,
-                     GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        glBindTexture(GL_TEXTURE_2D, 0);
+    ClipState& clip = *clip_state;
+    if (clip.loop_frame_duration <= 0.0 ||
+        clip.loop_source_start != source_start_seconds || clip.loop_duration != loop_duration_seconds) {
+        Impl::restart_loop(clip, source, source_start_seconds, loop_duration_seconds);
     }
+    Impl::fill_loop_cache(clip, source, max_frames);
 
-    if (!clip.loop_frames.empty()) {
+    if (!clip.loop_frames.empty() && !clip.use_loop_frame) {
         clip.current_loop_frame_index = 0;
         clip.use_loop_frame = true;
         clip.has_valid_frame = true;
@@ -369,20 +389,20 @@ void VideoEngine::prebuild_loop_cache(const std::string& clip_id, const std::str
     }
 
     clip.prebuilt = true;
+    return clip.loop_cache_complete;
 }
 
-void VideoEngine::request_looped_frame(const std::string& clip_id, const std::string& source_id,
+void VideoEngine::request_looped_frame(ClipHandle clip_handle, SourceHandle source_handle,
                                         double source_start_seconds, double loop_duration_seconds,
                                         double position_in_loop) {
     auto t_start = std::chrono::high_resolution_clock::now();
 
-    auto source_it = impl_->sources.find(source_id);
-    if (source_it == impl_->sources.end()) return;
+    SourceState* source_state = impl_->sources.find(source_handle);
+    if (!source_state) return;
 
-    SourceState& source = source_it->second;
+    SourceState& source = *source_state;
 
     if (source.type == MediaType::Image) {
-        impl_->active_clip_ids.insert(clip_id);
         return;
     }
 
@@ -390,31 +410,13 @@ void VideoEngine::request_looped_frame(const std::string& clip_id, const std::st
 
     if (source.width <= 0 || source.height <= 0) return;
 
-    auto clip_it = impl_->clips.find(clip_id);
-    if (clip_it == impl_->clips.end()) {
-        ClipState clip_state;
-        clip_state.source_id = source_id;
-        clip_state.width = source.width;
-        clip_state.height = source.height;
-
-        glGenTextures(1, &clip_state.texture_id);
-        glBindTexture(GL_TEXTURE_2D, clip_state.texture_id);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
-                     clip_state.width, clip_state.height, 0,
-                     GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        glBindTexture(GL_TEXTURE_2D, 0);
-
-        impl_->clips[clip_id] = std::move(clip_state);
-        clip_it = impl_->clips.find(clip_id);
+    ClipState* clip_state = impl_->clips.find(clip_handle);
+    if (!clip_state) {
+        clip_state = &impl_->create_clip(clip_handle, source_handle, source);
     }
 
-    ClipState& clip = clip_it->second;
+    ClipState& clip = *clip_state;
     clip.requested_this_frame = true;
-    impl_->active_clip_ids.insert(clip_id);
 
     bool params_changed = (clip.loop_source_start != source_start_seconds) ||
                           (clip.loop_duration != loop_duration_seconds);
@@ -424,65 +426,19 @@ void VideoEngine::request_looped_frame(const std::string& clip_id, const std::st
     }
 
     if (params_changed) {
-        double fps = source.decoder->fps();
-        if (fps <= 0.0) fps = 30.0;
-
-        clip.loop_frames.clear();
-        clip.loop_source_start = source_start_seconds;
-        clip.loop_duration = loop_duration_seconds;
-        clip.loop_frame_duration = 1.0 / fps;
-        clip.loop_next_decode_time = source_start_seconds;
-        clip.loop_cache_complete = false;
+        Impl::restart_loop(clip, source, source_start_seconds, loop_duration_seconds);
     }
 
-    if (!clip.loop_cache_complete && clip.loop_frames.size() < 120) {
+    if (!clip.loop_cache_complete) {
         auto t_cache_start = std::chrono::high_resolution_clock::now();
         constexpr size_t MAX_FRAMES_PER_CALL = 5;
 
-        size_t buffer_size = static_cast<size_t>(source.width) * static_cast<size_t>(source.height) * 4;
-        std::vector<uint8_t> frame_buffer(buffer_size);
-        double end_time = clip.loop_source_start + clip.loop_duration + clip.loop_frame_duration;
-        size_t frames_decoded = 0;
-
-        while (clip.loop_next_decode_time < end_time && frames_decoded < MAX_FRAMES_PER_CALL) {
-            if (source.decoder->seek_and_decode(clip.loop_next_decode_time, frame_buffer)) {
-                clip.loop_frames.push_back(std::move(frame_buffer));
-                frame_buffer.resize(buffer_size);
-            }
-            clip.loop_next_decode_time += clip.loop_frame_duration;
-            ++frames_decoded;
-
-            if (clip.loop_frames.size() >= 120) break;
-        }
+        size_t frames_decoded = Impl::fill_loop_cache(clip, source, MAX_FRAMES_PER_CALL);
         auto t_cache_end = std::chrono::high_resolution_clock::now();
         auto cache_ms = std::chrono::duration<double, std::milli>(t_cache_end - t_cache_start).count();
         if (cache_ms > 10.0) {
-            std::printf("[PROFILE] request_looped_frame cache_decode: %.2fms frames=%zu clip=%s\n",
-                       cache_ms, frames_decoded, clip_id.c_str());
-        }
-
-        if (clip.loop_next_decode_time >= end_time || clip.loop_frames.size() >= 120) {
-            clip.loop_cache_complete = true;
-        }
-
-        int decoder_width = source.decoder->width();
-        int decoder_height = source.decoder->height();
-        if (decoder_width != clip.width || decoder_height != clip.height) {
-            clip.width = decoder_width;
-            clip.height = decoder_height;
-            if (clip.texture_id != 0) {
-                glDeleteTextures(1, &clip.texture_id);
-            }
-            glGenTextures(1, &clip.texture_id);
-            glBindTexture(GL_TEXTURE_2D, clip.texture_id);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
-                         clip.width, clip.height, 0,
-                         GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-            glBindTexture(GL_TEXTURE_2D, 0);
+            std::printf("[PROFILE] request_looped_frame cache_decode: %.2fms frames=%zu clip=%u\n",
+                       cache_ms, frames_decoded, clip_handle.index);
         }
     }
 
@@ -498,85 +454,88 @@ void VideoEngine::request_looped_frame(const std::string& clip_id, const std::st
     auto t_end = std::chrono::high_resolution_clock::now();
     auto total_ms = std::chrono::duration<double, std::milli>(t_end - t_start).count();
     if (total_ms > 16.0) {
-        std::printf("[PROFILE] request_looped_frame TOTAL: %.2fms clip=%s\n", total_ms, clip_id.c_str());
+        std::printf("[PROFILE] request_looped_frame TOTAL: %.2fms clip=%u\n", total_ms, clip_handle.index);
     }
 }
 
 void VideoEngine::update() {
-    for (auto& [id, clip] : impl_->clips) {
-        if (clip.texture_needs_update) {
-            const uint8_t* frame_data = nullptr;
-            size_t frame_size = 0;
-
-            if (clip.use_loop_frame && clip.current_loop_frame_index < clip.loop_frames.size()) {
-                const auto& cached_frame = clip.loop_frames[clip.current_loop_frame_index];
-                frame_data = cached_frame.data();
-                frame_size = cached_frame.size();
-            } else if (!clip.frame_buffer.empty()) {
-                frame_data = clip.frame_buffer.data();
-                frame_size = clip.frame_buffer.size();
-            }
-
-            size_t expected_size = static_cast<size_t>(clip.width * clip.height * 4);
-            if (frame_data == nullptr || frame_size != expected_size) {
-                clip.texture_needs_update = false;
-                continue;
-            }
+    impl_->clips.for_each([](ClipState& clip) {
+        if (!clip.texture_needs_update) return;
+
+        const uint8_t* frame_data = nullptr;
+        size_t frame_size = 0;
+
+        if (clip.use_loop_frame && clip.current_loop_frame_index < clip.loop_frames.size()) {
+            const auto& cached_frame = clip.loop_frames[clip.current_loop_frame_index];
+            frame_data = cached_frame.data();
+            frame_size = cached_frame.size();
+        } else if (!clip.frame_buffer.empty()) {
+            frame_data = clip.frame_buffer.data();
+            frame_size = clip.frame_buffer.size();
+        }
 
-            glBindTexture(GL_TEXTURE_2D, clip.texture_id);
-            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
-                            clip.width, clip.height,
-                            GL_RGBA, GL_UNSIGNED_BYTE,
-                            frame_data);
-            glBindTexture(GL_TEXTURE_2D, 0);
+        size_t expected_size = static_cast<size_t>(clip.width * clip.height * 4);
+        if (frame_data == nullptr || frame_size != expected_size) {
             clip.texture_needs_update = false;
+            return;
         }
-    }
 
-    for (auto it = impl_->clips.begin(); it != impl_->clips.end();) {
-        bool is_active = impl_->active_clip_ids.find(it->first) != impl_->active_clip_ids.end();
-        if (!is_active && !it->second.prebuilt) {
-            if (it->second.texture_id != 0) {
-                glDeleteTextures(1, &it->second.texture_id);
-            }
-            it = impl_->clips.erase(it);
-        } else {
-            ++it;
+        glBindTexture(GL_TEXTURE_2D, clip.texture_id);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
+                        clip.width, clip.height,
+                        GL_RGBA, GL_UNSIGNED_BYTE,
+                        frame_data);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        clip.texture_needs_update = false;
+    });
+
+    impl_->clips.erase_if([](ClipState& clip) {
+        if (clip.requested_this_frame || clip.prebuilt) return false;
+        if (clip.texture_id != 0) {
+            glDeleteTextures(1, &clip.texture_id);
         }
-    }
+        return true;
+    });
+}
+
+bool VideoEngine::is_settled() const {
+    bool settled = true;
+    impl_->clips.for_each([&settled](const ClipState& clip) {
+        // Plain frames decode synchronously on request; asking again would
+        // not help one that failed.
+        if (clip.requested_this_frame && clip.use_loop_frame && !clip.loop_cache_complete) {
+            settled = false;
+        }
+    });
+    return settled;
 }
 
-uint32_t VideoEngine::get_texture(const std::string& clip_id) const {
-    auto it = impl_->clips.find(clip_id);
-    if (it == impl_->clips.end()) return 0;
-    if (!it->second.has_valid_frame) return 0;
-    return it->second.texture_id;
+uint32_t VideoEngine::get_texture(ClipHandle clip_handle) const {
+    const ClipState* clip = impl_->clips.find(clip_handle);
+    if (!clip || !clip->has_valid_frame) return 0;
+    return clip->texture_id;
 }
 
-int VideoEngine::get_texture_width(const std::string& source_id) const {
-    auto it = impl_->sources.find(source_id);
-    if (it == impl_->sources.end()) return 0;
-    return it->second.width;
+int VideoEngine::get_texture_width(SourceHandle source_handle) const {
+    const SourceState* source = impl_->sources.find(source_handle);
+    return source ? source->width : 0;
 }
 
-int VideoEngine::get_texture_height(const std::string& source_id) const {
-    auto it = impl_->sources.find(source_id);
-    if (it == impl_->sources.end()) return 0;
-    return it->second.height;
+int VideoEngine::get_texture_height(SourceHandle source_handle) const {
+    const SourceState* source = impl_->sources.find(source_handle);
+    return source ? source->height : 0;
 }
 
-double VideoEngine::get_source_duration(const std::string& source_id) const {
-    auto it = impl_->sources.find(source_id);
-    if (it == impl_->sources.end()) return 0.0;
-    if (!it->second.decoder) return 0.0;
-    return it->second.decoder->duration_seconds();
+double VideoEngine::get_source_duration(SourceHandle source_handle) const {
+    const SourceState* source = impl_->sources.find(source_handle);
+    if (!source || !source->decoder) return 0.0;
+    return source->decoder->duration_seconds();
 }
 
-double VideoEngine::get_source_fps(const std::string& source_id) const {
-    auto it = impl_->sources.find(source_id);
-    if (it == impl_->sources.end()) return 0.0;
-    if (!it->second.decoder) return 0.0;
-    return it->second.decoder->fps();
+double VideoEngine::get_source_fps(SourceHandle source_handle) const {
+    const SourceState* source = impl_->sources.find(source_handle);
+    if (!source || !source->decoder) return 0.0;
+    return source->decoder->fps();
 }
 
 void VideoEngine::set_playing(bool playing) {
@@ -588,12 +547,15 @@ void VideoEngine::set_interactive_mode(bool interactive) {
 }
 
 std::string VideoEngine::get_active_decoder_info() const {
-    for (const auto& [id, state] : impl_->sources) {
-        if (state.decoder && state.decoder->is_open()) {
-            return state.decoder->decoder_type();
+    std::string info = "None";
+    bool found = false;
+    impl_->sources.for_each([&](const SourceState& state) {
+        if (!found && state.decoder && state.decoder->is_open()) {
+            info = state.decoder->decoder_type();
+            found = true;
         }
-    }
-    return "None";
+    });
+    return info;
 }
 
 } // namespace furious
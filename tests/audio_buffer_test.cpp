@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 #include "furious/audio/audio_buffer.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
 
 namespace furious {
 namespace {
@@ -193,5 +196,123 @@ TEST_F(AudioBufferTest, MultichannelBuffer) {
     EXPECT_FLOAT_EQ(buffer.sample_at(1, 0), 0.0f);
 }
 
+TEST_F(AudioBufferTest, Int16FormatHalvesMemory) {
+    std::vector<float> samples(1000, 0.5f);
+    AudioBuffer float_buffer(std::vector<float>(samples), 44100, 2);
+    AudioBuffer int16_buffer(std::move(samples), 44100, 2, SampleFormat::Int16);
+
+    EXPECT_EQ(int16_buffer.format(), SampleFormat::Int16);
+    EXPECT_EQ(int16_buffer.frame_count(), 500u);
+    EXPECT_EQ(int16_buffer.size_bytes() * 2, float_buffer.size_bytes());
+    EXPECT_TRUE(int16_buffer.samples().empty());
+}
+
+TEST_F(AudioBufferTest, Int16FormatRoundTrip) {
+    std::vector<float> samples = {0.0f, 0.5f, -0.5f, 1.0f, -1.0f, 0.123f};
+    AudioBuffer buffer(std::vector<float>(samples), 44100, 2, SampleFormat::Int16);
+
+    for (size_t i = 0; i < samples.size(); ++i) {
+        EXPECT_NEAR(buffer.sample_at(i / 2, static_cast<uint32_t>(i % 2)), samples[i], 1.0f / 16384.0f);
+    }
+}
+
+TEST_F(AudioBufferTest, Int16FormatClampsOutOfRange) {
+    AudioBuffer buffer(std::vector<float>{2.0f, -2.0f}, 44100, 2, SampleFormat::Int16);
+    EXPECT_NEAR(buffer.sample_at(0, 0), 1.0f, 1e-4f);
+    EXPECT_NEAR(buffer.sample_at(0, 1), -1.0f, 1e-4f);
+}
+
+TEST_F(AudioBufferTest, Float16FormatRoundTrip) {
+    std::vector<float> samples = {0.0f, 0.5f, -0.25f, 1.0f, -1.0f, 0.333f, 1e-5f, 3.0f};
+    AudioBuffer buffer(std::vector<float>(samples), 44100, 2, SampleFormat::Float16);
+
+    EXPECT_EQ(buffer.format(), SampleFormat::Float16);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        float expected = samples[i];
+        EXPECT_NEAR(buffer.sample_at(i / 2, static_cast<uint32_t>(i % 2)), expected,
+                    std::fabs(expected) / 1024.0f + 1e-7f);
+    }
+}
+
+TEST_F(AudioBufferTest, ConvertedPreservesSamples) {
+    auto buffer = create_stereo_buffer(64);
+    AudioBuffer compact = buffer.converted(SampleFormat::Int16);
+    AudioBuffer restored = compact.converted(SampleFormat::Float32);
+
+    EXPECT_EQ(restored.format(), SampleFormat::Float32);
+    EXPECT_EQ(restored.frame_count(), buffer.frame_count());
+    EXPECT_EQ(restored.sample_rate(), buffer.sample_rate());
+    for (uint64_t frame = 0; frame < buffer.frame_count(); ++frame) {
+        EXPECT_NEAR(restored.sample_at(frame, 0), buffer.sample_at(frame, 0), 1e-4f);
+        EXPECT_NEAR(restored.sample_at(frame, 1), buffer.sample_at(frame, 1), 1e-4f);
+    }
+}
+
+TEST_F(AudioBufferTest, MixStereoAddsScaledFrames) {
+    AudioBuffer buffer(std::vector<float>{0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f}, 44100, 2);
+    std::vector<float> out(4, 1.0f);
+
+    buffer.mix_stereo(1, 2, 0.5f, out.data());
+
+    EXPECT_FLOAT_EQ(out[0], 1.15f);
+    EXPECT_FLOAT_EQ(out[1], 1.2f);
+    EXPECT_FLOAT_EQ(out[2], 1.25f);
+    EXPECT_FLOAT_EQ(out[3], 1.3f);
+}
+
+TEST_F(AudioBufferTest, MixStereoDuplicatesMono) {
+    AudioBuffer buffer(std::vector<float>{0.25f, 0.5f}, 44100, 1, SampleFormat::Float16);
+    std::vector<float> out(4, 0.0f);
+
+    buffer.mix_stereo(0, 2, 1.0f, out.data());
+
+    EXPECT_FLOAT_EQ(out[0], 0.25f);
+    EXPECT_FLOAT_EQ(out[1], 0.25f);
+    EXPECT_FLOAT_EQ(out[2], 0.5f);
+    EXPECT_FLOAT_EQ(out[3], 0.5f);
+}
+
+TEST_F(AudioBufferTest, MixStereoClampsToBufferEnd) {
+    AudioBuffer buffer(std::vector<float>{0.1f, 0.2f}, 44100, 2, SampleFormat::Int16);
+    std::vector<float> out(6, 0.0f);
+
+    buffer.mix_stereo(0, 3, 1.0f, out.data());
+
+    EXPECT_NEAR(out[0], 0.1f, 1e-4f);
+    EXPECT_FLOAT_EQ(out[2], 0.0f);
+    EXPECT_FLOAT_EQ(out[4], 0.0f);
+}
+
+TEST_F(AudioBufferTest, WriteAndMapFileRoundTrip) {
+    auto path = std::filesystem::temp_directory_path() / "furious_audio_buffer_test.pcm";
+    AudioBuffer buffer(std::vector<float>{0.1f, -0.2f, 0.3f, -0.4f}, 48000, 2, SampleFormat::Int16);
+
+    ASSERT_TRUE(buffer.write_file(path.string()).has_value());
+    auto mapped = AudioBuffer::map_file(path.string());
+    ASSERT_TRUE(mapped.has_value());
+
+    EXPECT_TRUE(mapped->is_mapped());
+    EXPECT_EQ(mapped->format(), SampleFormat::Int16);
+    EXPECT_EQ(mapped->sample_rate(), 48000u);
+    EXPECT_EQ(mapped->channels(), 2u);
+    EXPECT_EQ(mapped->frame_count(), 2u);
+    EXPECT_FLOAT_EQ(mapped->sample_at(1, 1), buffer.sample_at(1, 1));
+
+    std::filesystem::remove(path);
+}
+
+TEST_F(AudioBufferTest, MapFileRejectsGarbage) {
+    auto path = std::filesystem::temp_directory_path() / "furious_audio_buffer_garbage.pcm";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "definitely not a pcm cache file, just some text";
+    }
+
+    EXPECT_FALSE(AudioBuffer::map_file(path.string()).has_value());
+    EXPECT_FALSE(AudioBuffer::map_file("/nonexistent/file.pcm").has_value());
+
+    std::filesystem::remove(path);
+}
+
 } // namespace
 } // namespace furious
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "furious/audio/audio_cache.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+namespace furious {
+namespace {
+
+class AudioCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root = std::filesystem::temp_directory_path() / "furious_audio_cache_test";
+        std::filesystem::remove_all(root);
+        std::filesystem::create_directories(root);
+        source_path = (root / "source.mp4").string();
+        write_source("original contents");
+        cache = AudioCache(root / "cache");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(root);
+    }
+
+    void write_source(const std::string& contents) {
+        std::ofstream file(source_path, std::ios::binary | std::ios::trunc);
+        file << contents;
+    }
+
+    static AudioBuffer make_buffer(SampleFormat format = SampleFormat::Float32) {
+        return AudioBuffer(std::vector<float>{0.1f, 0.2f, 0.3f, 0.4f}, 44100, 2, format);
+    }
+
+    std::filesystem::path root;
+    std::string source_path;
+    AudioCache cache{std::filesystem::path{}};
+};
+
+TEST_F(AudioCacheTest, MissReturnsNull) {
+    EXPECT_EQ(cache.load(source_path, SampleFormat::Float32, 44100, 2), nullptr);
+}
+
+TEST_F(AudioCacheTest, StoreThenLoadReturnsMappedBuffer) {
+    auto stored = cache.store(source_path, make_buffer());
+    ASSERT_NE(stored, nullptr);
+    EXPECT_TRUE(stored->is_mapped());
+
+    auto loaded = cache.load(source_path, SampleFormat::Float32, 44100, 2);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_TRUE(loaded->is_mapped());
+    EXPECT_EQ(loaded->frame_count(), 2u);
+    EXPECT_FLOAT_EQ(loaded->sample_at(1, 0), 0.3f);
+}
+
+TEST_F(AudioCacheTest, EntriesAreKeyedByFormat) {
+    ASSERT_NE(cache.store(source_path, make_buffer(SampleFormat::Int16)), nullptr);
+
+    EXPECT_EQ(cache.load(source_path, SampleFormat::Float32, 44100, 2), nullptr);
+    EXPECT_NE(cache.load(source_path, SampleFormat::Int16, 44100, 2), nullptr);
+}
+
+TEST_F(AudioCacheTest, ModifiedSourceInvalidatesEntry) {
+    ASSERT_NE(cache.store(source_path, make_buffer()), nullptr);
+
+    write_source("different and longer contents");
+    std::filesystem::last_write_time(source_path,
+        std::filesystem::last_write_time(source_path) + std::chrono::seconds(5));
+
+    EXPECT_EQ(cache.load(source_path, SampleFormat::Float32, 44100, 2), nullptr);
+}
+
+TEST_F(AudioCacheTest, MissingSourceHasNoEntry) {
+    EXPECT_TRUE(cache.entry_path((root / "missing.mp4").string(), SampleFormat::Float32, 44100, 2).empty());
+    EXPECT_EQ(cache.store((root / "missing.mp4").string(), make_buffer()), nullptr);
+}
+
+TEST_F(AudioCacheTest, DisabledCacheDoesNothing) {
+    cache.set_enabled(false);
+    EXPECT_EQ(cache.store(source_path, make_buffer()), nullptr);
+    EXPECT_EQ(cache.load(source_path, SampleFormat::Float32, 44100, 2), nullptr);
+}
+
+} // namespace
+} // namespace furious
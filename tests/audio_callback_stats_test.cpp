@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include "furious/audio/audio_callback_stats.hpp"
+
+namespace furious {
+namespace {
+
+class AudioCallbackStatsTest : public ::testing::Test {
+protected:
+    AudioCallbackStats stats;
+};
+
+TEST_F(AudioCallbackStatsTest, EmptySnapshot) {
+    auto snap = stats.snapshot();
+    EXPECT_EQ(snap.history_count, 0u);
+    EXPECT_EQ(snap.callbacks, 0u);
+    EXPECT_FLOAT_EQ(snap.p99_us, 0.0f);
+}
+
+TEST_F(AudioCallbackStatsTest, RecordsLoadAndPercentiles) {
+    for (int i = 0; i < 100; ++i) {
+        stats.record(i * 10000, static_cast<float>(i + 1) * 10.0f, 10000.0f, 3);
+    }
+
+    auto snap = stats.snapshot();
+    EXPECT_EQ(snap.history_count, 100u);
+    EXPECT_EQ(snap.callbacks, 100u);
+    EXPECT_NEAR(snap.p50_us, 505.0f, 10.0f);
+    EXPECT_NEAR(snap.p99_us, 990.0f, 10.0f);
+    EXPECT_FLOAT_EQ(snap.max_us, 1000.0f);
+    EXPECT_FLOAT_EQ(snap.last_load, 0.1f);
+    EXPECT_EQ(snap.active_clips, 3u);
+    EXPECT_EQ(snap.late_callbacks, 0u);
+    EXPECT_EQ(snap.xruns, 0u);
+}
+
+TEST_F(AudioCallbackStatsTest, CountsLateCallbacks) {
+    stats.record(0, 500.0f, 1000.0f, 0);
+    stats.record(1000, 1500.0f, 1000.0f, 0);
+    EXPECT_EQ(stats.late_callbacks(), 1u);
+}
+
+TEST_F(AudioCallbackStatsTest, DetectsXrunFromCallbackGap) {
+    stats.record(0, 100.0f, 1000.0f, 0);
+    stats.record(1000, 100.0f, 1000.0f, 0);
+    stats.record(5000, 100.0f, 1000.0f, 0);
+    EXPECT_EQ(stats.xruns(), 1u);
+}
+
+TEST_F(AudioCallbackStatsTest, HistoryWrapsAtCapacity) {
+    for (size_t i = 0; i < AudioCallbackStats::CAPACITY + 10; ++i) {
+        stats.record(static_cast<int64_t>(i) * 1000, static_cast<float>(i), 1000.0f, 0);
+    }
+
+    auto snap = stats.snapshot();
+    EXPECT_EQ(snap.history_count, AudioCallbackStats::CAPACITY);
+    EXPECT_EQ(snap.callbacks, AudioCallbackStats::CAPACITY + 10);
+    EXPECT_FLOAT_EQ(snap.load_history[0], 10.0f / 1000.0f);
+}
+
+TEST_F(AudioCallbackStatsTest, ResetClearsCounters) {
+    stats.record(0, 2000.0f, 1000.0f, 0);
+    stats.reset();
+    EXPECT_EQ(stats.callbacks(), 0u);
+    EXPECT_EQ(stats.late_callbacks(), 0u);
+    EXPECT_EQ(stats.snapshot().history_count, 0u);
+}
+
+} // namespace
+} // namespace furious
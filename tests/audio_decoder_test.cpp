@@ -1,9 +1,193 @@
 #include <gtest/gtest.h>
 #include "furious/audio/audio_decoder.hpp"
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <numbers>
+#include <vector>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
 
 namespace furious {
 namespace {
 
+// 16-bit stereo PCM WAV whose left channel encodes the frame index.
+std::filesystem::path write_ramp_wav(const std::string& name, uint32_t frames) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream file(path, std::ios::binary);
+
+    auto write_u32 = [&](uint32_t v) { file.write(reinterpret_cast<const char*>(&v), 4); };
+    auto write_u16 = [&](uint16_t v) { file.write(reinterpret_cast<const char*>(&v), 2); };
+
+    uint32_t data_bytes = frames * 4;
+    file.write("RIFF", 4);
+    write_u32(36 + data_bytes);
+    file.write("WAVEfmt ", 8);
+    write_u32(16);
+    write_u16(1);
+    write_u16(2);
+    write_u32(44100);
+    write_u32(44100 * 4);
+    write_u16(4);
+    write_u16(16);
+    file.write("data", 4);
+    write_u32(data_bytes);
+    for (uint32_t i = 0; i < frames; ++i) {
+        write_u16(static_cast<uint16_t>(i % 32768));
+        write_u16(0);
+    }
+    return path;
+}
+
+// Two tones per channel, so resampling and lossy coding both have
+// something to get wrong.
+float test_signal(int64_t frame, int sample_rate, int channel) {
+    double t = static_cast<double>(frame) / sample_rate;
+    double base = channel == 0 ? 220.0 : 330.0;
+    constexpr double tau = 2.0 * std::numbers::pi;
+    return static_cast<float>(0.4 * std::sin(tau * base * t) + 0.2 * std::sin(tau * 3170.0 * t));
+}
+
+std::filesystem::path write_signal_wav(const std::string& name, uint32_t frames, uint32_t sample_rate) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream file(path, std::ios::binary);
+
+    auto write_u32 = [&](uint32_t v) { file.write(reinterpret_cast<const char*>(&v), 4); };
+    auto write_u16 = [&](uint16_t v) { file.write(reinterpret_cast<const char*>(&v), 2); };
+
+    uint32_t data_bytes = frames * 4;
+    file.write("RIFF", 4);
+    write_u32(36 + data_bytes);
+    file.write("WAVEfmt ", 8);
+    write_u32(16);
+    write_u16(1);
+    write_u16(2);
+    write_u32(sample_rate);
+    write_u32(sample_rate * 4);
+    write_u16(4);
+    write_u16(16);
+    file.write("data", 4);
+    write_u32(data_bytes);
+    for (uint32_t i = 0; i < frames; ++i) {
+        for (int channel = 0; channel < 2; ++channel) {
+            auto sample = static_cast<int16_t>(std::lround(test_signal(i, static_cast<int>(sample_rate), channel) * 32767.0f));
+            write_u16(static_cast<uint16_t>(sample));
+        }
+    }
+    return path;
+}
+
+// AAC in MP4, as in most video files: priming samples, an edit list and
+// MDCT overlap between packets. Empty path if FFmpeg lacks the encoder.
+std::filesystem::path write_aac_mp4(const std::string& name, double seconds) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    const AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_AAC);
+    if (!codec) return {};
+
+    AVFormatContext* format_ctx = nullptr;
+    if (avformat_alloc_output_context2(&format_ctx, nullptr, "mp4", path.string().c_str()) < 0) return {};
+    AVStream* stream = avformat_new_stream(format_ctx, nullptr);
+    AVCodecContext* encoder = avcodec_alloc_context3(codec);
+    encoder->sample_rate = 44100;
+    encoder->sample_fmt = AV_SAMPLE_FMT_FLTP;
+    encoder->bit_rate = 128000;
+    encoder->time_base = AVRational{1, 44100};
+    av_channel_layout_default(&encoder->ch_layout, 2);
+    if (format_ctx->oformat->flags & AVFMT_GLOBALHEADER) {
+        encoder->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+
+    bool ok = avcodec_open2(encoder, codec, nullptr) >= 0 &&
+              avcodec_parameters_from_context(stream->codecpar, encoder) >= 0 &&
+              avio_open(&format_ctx->pb, path.string().c_str(), AVIO_FLAG_WRITE) >= 0;
+    stream->time_base = encoder->time_base;
+    ok = ok && avformat_write_header(format_ctx, nullptr) >= 0;
+
+    AVFrame* frame = av_frame_alloc();
+    AVPacket* packet = av_packet_alloc();
+    auto write_packets = [&] {
+        while (avcodec_receive_packet(encoder, packet) == 0) {
+            av_packet_rescale_ts(packet, encoder->time_base, stream->time_base);
+            packet->stream_index = stream->index;
+            av_interleaved_write_frame(format_ctx, packet);
+        }
+    };
+
+    if (ok) {
+        frame->nb_samples = encoder->frame_size;
+        frame->format = encoder->sample_fmt;
+        frame->sample_rate = encoder->sample_rate;
+        av_channel_layout_copy(&frame->ch_layout, &encoder->ch_layout);
+        ok = av_frame_get_buffer(frame, 0) >= 0;
+    }
+
+    auto total = static_cast<int64_t>(seconds * 44100);
+    for (int64_t position = 0; ok && position < total; position += frame->nb_samples) {
+        av_frame_make_writable(frame);
+        for (int channel = 0; channel < 2; ++channel) {
+            auto* samples = reinterpret_cast<float*>(frame->data[channel]);
+            for (int i = 0; i < frame->nb_samples; ++i) {
+                samples[i] = test_signal(position + i, 44100, channel);
+            }
+        }
+        frame->pts = position;
+        ok = avcodec_send_frame(encoder, frame) >= 0;
+        write_packets();
+    }
+    if (ok) {
+        avcodec_send_frame(encoder, nullptr);
+        write_packets();
+        ok = av_write_trailer(format_ctx) >= 0;
+    }
+
+    av_packet_free(&packet);
+    av_frame_free(&frame);
+    avcodec_free_context(&encoder);
+    avio_closep(&format_ctx->pb);
+    avformat_free_context(format_ctx);
+    return ok ? path : std::filesystem::path{};
+}
+
+// Segments start from a fresh decoder and resampler, so away from the
+// seams the output must match a sequential pass exactly; right at a seam
+// only rounding may differ.
+void expect_segmented_matches_sequential(const std::filesystem::path& path) {
+    AudioDecoder sequential_decoder;
+    ASSERT_TRUE(sequential_decoder.open(path.string()).has_value());
+    auto sequential = sequential_decoder.extract_all(44100, 2, SampleFormat::Float32, 1);
+    ASSERT_TRUE(sequential.has_value());
+
+    AudioDecoder parallel_decoder;
+    ASSERT_TRUE(parallel_decoder.open(path.string()).has_value());
+    auto parallel = parallel_decoder.extract_all(44100, 2, SampleFormat::Float32, 4);
+    ASSERT_TRUE(parallel.has_value());
+    ASSERT_EQ(parallel->frame_count(), sequential->frame_count());
+
+    constexpr unsigned segments = 4;
+    constexpr uint64_t seam_frames = 64;
+    auto estimated = static_cast<uint64_t>(parallel_decoder.duration_seconds() * 44100);
+    auto near_seam = [&](uint64_t frame) {
+        for (unsigned i = 1; i < segments; ++i) {
+            uint64_t seam = estimated * i / segments;
+            if (frame + seam_frames >= seam && frame < seam + seam_frames) return true;
+        }
+        return false;
+    };
+
+    for (uint64_t frame = 0; frame < sequential->frame_count(); ++frame) {
+        float tolerance = near_seam(frame) ? 1e-4f : 1e-6f;
+        for (uint32_t channel = 0; channel < 2; ++channel) {
+            float expected = sequential->sample_at(frame, channel);
+            float actual = parallel->sample_at(frame, channel);
+            ASSERT_NEAR(actual, expected, tolerance) << "frame " << frame << " channel " << channel;
+        }
+    }
+}
+
 class AudioDecoderTest : public ::testing::Test {
 protected:
     AudioDecoder decoder;
@@ -43,6 +227,88 @@ TEST_F(AudioDecoderTest, ExtractAllWhenNotOpenFails) {
     EXPECT_FALSE(result.has_value());
 }
 
+TEST_F(AudioDecoderTest, StreamingWhenNotOpenFails) {
+    EXPECT_FALSE(decoder.prepare_stream().has_value());
+    std::vector<float> out(64);
+    EXPECT_EQ(decoder.read_frames(out.data(), 32), 0u);
+    EXPECT_FALSE(decoder.seek_frame(0));
+}
+
+TEST_F(AudioDecoderTest, StreamingReadsSequentialFrames) {
+    auto path = write_ramp_wav("furious_stream_read.wav", 8000);
+    ASSERT_TRUE(decoder.open(path.string()).has_value());
+    ASSERT_TRUE(decoder.prepare_stream(44100, 2).has_value());
+
+    std::vector<float> out(2 * 8000);
+    size_t first = decoder.read_frames(out.data(), 3000);
+    size_t rest = decoder.read_frames(out.data() + first * 2, 8000 - first);
+
+    EXPECT_EQ(first, 3000u);
+    EXPECT_EQ(first + rest, 8000u);
+    EXPECT_NEAR(out[2 * 4000] * 32768.0f, 4000.0f, 1.0f);
+    EXPECT_EQ(decoder.read_frames(out.data(), 16), 0u);
+
+    decoder.close();
+    std::filesystem::remove(path);
+}
+
+TEST_F(AudioDecoderTest, StreamingSeekIsFrameAccurate) {
+    auto path = write_ramp_wav("furious_stream_seek.wav", 20000);
+    ASSERT_TRUE(decoder.open(path.string()).has_value());
+    ASSERT_TRUE(decoder.prepare_stream(44100, 2).has_value());
+
+    ASSERT_TRUE(decoder.seek_frame(12345));
+    std::vector<float> out(2 * 16);
+    ASSERT_EQ(decoder.read_frames(out.data(), 16), 16u);
+    EXPECT_NEAR(out[0] * 32768.0f, 12345.0f, 1.0f);
+
+    ASSERT_TRUE(decoder.seek_frame(100));
+    ASSERT_EQ(decoder.read_frames(out.data(), 16), 16u);
+    EXPECT_NEAR(out[0] * 32768.0f, 100.0f, 1.0f);
+
+    decoder.close();
+    std::filesystem::remove(path);
+}
+
+TEST_F(AudioDecoderTest, SegmentedExtractionMatchesSequential) {
+    constexpr uint32_t frames = 44100 * 40;
+    auto path = write_ramp_wav("furious_segmented_extract.wav", frames);
+
+    ASSERT_TRUE(decoder.open(path.string()).has_value());
+    auto sequential = decoder.extract_all(44100, 2, SampleFormat::Float32, 1);
+    ASSERT_TRUE(sequential.has_value());
+
+    AudioDecoder parallel_decoder;
+    ASSERT_TRUE(parallel_decoder.open(path.string()).has_value());
+    auto parallel = parallel_decoder.extract_all(44100, 2, SampleFormat::Float32, 4);
+    ASSERT_TRUE(parallel.has_value());
+
+    ASSERT_EQ(sequential->frame_count(), frames);
+    ASSERT_EQ(parallel->frame_count(), frames);
+    for (uint64_t frame = 0; frame < frames; frame += 997) {
+        ASSERT_FLOAT_EQ(parallel->sample_at(frame, 0), sequential->sample_at(frame, 0)) << "frame " << frame;
+    }
+    EXPECT_FLOAT_EQ(parallel->sample_at(frames - 1, 0), sequential->sample_at(frames - 1, 0));
+
+    decoder.close();
+    parallel_decoder.close();
+    std::filesystem::remove(path);
+}
+
+TEST_F(AudioDecoderTest, SegmentedExtractionMatchesSequentialWhenResampling) {
+    auto path = write_signal_wav("furious_segmented_resampled.wav", 48000 * 40, 48000);
+    expect_segmented_matches_sequential(path);
+    std::filesystem::remove(path);
+}
+
+TEST_F(AudioDecoderTest, SegmentedExtractionMatchesSequentialForLossyCodec) {
+    auto path = write_aac_mp4("furious_segmented_lossy.mp4", 40.0);
+    if (path.empty()) {
+        GTEST_SKIP() << "FFmpeg has no AAC encoder";
+    }
+    expect_segmented_matches_sequential(path);
+    std::filesystem::remove(path);
+}
 
 TEST_F(AudioDecoderTest, MultipleCloseCallsAreNoOp) {
     decoder.close();
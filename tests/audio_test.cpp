@@ -2,11 +2,51 @@
 #include "furious/audio/audio_clip.hpp"
 #include "furious/audio/audio_engine.hpp"
 #include "furious/audio/audio_buffer.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <memory>
+#include <thread>
+#include <vector>
 
 namespace furious {
 namespace {
 
+// 16-bit stereo 44.1 kHz WAV holding `frames` frames of silence while its
+// header claims `claimed_frames`, like a file whose length was estimated
+// wrong.
+std::filesystem::path write_truncated_wav(const std::string& name, uint32_t frames, uint32_t claimed_frames) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream file(path, std::ios::binary);
+
+    auto write_u32 = [&](uint32_t v) { file.write(reinterpret_cast<const char*>(&v), 4); };
+    auto write_u16 = [&](uint16_t v) { file.write(reinterpret_cast<const char*>(&v), 2); };
+
+    file.write("RIFF", 4);
+    write_u32(36 + claimed_frames * 4);
+    file.write("WAVEfmt ", 8);
+    write_u32(16);
+    write_u16(1);
+    write_u16(2);
+    write_u32(44100);
+    write_u32(44100 * 4);
+    write_u16(4);
+    write_u16(16);
+    file.write("data", 4);
+    write_u32(claimed_frames * 4);
+    std::vector<char> silence(static_cast<size_t>(frames) * 4, 0);
+    file.write(silence.data(), static_cast<std::streamsize>(silence.size()));
+    return path;
+}
+
+bool wait_for_exact_length(const AudioClip& clip) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!clip.length_is_exact() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return clip.length_is_exact();
+}
+
 class AudioClipTest : public ::testing::Test {
 protected:
     AudioClip clip;
@@ -26,11 +66,47 @@ TEST_F(AudioClipTest, LoadNonexistentFileFails) {
     EXPECT_FALSE(clip.is_loaded());
 }
 
+TEST_F(AudioClipTest, MixIntoWithoutStreamIsSilent) {
+    std::vector<float> out(8, 0.0f);
+    EXPECT_EQ(clip.mix_into(0, 4, out.data()), 0u);
+    EXPECT_EQ(clip.buffered_frames(), 0u);
+    for (float sample : out) {
+        EXPECT_FLOAT_EQ(sample, 0.0f);
+    }
+}
+
+TEST_F(AudioClipTest, LengthIsCorrectedAtEndOfStream) {
+    auto path = write_truncated_wav("furious_audio_clip_truncated.wav", 22050, 44100);
+    ASSERT_TRUE(clip.load(path.string()));
+
+    ASSERT_TRUE(wait_for_exact_length(clip));
+    EXPECT_EQ(clip.total_frames(), 22050u);
+    EXPECT_NEAR(clip.duration_seconds(), 0.5, 1e-9);
+
+    clip.unload();
+    std::filesystem::remove(path);
+}
+
 class AudioEngineTest : public ::testing::Test {
 protected:
     AudioEngine engine;
 };
 
+TEST_F(AudioEngineTest, UntrimmedClipEndFollowsCorrectedLength) {
+    auto path = write_truncated_wav("furious_audio_engine_truncated.wav", 22050, 44100);
+    ASSERT_TRUE(engine.load_clip(path.string()));
+
+    ASSERT_TRUE(wait_for_exact_length(*engine.clip()));
+    EXPECT_EQ(engine.clip_end_frame(), 22050u);
+    EXPECT_NEAR(engine.clip_end_seconds(), 0.5, 1e-9);
+
+    engine.set_clip_end_seconds(0.25);
+    EXPECT_EQ(engine.clip_end_frame(), 11025u);
+
+    engine.unload_clip();
+    std::filesystem::remove(path);
+}
+
 TEST_F(AudioEngineTest, DefaultState) {
     EXPECT_FALSE(engine.is_playing());
     EXPECT_FALSE(engine.has_clip());
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include "furious/scripting/automation_baker.hpp"
+#include "furious/core/pattern_library.hpp"
+#include "furious/core/tempo.hpp"
+#include "furious/core/timeline_data.hpp"
+#include <string>
+
+namespace furious {
+namespace {
+
+class AutomationBakerTest : public ::testing::Test {
+protected:
+    TimelineData timeline;
+    PatternLibrary library;
+    Tempo tempo{120.0};
+    AutomationBaker baker;
+
+    void SetUp() override {
+        timeline.add_track("Track 1");
+        baker.set_timeline_data(&timeline);
+        baker.set_pattern_library(&library);
+        baker.set_tempo(&tempo);
+    }
+
+    TimelineClip make_clip(const std::string& id, double start_beat, double duration_beats) {
+        TimelineClip clip;
+        clip.id = id;
+        clip.source_id = "src";
+        clip.start_beat = start_beat;
+        clip.duration_beats = duration_beats;
+        return clip;
+    }
+
+    const BakedClipAutomation* baked(const std::string& clip_id) {
+        const TimelineClip* clip = timeline.find_clip(clip_id);
+        return clip ? baker.find(timeline.handle_of(*clip)) : nullptr;
+    }
+};
+
+TEST_F(AutomationBakerTest, BakesOneSamplePerSubdivision) {
+    TimelineClip clip = make_clip("a", 2.0, 4.0);
+    clip.position_x = 10.0f;
+    timeline.add_clip(clip);
+
+    EXPECT_EQ(baker.bake_range(0.0, 8.0), 1u);
+
+    const BakedClipAutomation* result = baked("a");
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(result->samples.size(), 16u);
+    EXPECT_FLOAT_EQ(result->samples[0].position_x, 10.0f);
+    EXPECT_FLOAT_EQ(result->samples[0].source_seconds, 0.0f);
+    EXPECT_FLOAT_EQ(result->samples[2].source_seconds, 0.25f);
+}
+
+TEST_F(AutomationBakerTest, OnlyClipsInRangeAreBaked) {
+    timeline.add_clip(make_clip("a", 0.0, 2.0));
+    timeline.add_clip(make_clip("b", 10.0, 2.0));
+
+    EXPECT_EQ(baker.bake_range(0.0, 4.0), 1u);
+    EXPECT_NE(baked("a"), nullptr);
+    EXPECT_EQ(baked("b"), nullptr);
+}
+
+TEST_F(AutomationBakerTest, UnchangedClipsAreCached) {
+    timeline.add_clip(make_clip("a", 0.0, 4.0));
+
+    EXPECT_EQ(baker.bake_range(0.0, 4.0), 1u);
+    EXPECT_EQ(baker.bake_range(0.0, 4.0), 0u);
+
+    timeline.find_clip("a")->position_x = 5.0f;
+    EXPECT_EQ(baker.bake_range(0.0, 4.0), 1u);
+    EXPECT_FLOAT_EQ(baked("a")->samples[0].position_x, 5.0f);
+
+    tempo.set_bpm(90.0);
+    EXPECT_EQ(baker.bake_range(0.0, 4.0), 1u);
+}
+
+TEST_F(AutomationBakerTest, MovingAClipToAnotherTrackRebakes) {
+    timeline.add_track("Track 2");
+    timeline.add_clip(make_clip("a", 0.0, 4.0));
+    ASSERT_EQ(baker.bake_range(0.0, 4.0), 1u);
+
+    timeline.set_clip_span("a", 0.0, 4.0, 1);
+    EXPECT_EQ(baker.bake_range(0.0, 4.0), 1u);
+
+    timeline.find_clip("a")->source_id = "other";
+    EXPECT_EQ(baker.bake_range(0.0, 4.0), 1u);
+}
+
+TEST_F(AutomationBakerTest, RemovedClipsAreDroppedFromTheCache) {
+    timeline.add_clip(make_clip("a", 0.0, 2.0));
+    timeline.add_clip(make_clip("b", 0.0, 2.0));
+    ASSERT_EQ(baker.bake_range(0.0, 4.0), 2u);
+    ClipHandle removed = timeline.handle_of(*timeline.find_clip("b"));
+
+    timeline.remove_clip("b");
+    EXPECT_EQ(baker.bake_range(0.0, 4.0), 0u);
+    EXPECT_EQ(baker.find(removed), nullptr);
+    EXPECT_NE(baked("a"), nullptr);
+}
+
+TEST_F(AutomationBakerTest, PatternEditsInvalidateBakedClips) {
+    std::string id = library.create_pattern("Scale");
+    library.find_pattern(id)->triggers.push_back({0, PatternTargetProperty::ScaleX, 2.0f});
+
+    TimelineClip clip = make_clip("a", 0.0, 4.0);
+    clip.patterns.push_back({id, true, 0});
+    timeline.add_clip(clip);
+
+    baker.bake_range(0.0, 4.0);
+    EXPECT_FLOAT_EQ(baked("a")->samples[5].scale_x, 2.0f);
+    EXPECT_EQ(baker.bake_range(0.0, 4.0), 0u);
+
+    library.find_pattern(id)->triggers[0].value = 3.0f;
+    library.mark_pattern_modified(id);
+    EXPECT_EQ(baker.bake_range(0.0, 4.0), 1u);
+    EXPECT_FLOAT_EQ(baked("a")->samples[5].scale_x, 3.0f);
+}
+
+TEST_F(AutomationBakerTest, RestartTriggersAreMarked) {
+    std::string id = library.create_pattern("Restart");
+    Pattern* pattern = library.find_pattern(id);
+    pattern->scale_x_settings.restart_on_trigger = true;
+    pattern->triggers.push_back({0, PatternTargetProperty::ScaleX, 1.0f});
+    pattern->triggers.push_back({4, PatternTargetProperty::ScaleX, 2.0f});
+
+    TimelineClip clip = make_clip("a", 0.0, 2.0);
+    clip.patterns.push_back({id, true, 0});
+    timeline.add_clip(clip);
+
+    baker.bake_range(0.0, 2.0);
+    const BakedClipAutomation* result = baked("a");
+    ASSERT_NE(result, nullptr);
+    EXPECT_TRUE(result->samples[0].restart);
+    EXPECT_FALSE(result->samples[1].restart);
+    EXPECT_TRUE(result->samples[4].restart);
+    EXPECT_TRUE(result->samples[5].looped);
+}
+
+TEST_F(AutomationBakerTest, SampleAtMapsBeatsToSubdivisions) {
+    timeline.add_clip(make_clip("a", 1.0, 1.0));
+    baker.bake_range(0.0, 2.0);
+
+    const BakedClipAutomation* result = baked("a");
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(result->sample_at(0.5), nullptr);
+    EXPECT_EQ(result->sample_at(1.0), &result->samples[0]);
+    EXPECT_EQ(result->sample_at(1.6), &result->samples[2]);
+    EXPECT_EQ(result->sample_at(2.0), nullptr);
+}
+
+TEST_F(AutomationBakerTest, ManyClipsBakeAcrossThreads) {
+    for (int i = 0; i < 64; ++i) {
+        TimelineClip clip = make_clip("clip" + std::to_string(i), i * 32.0, 32.0);
+        clip.rotation = static_cast<float>(i);
+        timeline.add_clip(clip);
+    }
+
+    EXPECT_EQ(baker.bake_range(0.0, 64 * 32.0), 64u);
+    for (int i = 0; i < 64; ++i) {
+        const BakedClipAutomation* result = baked("clip" + std::to_string(i));
+        ASSERT_NE(result, nullptr);
+        ASSERT_EQ(result->samples.size(), 128u);
+        EXPECT_FLOAT_EQ(result->samples.back().rotation, static_cast<float>(i));
+    }
+}
+
+} // namespace
+} // namespace furious
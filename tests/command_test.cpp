@@ -191,3 +191,32 @@ TEST_F(CommandHistoryTest, EmptyHistoryDescriptionsReturnEmpty) {
     EXPECT_EQ(history.undo_description(), "");
     EXPECT_EQ(history.redo_description(), "");
 }
+
+TEST_F(CommandHistoryTest, CompoundCommandIsOneUndoStep) {
+    TimelineClip existing;
+    existing.id = "existing";
+    data.add_clip(existing);
+
+    auto compound = std::make_unique<CompoundCommand>("Generate clips");
+    for (int i = 0; i < 3; ++i) {
+        TimelineClip clip;
+        clip.id = "clip-" + std::to_string(i);
+        clip.start_beat = i;
+        compound->add(std::make_unique<AddClipCommand>(data, clip));
+    }
+    compound->add(std::make_unique<RemoveClipCommand>(data, "existing"));
+    EXPECT_EQ(compound->size(), 4u);
+
+    history.execute(std::move(compound));
+    EXPECT_EQ(data.clips().size(), 3u);
+    EXPECT_EQ(data.find_clip("existing"), nullptr);
+    EXPECT_EQ(history.undo_description(), "Generate clips");
+
+    history.undo();
+    EXPECT_EQ(data.clips().size(), 1u);
+    EXPECT_NE(data.find_clip("existing"), nullptr);
+    EXPECT_FALSE(history.can_undo());
+
+    history.redo();
+    EXPECT_EQ(data.clips().size(), 3u);
+}
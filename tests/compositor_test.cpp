@@ -0,0 +1,62 @@
+#include "furious/video/compositor.hpp"
+#include <gtest/gtest.h>
+
+using namespace furious;
+
+TEST(CompositorTest, PlaceClipAtPositionAndScale) {
+    ClipPlacement placement;
+    placement.position_x = 10.0f;
+    placement.position_y = 20.0f;
+    placement.scale_x = 0.5f;
+    placement.scale_y = 2.0f;
+
+    ClipQuad quad = place_clip(placement, 100, 50);
+
+    EXPECT_FLOAT_EQ(quad.corners[0].x, 10.0f);
+    EXPECT_FLOAT_EQ(quad.corners[0].y, 20.0f);
+    EXPECT_FLOAT_EQ(quad.corners[2].x, 60.0f);
+    EXPECT_FLOAT_EQ(quad.corners[2].y, 120.0f);
+    EXPECT_FLOAT_EQ(quad.uvs[0].x, 0.0f);
+    EXPECT_FLOAT_EQ(quad.uvs[2].y, 1.0f);
+}
+
+TEST(CompositorTest, RotationTurnsAboutTheCentre) {
+    ClipPlacement placement;
+    placement.rotation = 90.0f;
+
+    ClipQuad quad = place_clip(placement, 100, 50);
+
+    // Centre stays at (50, 25); the top-left corner swings to the top-right.
+    EXPECT_NEAR(quad.corners[0].x, 75.0f, 1e-3f);
+    EXPECT_NEAR(quad.corners[0].y, -25.0f, 1e-3f);
+    EXPECT_TRUE(quad.contains(50.0f, 25.0f));
+    EXPECT_TRUE(quad.contains(50.0f, 70.0f));
+    EXPECT_FALSE(quad.contains(5.0f, 25.0f));
+}
+
+TEST(CompositorTest, FlipsAndNegativeScalesSwapUvs) {
+    ClipPlacement placement;
+    placement.flip_h = true;
+    ClipQuad flipped = place_clip(placement, 10, 10);
+    EXPECT_FLOAT_EQ(flipped.uvs[0].x, 1.0f);
+    EXPECT_FLOAT_EQ(flipped.uvs[1].x, 0.0f);
+
+    placement.scale_x = -1.0f;
+    ClipQuad restored = place_clip(placement, 10, 10);
+    EXPECT_FLOAT_EQ(restored.uvs[0].x, 0.0f);
+    EXPECT_FLOAT_EQ(restored.corners[1].x, 10.0f);
+
+    placement = ClipPlacement{};
+    placement.scale_y = -1.0f;
+    ClipQuad upside_down = place_clip(placement, 10, 10);
+    EXPECT_FLOAT_EQ(upside_down.uvs[0].y, 1.0f);
+    EXPECT_FLOAT_EQ(upside_down.uvs[3].y, 0.0f);
+}
+
+TEST(CompositorTest, ContainsIncludesEdgesOnly) {
+    ClipQuad quad = place_clip(ClipPlacement{}, 10, 10);
+    EXPECT_TRUE(quad.contains(0.0f, 0.0f));
+    EXPECT_TRUE(quad.contains(10.0f, 5.0f));
+    EXPECT_FALSE(quad.contains(10.5f, 5.0f));
+    EXPECT_FALSE(quad.contains(5.0f, -0.5f));
+}
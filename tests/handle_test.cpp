@@ -0,0 +1,158 @@
+#include "furious/core/handle.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace furious;
+
+TEST(HandleTableTest, DefaultHandleIsInvalid) {
+    ClipHandle handle;
+    EXPECT_FALSE(handle.is_valid());
+
+    HandleTable<ClipTag> table;
+    EXPECT_EQ(table.slot(handle), HandleTable<ClipTag>::NO_SLOT);
+}
+
+TEST(HandleTableTest, InternReturnsSameHandleForSameId) {
+    HandleTable<ClipTag> table;
+    ClipHandle a = table.intern("clip-a");
+    ClipHandle b = table.intern("clip-b");
+
+    EXPECT_TRUE(a.is_valid());
+    EXPECT_NE(a, b);
+    EXPECT_EQ(table.intern("clip-a"), a);
+    EXPECT_EQ(table.find("clip-a"), a);
+    EXPECT_FALSE(table.find("missing").is_valid());
+}
+
+TEST(HandleTableTest, BindAndUnbindSlots) {
+    HandleTable<ClipTag> table;
+    ClipHandle handle = table.intern("clip");
+    EXPECT_EQ(table.slot(handle), HandleTable<ClipTag>::NO_SLOT);
+
+    table.bind(handle, 3);
+    EXPECT_EQ(table.slot(handle), 3u);
+
+    table.unbind_all();
+    EXPECT_EQ(table.slot(handle), HandleTable<ClipTag>::NO_SLOT);
+    EXPECT_EQ(table.find("clip"), handle);
+}
+
+TEST(HandleTableTest, ClearRetiresOutstandingHandles) {
+    HandleTable<ClipTag> table;
+    ClipHandle old_handle = table.intern("clip");
+    table.bind(old_handle, 0);
+
+    table.clear();
+    ClipHandle new_handle = table.intern("clip");
+    table.bind(new_handle, 0);
+
+    EXPECT_EQ(new_handle.index, old_handle.index);
+    EXPECT_NE(new_handle.generation, old_handle.generation);
+    EXPECT_FALSE(table.is_current(old_handle));
+    EXPECT_EQ(table.slot(old_handle), HandleTable<ClipTag>::NO_SLOT);
+    EXPECT_EQ(table.slot(new_handle), 0u);
+}
+
+TEST(HandleTableTest, HandlesDoNotResolveInOtherTables) {
+    HandleTable<SourceTag> first;
+    HandleTable<SourceTag> second;
+    SourceHandle handle = first.intern("src");
+    second.intern("src");
+    second.bind(second.find("src"), 0);
+
+    EXPECT_EQ(second.slot(handle), HandleTable<SourceTag>::NO_SLOT);
+}
+
+TEST(HandleTableTest, ReleaseUnboundFreesIndexWithNewGeneration) {
+    HandleTable<ClipTag> table;
+    ClipHandle kept = table.intern("kept");
+    ClipHandle removed = table.intern("removed");
+    table.bind(kept, 0);
+    table.bind(removed, 1);
+
+    table.unbind_all();
+    table.bind(kept, 0);
+    table.release_unbound();
+
+    EXPECT_TRUE(table.is_current(kept));
+    EXPECT_FALSE(table.is_current(removed));
+    EXPECT_FALSE(table.find("removed").is_valid());
+    EXPECT_EQ(table.live_count(), 1u);
+
+    ClipHandle reused = table.intern("removed");
+    EXPECT_EQ(reused.index, removed.index);
+    EXPECT_NE(reused.generation, removed.generation);
+    EXPECT_EQ(table.size(), 2u);
+}
+
+TEST(HandleMapTest, InsertFindErase) {
+    HandleTable<ClipTag> table;
+    HandleMap<ClipTag, std::string> map;
+    ClipHandle a = table.intern("a");
+    ClipHandle b = table.intern("b");
+
+    map.replace(a, "first");
+    map[b] = "second";
+
+    ASSERT_NE(map.find(a), nullptr);
+    EXPECT_EQ(*map.find(a), "first");
+    EXPECT_EQ(*map.find(b), "second");
+    EXPECT_EQ(map.size(), 2u);
+
+    map.erase(a);
+    EXPECT_EQ(map.find(a), nullptr);
+    EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(HandleMapTest, StaleGenerationIsAbsentAndReplaceReturnsIt) {
+    HandleTable<ClipTag> table;
+    HandleMap<ClipTag, int> map;
+    ClipHandle old_handle = table.intern("clip");
+    map.replace(old_handle, 7);
+
+    table.clear();
+    ClipHandle new_handle = table.intern("other");
+    ASSERT_EQ(new_handle.index, old_handle.index);
+
+    EXPECT_EQ(map.find(new_handle), nullptr);
+    auto displaced = map.replace(new_handle, 9);
+    ASSERT_TRUE(displaced.has_value());
+    EXPECT_EQ(*displaced, 7);
+    EXPECT_EQ(map.find(old_handle), nullptr);
+    EXPECT_EQ(*map.find(new_handle), 9);
+    EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(HandleMapTest, PruneReleasesDeadEntriesAndTrims) {
+    HandleTable<ClipTag> table;
+    HandleMap<ClipTag, int> map;
+    ClipHandle a = table.intern("a");
+    ClipHandle b = table.intern("b");
+    map.replace(a, 1);
+    map.replace(b, 2);
+
+    std::vector<int> released;
+    map.prune([&](ClipHandle handle) { return handle == a; },
+              [&](int value) { released.push_back(value); });
+
+    EXPECT_EQ(released, std::vector<int>{2});
+    EXPECT_EQ(map.size(), 1u);
+    EXPECT_EQ(*map.find(a), 1);
+    EXPECT_EQ(map.find(b), nullptr);
+}
+
+TEST(HandleMapTest, EraseIfAndForEach) {
+    HandleTable<ClipTag> table;
+    HandleMap<ClipTag, int> map;
+    for (int i = 0; i < 4; ++i) {
+        map.replace(table.intern("clip" + std::to_string(i)), i);
+    }
+
+    map.erase_if([](int value) { return value % 2 == 0; });
+
+    int sum = 0;
+    map.for_each([&](int value) { sum += value; });
+    EXPECT_EQ(sum, 1 + 3);
+    EXPECT_EQ(map.size(), 2u);
+}
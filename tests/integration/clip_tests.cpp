@@ -78,7 +78,7 @@ void RegisterClipTests(ImGuiTestEngine* engine) {
         auto* clip = vars.timeline_data.find_clip("movable");
         IM_CHECK(clip != nullptr);
 
-        clip->start_beat = 8.0;
+        vars.timeline_data.set_clip_span("movable", 8.0, clip->duration_beats, clip->track_index);
         ctx->Yield();
 
         IM_CHECK_EQ(clip->start_beat, 8.0);
@@ -105,11 +105,11 @@ void RegisterClipTests(ImGuiTestEngine* engine) {
         auto* clip = vars.timeline_data.find_clip("track-mover");
         IM_CHECK_EQ(clip->track_index, 0u);
 
-        clip->track_index = 1;
+        vars.timeline_data.set_clip_span("track-mover", clip->start_beat, clip->duration_beats, 1);
         ctx->Yield();
         IM_CHECK_EQ(clip->track_index, 1u);
 
-        clip->track_index = 2;
+        vars.timeline_data.set_clip_span("track-mover", clip->start_beat, clip->duration_beats, 2);
         ctx->Yield();
         IM_CHECK_EQ(clip->track_index, 2u);
     };
@@ -133,7 +133,7 @@ void RegisterClipTests(ImGuiTestEngine* engine) {
         IM_CHECK_EQ(clip->duration_beats, 8.0);
         IM_CHECK_EQ(clip->start_beat, 0.0);
 
-        clip->duration_beats = 4.0;
+        vars.timeline_data.set_clip_span("trimmable", clip->start_beat, 4.0, clip->track_index);
         ctx->Yield();
 
         IM_CHECK_EQ(clip->duration_beats, 4.0);
@@ -161,8 +161,7 @@ void RegisterClipTests(ImGuiTestEngine* engine) {
         auto* c = vars.timeline_data.find_clip("left-trim");
         double original_end = c->end_beat();
 
-        c->start_beat = 2.0;
-        c->duration_beats = 6.0;
+        vars.timeline_data.set_clip_span("left-trim", 2.0, 6.0, c->track_index);
         c->source_start_seconds = 1.0;
         ctx->Yield();
 
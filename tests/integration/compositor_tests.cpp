@@ -0,0 +1,114 @@
+#include "imgui.h"
+#include "imgui_te_engine.h"
+#include "imgui_te_context.h"
+#include "furious/video/compositor.hpp"
+#include "furious/video/gl_api.hpp"
+#include <array>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr int TARGET_SIZE = 64;
+constexpr int CLIP_SIZE = 4;
+
+struct CompositorTestVars {
+    bool ran = false;
+    bool initialized = false;
+    int batch_size = 0;
+    std::vector<std::pair<int, int>> draw_calls;  // layers, draw calls
+    std::array<uint8_t, 4> centre{};
+};
+
+GLuint make_texture(int width, int height, const void* pixels) {
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+// GL calls must run on the thread that owns the context, so the draws
+// happen in the GUI function and the test function only checks them.
+void run_draws(CompositorTestVars& vars) {
+    if (!furious::load_gl_api()) return;
+    const furious::GlApi& gl = furious::gl_api();
+
+    furious::Compositor compositor;
+    vars.initialized = compositor.initialize();
+    if (!vars.initialized) return;
+    vars.batch_size = compositor.batch_size();
+
+    GLuint target = make_texture(TARGET_SIZE, TARGET_SIZE, nullptr);
+    GLuint framebuffer = 0;
+    gl.GenFramebuffers(1, &framebuffer);
+    gl.BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    gl.FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target, 0);
+    gl.BindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    std::vector<uint8_t> red(CLIP_SIZE * CLIP_SIZE * 4);
+    for (size_t i = 0; i < red.size(); i += 4) {
+        red[i] = 255;
+        red[i + 3] = 255;
+    }
+    GLuint clip = make_texture(CLIP_SIZE, CLIP_SIZE, red.data());
+
+    // Each layer covers the whole target, so any layer count leaves it red.
+    furious::ClipPlacement placement;
+    placement.scale_x = static_cast<float>(TARGET_SIZE / CLIP_SIZE);
+    placement.scale_y = placement.scale_x;
+    furious::CompositeLayer layer{clip, CLIP_SIZE, CLIP_SIZE, furious::place_clip(placement, CLIP_SIZE, CLIP_SIZE)};
+
+    int batch = vars.batch_size;
+    for (int count : {1, batch - 1, batch, batch + 1, 2 * batch + 3}) {
+        if (count <= 0) continue;
+        std::vector<furious::CompositeLayer> layers(static_cast<size_t>(count), layer);
+        compositor.draw(framebuffer, TARGET_SIZE, TARGET_SIZE, layers);
+        vars.draw_calls.emplace_back(count, compositor.draw_calls());
+    }
+
+    gl.BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glReadPixels(TARGET_SIZE / 2, TARGET_SIZE / 2, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, vars.centre.data());
+    gl.BindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    compositor.shutdown();
+    gl.DeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &clip);
+    glDeleteTextures(1, &target);
+}
+
+}
+
+void RegisterCompositorTests(ImGuiTestEngine* engine) {
+    ImGuiTest* t = nullptr;
+
+    t = IM_REGISTER_TEST(engine, "compositor", "one_draw_per_batch");
+    t->SetVarsDataType<CompositorTestVars>();
+    t->GuiFunc = [](ImGuiTestContext* ctx) {
+        auto& vars = ctx->GetVars<CompositorTestVars>();
+        if (!vars.ran) {
+            vars.ran = true;
+            run_draws(vars);
+        }
+        ImGui::Begin("Compositor Test");
+        ImGui::End();
+    };
+    t->TestFunc = [](ImGuiTestContext* ctx) {
+        auto& vars = ctx->GetVars<CompositorTestVars>();
+        ctx->Yield();
+
+        IM_CHECK(vars.initialized);
+        IM_CHECK_GE(vars.batch_size, 16);
+        IM_CHECK_LE(vars.batch_size, 32);
+        IM_CHECK(!vars.draw_calls.empty());
+        for (const auto& [layers, draw_calls] : vars.draw_calls) {
+            IM_CHECK_EQ(draw_calls, (layers + vars.batch_size - 1) / vars.batch_size);
+        }
+        IM_CHECK_EQ(static_cast<int>(vars.centre[0]), 255);
+        IM_CHECK_EQ(static_cast<int>(vars.centre[1]), 0);
+        IM_CHECK_EQ(static_cast<int>(vars.centre[2]), 0);
+    };
+}
@@ -20,6 +20,7 @@ void RegisterUserFlowTests(ImGuiTestEngine* engine);
 void RegisterUndoRedoTests(ImGuiTestEngine* engine);
 void RegisterPatternTests(ImGuiTestEngine* engine);
 void RegisterAudioEngineTests(ImGuiTestEngine* engine);
+void RegisterCompositorTests(ImGuiTestEngine* engine);
 
 namespace {
 
@@ -131,6 +132,7 @@ int main(int argc, char** argv) {
     RegisterUndoRedoTests(engine);
     RegisterPatternTests(engine);
     RegisterAudioEngineTests(engine);
+    RegisterCompositorTests(engine);
 
     ImGuiTestEngine_Start(engine, ImGui::GetCurrentContext());
     ImGuiTestEngine_InstallDefaultCrashHandler();
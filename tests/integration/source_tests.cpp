@@ -4,12 +4,17 @@
 #include "furious/video/source_library.hpp"
 #include "furious/core/timeline_data.hpp"
 #include "furious/core/media_source.hpp"
+#include <filesystem>
 
 namespace {
 
 struct SourceTestVars {
     furious::SourceLibrary library;
     furious::TimelineData timeline_data;
+
+    SourceTestVars() {
+        library.audio_cache().set_directory(std::filesystem::temp_directory_path() / "furious_integration_audio_cache");
+    }
 };
 
 furious::MediaSource make_source(const std::string& id, const std::string& name, furious::MediaType type) {
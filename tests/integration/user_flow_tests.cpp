@@ -15,6 +15,8 @@ struct UserFlowTestVars {
 
     UserFlowTestVars() {
         main_window = std::make_unique<furious::MainWindow>();
+        main_window->source_library().audio_cache().set_directory(
+            std::filesystem::temp_directory_path() / "furious_integration_audio_cache");
         test_project_path = "/tmp/furious_test_project.furious";
     }
 
@@ -157,7 +159,8 @@ void RegisterUserFlowTests(ImGuiTestEngine* engine) {
         IM_CHECK(added_clip != nullptr);
         IM_CHECK_EQ(added_clip->track_index, 0u);
 
-        added_clip->track_index = 1;
+        mw.timeline_data().set_clip_span("test-clip-1", added_clip->start_beat,
+                                         added_clip->duration_beats, 1);
         ctx->Yield();
 
         IM_CHECK_EQ(added_clip->track_index, 1u);
@@ -171,7 +174,8 @@ void RegisterUserFlowTests(ImGuiTestEngine* engine) {
         IM_CHECK_EQ(mw.timeline_data().track_count(), before_delete - 1);
         ctx->Yield();
 
-        added_clip->track_index = 0;
+        mw.timeline_data().set_clip_span("test-clip-1", added_clip->start_beat,
+                                         added_clip->duration_beats, 0);
         IM_CHECK_EQ(added_clip->track_index, 0u);
 
         auto track0_clips = mw.timeline_data().clips_on_track(0);
@@ -274,7 +278,8 @@ void RegisterUserFlowTests(ImGuiTestEngine* engine) {
         ctx->Yield();
 
         double original_duration = added_clip->duration_beats;
-        added_clip->duration_beats = 64.0;
+        mw.timeline_data().set_clip_span(added_clip->id, added_clip->start_beat, 64.0,
+                                         added_clip->track_index);
         IM_CHECK_EQ(added_clip->duration_beats, 64.0);
         IM_CHECK_GT(added_clip->duration_beats, original_duration);
         ctx->Yield();
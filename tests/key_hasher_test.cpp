@@ -0,0 +1,41 @@
+#include "furious/core/key_hasher.hpp"
+#include <gtest/gtest.h>
+
+using namespace furious;
+
+namespace {
+
+uint64_t hash_of(const std::unordered_map<std::string, std::string>& entries) {
+    KeyHasher hasher;
+    hasher.add(entries);
+    return hasher.value();
+}
+
+} // namespace
+
+TEST(KeyHasherTest, StringsAreTerminated) {
+    KeyHasher split;
+    split.add("ab");
+    split.add("c");
+    KeyHasher joined;
+    joined.add("a");
+    joined.add("bc");
+    EXPECT_NE(split.value(), joined.value());
+}
+
+TEST(KeyHasherTest, MapsHashIndependentlyOfIterationOrder) {
+    std::unordered_map<std::string, std::string> forward;
+    std::unordered_map<std::string, std::string> backward;
+    backward.reserve(64);
+    for (int i = 0; i < 12; ++i) {
+        forward["param " + std::to_string(i)] = std::to_string(i * 3);
+        backward["param " + std::to_string(11 - i)] = std::to_string((11 - i) * 3);
+    }
+    EXPECT_EQ(hash_of(forward), hash_of(backward));
+
+    backward["param 4"] = "13";
+    EXPECT_NE(hash_of(forward), hash_of(backward));
+
+    // A swapped name and value is a different entry.
+    EXPECT_NE(hash_of({{"a", "b"}}), hash_of({{"b", "a"}}));
+}
@@ -0,0 +1,53 @@
+#include "furious/core/lru_cache.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace furious;
+
+TEST(LruCacheTest, FindReturnsInsertedValues) {
+    LruCache<int, std::string> cache(4);
+    cache.insert(1, "one");
+    cache.insert(2, "two");
+
+    ASSERT_NE(cache.find(1), nullptr);
+    EXPECT_EQ(*cache.find(1), "one");
+    EXPECT_EQ(*cache.find(2), "two");
+    EXPECT_EQ(cache.find(3), nullptr);
+    EXPECT_EQ(cache.size(), 2u);
+}
+
+TEST(LruCacheTest, InsertOverwritesExistingKey) {
+    LruCache<int, int> cache(4);
+    cache.insert(1, 10);
+    cache.insert(1, 11);
+
+    EXPECT_EQ(*cache.find(1), 11);
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST(LruCacheTest, EvictsLeastRecentlyUsed) {
+    LruCache<int, int> cache(3);
+    cache.insert(1, 1);
+    cache.insert(2, 2);
+    cache.insert(3, 3);
+
+    (void)cache.find(1);
+    cache.insert(4, 4);
+
+    EXPECT_EQ(cache.size(), 3u);
+    EXPECT_NE(cache.find(1), nullptr);
+    EXPECT_EQ(cache.find(2), nullptr);
+    EXPECT_NE(cache.find(3), nullptr);
+    EXPECT_NE(cache.find(4), nullptr);
+}
+
+TEST(LruCacheTest, ClearEmptiesTheCache) {
+    LruCache<int, int> cache(2);
+    cache.insert(1, 1);
+    cache.clear();
+
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.find(1), nullptr);
+    cache.insert(2, 2);
+    EXPECT_EQ(*cache.find(2), 2);
+}
@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+#include "furious/scripting/native_effect.hpp"
+#include "furious/scripting/script_engine.hpp"
+#include "furious/core/tempo.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+namespace furious {
+namespace {
+
+class NativeEffectsTest : public ::testing::Test {
+protected:
+    std::vector<std::unique_ptr<NativeEffect>> effects = builtin_native_effects();
+    Tempo tempo{120.0};
+    TimelineClip clip;
+
+    const NativeEffect& effect(std::string_view id) {
+        for (const auto& native : effects) {
+            if (native->info().id == id) return *native;
+        }
+        throw std::runtime_error("missing native effect");
+    }
+
+    EffectContext context_at(double clip_local_beats) {
+        EffectContext context;
+        context.clip = &clip;
+        context.tempo = &tempo;
+        context.clip_local_beats = clip_local_beats;
+        context.accumulated.position_x = clip.position_x;
+        context.accumulated.position_y = clip.position_y;
+        context.accumulated.scale_x = clip.scale_x;
+        context.accumulated.scale_y = clip.scale_y;
+        context.accumulated.rotation = clip.rotation;
+        return context;
+    }
+
+    static EffectParameterValue ordinal(int value) {
+        EffectParameterValue param;
+        param.type = EffectParameterType::Enum;
+        param.ordinal = value;
+        return param;
+    }
+
+    static EffectParameterValue flag(bool value) {
+        EffectParameterValue param;
+        param.type = EffectParameterType::Bool;
+        param.flag = value;
+        return param;
+    }
+
+    static EffectParameterValue number(double value) {
+        EffectParameterValue param;
+        param.type = EffectParameterType::Number;
+        param.number = value;
+        return param;
+    }
+};
+
+// Copies a bundled reference script under "lua_<id>" so the engine loads it
+// alongside the native port that shadows the original id.
+std::string copy_bundled_script(const std::string& id) {
+    std::ifstream in(std::filesystem::path(FURIOUS_SOURCE_DIR) / "scripts" / "effects" / (id + ".lua"));
+    std::stringstream source;
+    source << in.rdbuf();
+    std::string script = source.str();
+    std::string declared = "id = \"" + id + "\"";
+    size_t at = script.find(declared);
+    if (at == std::string::npos) throw std::runtime_error("bundled script not found: " + id);
+    script.replace(at, declared.size(), "id = \"lua_" + id + "\"");
+
+    auto dir = std::filesystem::temp_directory_path() / ("furious_parity_" + id);
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / ("lua_" + id + ".lua")) << script;
+    return dir.string();
+}
+
+class NativeParityTest : public ::testing::Test {
+protected:
+    ScriptEngine engine;
+    Tempo tempo{128.0};
+    TimelineClip clip;
+
+    void SetUp() override {
+        ASSERT_TRUE(engine.initialize());
+        engine.add_effect_directory(copy_bundled_script("auto_ytpmv"));
+        engine.add_effect_directory(copy_bundled_script("lerp_transform"));
+        engine.scan_effect_directories();
+        ASSERT_NE(engine.find_effect("lua_auto_ytpmv"), nullptr);
+        ASSERT_NE(engine.find_effect("lua_lerp_transform"), nullptr);
+        ASSERT_TRUE(engine.find_effect("auto_ytpmv")->native);
+        ASSERT_TRUE(engine.find_effect("lerp_transform")->native);
+
+        clip.start_beat = 8.0;
+        clip.duration_beats = 16.0;
+        clip.source_start_seconds = 2.5;
+        clip.position_x = 10.0f;
+        clip.position_y = -4.0f;
+        clip.scale_x = -1.5f;
+        clip.scale_y = 0.75f;
+        clip.rotation = 15.0f;
+    }
+
+    EffectResult evaluate(const std::string& effect_id,
+                          const std::unordered_map<std::string, std::string>& parameters, double clip_local_beats) {
+        ClipEffect effect;
+        effect.effect_id = effect_id;
+        effect.parameters = parameters;
+
+        EffectContext context;
+        context.clip = &clip;
+        context.tempo = &tempo;
+        context.clip_local_beats = clip_local_beats;
+        context.current_beats = clip.start_beat + clip_local_beats;
+        context.accumulated.position_x = clip.position_x;
+        context.accumulated.position_y = clip.position_y;
+        context.accumulated.scale_x = clip.scale_x;
+        context.accumulated.scale_y = clip.scale_y;
+        context.accumulated.rotation = clip.rotation;
+        return engine.evaluate_effect(effect, context);
+    }
+
+    static void expect_same(const std::optional<float>& native, const std::optional<float>& lua) {
+        ASSERT_EQ(native.has_value(), lua.has_value());
+        if (native) EXPECT_NEAR(*native, *lua, 1e-4f);
+    }
+
+    // Evaluates the native port and its Lua reference at each beat and
+    // expects the same result from both.
+    void expect_parity(const std::string& id, const std::unordered_map<std::string, std::string>& parameters) {
+        for (int step = 0; step <= 48; ++step) {
+            double beat = step * 0.185;
+            SCOPED_TRACE("beat " + std::to_string(beat));
+            EffectResult native = evaluate(id, parameters, beat);
+            EffectResult lua = evaluate("lua_" + id, parameters, beat);
+
+            EXPECT_NEAR(native.source_position_seconds, lua.source_position_seconds, 1e-9);
+            EXPECT_EQ(native.use_looped_frame, lua.use_looped_frame);
+            EXPECT_NEAR(native.loop_start_seconds, lua.loop_start_seconds, 1e-9);
+            EXPECT_NEAR(native.loop_duration_seconds, lua.loop_duration_seconds, 1e-9);
+            EXPECT_NEAR(native.position_in_loop_seconds, lua.position_in_loop_seconds, 1e-9);
+            EXPECT_EQ(native.use_looped_audio, lua.use_looped_audio);
+            EXPECT_NEAR(native.audio_loop_start_seconds, lua.audio_loop_start_seconds, 1e-9);
+            EXPECT_NEAR(native.audio_loop_duration_seconds, lua.audio_loop_duration_seconds, 1e-9);
+            expect_same(native.position_x, lua.position_x);
+            expect_same(native.position_y, lua.position_y);
+            expect_same(native.scale_x, lua.scale_x);
+            expect_same(native.scale_y, lua.scale_y);
+            expect_same(native.rotation, lua.rotation);
+        }
+    }
+};
+
+TEST_F(NativeEffectsTest, BuiltinsMatchTheBundledScriptIds) {
+    EXPECT_TRUE(effect("auto_ytpmv").info().native);
+    EXPECT_EQ(effect("auto_ytpmv").info().parameters.size(), 3u);
+    EXPECT_EQ(effect("lerp_transform").info().parameters.size(), 9u);
+    EXPECT_EQ(effect("lerp_transform").info().parameters[1].enum_values.size(), 16u);
+}
+
+TEST_F(NativeEffectsTest, AutoYtpmvLoopsEachPeriodAndFlipsOddOnes) {
+    clip.source_start_seconds = 3.0;
+    std::vector<EffectParameterValue> params = {ordinal(3), flag(true), flag(false)};
+
+    EffectResult first = effect("auto_ytpmv").evaluate(context_at(0.25), params);
+    EXPECT_TRUE(first.use_looped_frame);
+    EXPECT_DOUBLE_EQ(first.loop_start_seconds, 3.0);
+    EXPECT_DOUBLE_EQ(first.loop_duration_seconds, 0.5);
+    EXPECT_DOUBLE_EQ(first.position_in_loop_seconds, 0.125);
+    EXPECT_FLOAT_EQ(*first.scale_x, 1.0f);
+
+    EffectResult second = effect("auto_ytpmv").evaluate(context_at(1.5), params);
+    EXPECT_DOUBLE_EQ(second.position_in_loop_seconds, 0.25);
+    EXPECT_FLOAT_EQ(*second.scale_x, -1.0f);
+    EXPECT_FLOAT_EQ(*second.scale_y, 1.0f);
+}
+
+TEST_F(NativeEffectsTest, LerpTransformEasesTowardsTargets) {
+    clip.position_x = 10.0f;
+    std::vector<EffectParameterValue> params = {
+        ordinal(3), ordinal(5), number(20.0), number(0.0),
+        number(1.0), number(1.0), number(90.0), flag(false), flag(false)};
+
+    EffectResult halfway = effect("lerp_transform").evaluate(context_at(0.5), params);
+    EXPECT_FLOAT_EQ(*halfway.position_x, 12.5f);
+    EXPECT_FLOAT_EQ(*halfway.rotation, 22.5f);
+
+    EffectResult done = effect("lerp_transform").evaluate(context_at(4.0), params);
+    EXPECT_FLOAT_EQ(*done.position_x, 20.0f);
+    EXPECT_FLOAT_EQ(*done.rotation, 90.0f);
+}
+
+TEST_F(NativeEffectsTest, LerpTransformPingPongsWhenLooping) {
+    std::vector<EffectParameterValue> params = {
+        ordinal(3), ordinal(1), number(0.0), number(0.0),
+        number(1.0), number(1.0), number(100.0), flag(true), flag(true)};
+
+    EXPECT_FLOAT_EQ(*effect("lerp_transform").evaluate(context_at(0.25), params).rotation, 25.0f);
+    EXPECT_FLOAT_EQ(*effect("lerp_transform").evaluate(context_at(1.25), params).rotation, 75.0f);
+    EXPECT_FLOAT_EQ(*effect("lerp_transform").evaluate(context_at(2.25), params).rotation, 25.0f);
+}
+
+TEST_F(NativeParityTest, AutoYtpmvMatchesItsReferenceScript) {
+    const EffectInfo& info = *engine.find_effect("auto_ytpmv");
+    for (const std::string& period : info.parameters[0].enum_values) {
+        for (const char* flip_h : {"false", "true"}) {
+            for (const char* flip_v : {"false", "true"}) {
+                SCOPED_TRACE(period + " " + flip_h + " " + flip_v);
+                expect_parity("auto_ytpmv", {
+                    {"Sync Period", period}, {"Flip Horizontal", flip_h}, {"Flip Vertical", flip_v}});
+            }
+        }
+    }
+}
+
+TEST_F(NativeParityTest, LerpTransformMatchesItsReferenceScript) {
+    const EffectInfo& info = *engine.find_effect("lerp_transform");
+    for (const std::string& duration : info.parameters[0].enum_values) {
+        for (const std::string& easing : info.parameters[1].enum_values) {
+            for (const char* loop : {"false", "true"}) {
+                for (const char* ping_pong : {"false", "true"}) {
+                    SCOPED_TRACE(duration + " " + easing + " " + loop + " " + ping_pong);
+                    // Target Y and Target Rotation keep their @clip defaults.
+                    expect_parity("lerp_transform", {
+                        {"Duration", duration}, {"Easing", easing},
+                        {"Target X", "-30"}, {"Target Scale X", "0.5"}, {"Target Scale Y", "-2"},
+                        {"Loop", loop}, {"Ping Pong", ping_pong}});
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+} // namespace furious
@@ -371,5 +371,48 @@ TEST_F(PatternEvaluatorTest, RestartOnTriggerIsPerProperty) {
     EXPECT_FALSE(result4.restart_clip);
 }
 
+TEST_F(PatternEvaluatorTest, MarkedEditsAreRecompiled) {
+    std::string id = create_pattern_with_trigger(PatternTargetProperty::ScaleX, 0, 2.0f);
+    clip.patterns.push_back({id, true, 0});
+
+    auto before = evaluator.evaluate(clip, 0.0);
+    ASSERT_TRUE(before.scale_x.has_value());
+    EXPECT_FLOAT_EQ(*before.scale_x, 2.0f);
+
+    library.find_pattern(id)->triggers[0].value = 5.0f;
+    library.mark_pattern_modified(id);
+
+    auto after = evaluator.evaluate(clip, 0.0);
+    ASSERT_TRUE(after.scale_x.has_value());
+    EXPECT_FLOAT_EQ(*after.scale_x, 5.0f);
+}
+
+TEST_F(PatternEvaluatorTest, LongPatternMatchesNearestTrigger) {
+    std::string id = library.create_pattern("Long");
+    Pattern* p = library.find_pattern(id);
+    p->length_subdivisions = 256;
+    for (int i = 0; i < 40; ++i) {
+        p->triggers.push_back({(i * 37) % 256, PatternTargetProperty::PositionY, static_cast<float>(i)});
+    }
+    const Pattern pattern = *p;
+    clip.patterns.push_back({id, true, 0});
+
+    for (int subdivision = 0; subdivision < 256; ++subdivision) {
+        int best_distance = 257;
+        float expected = 0.0f;
+        for (const auto& trigger : pattern.triggers) {
+            int distance = (subdivision - trigger.subdivision_index + 256) % 256;
+            if (distance < best_distance) {
+                best_distance = distance;
+                expected = trigger.value;
+            }
+        }
+
+        auto result = evaluator.evaluate(clip, subdivision / 4.0);
+        ASSERT_TRUE(result.position_y.has_value());
+        EXPECT_FLOAT_EQ(*result.position_y, expected) << "subdivision " << subdivision;
+    }
+}
+
 } // namespace
 } // namespace furious
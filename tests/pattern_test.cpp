@@ -93,6 +93,56 @@ TEST_F(ClipPatternReferenceTest, CustomValues) {
     EXPECT_EQ(ref.offset_subdivisions, 4);
 }
 
+TEST_F(PatternTest, CompileEmptyPattern) {
+    CompiledPattern compiled = pattern.compile();
+    EXPECT_TRUE(compiled.empty());
+}
+
+TEST_F(PatternTest, CompileHoldsNearestPrecedingTriggerWithWrap) {
+    pattern.triggers.push_back({4, PatternTargetProperty::ScaleX, 2.0f});
+    pattern.triggers.push_back({12, PatternTargetProperty::ScaleX, 3.0f});
+    pattern.triggers.push_back({8, PatternTargetProperty::Rotation, 45.0f});
+
+    CompiledPattern compiled = pattern.compile();
+    ASSERT_FALSE(compiled.empty());
+    EXPECT_EQ(compiled.length_subdivisions, 16);
+
+    auto scale_x = static_cast<size_t>(PatternTargetProperty::ScaleX);
+    auto rotation = static_cast<size_t>(PatternTargetProperty::Rotation);
+    auto position_x = static_cast<size_t>(PatternTargetProperty::PositionX);
+
+    EXPECT_TRUE(compiled.has_property[scale_x]);
+    EXPECT_TRUE(compiled.has_property[rotation]);
+    EXPECT_FALSE(compiled.has_property[position_x]);
+
+    EXPECT_FLOAT_EQ(compiled.held_at(0)[scale_x], 3.0f);
+    EXPECT_FLOAT_EQ(compiled.held_at(4)[scale_x], 2.0f);
+    EXPECT_FLOAT_EQ(compiled.held_at(11)[scale_x], 2.0f);
+    EXPECT_FLOAT_EQ(compiled.held_at(15)[scale_x], 3.0f);
+    EXPECT_FLOAT_EQ(compiled.held_at(3)[rotation], 45.0f);
+    EXPECT_FALSE(compiled.has_restarts);
+}
+
+TEST_F(PatternTest, CompileBuildsRestartIntervals) {
+    pattern.scale_x_settings.restart_on_trigger = true;
+    pattern.triggers.push_back({0, PatternTargetProperty::ScaleX, 1.0f});
+    pattern.triggers.push_back({4, PatternTargetProperty::ScaleX, 1.0f});
+    pattern.triggers.push_back({4, PatternTargetProperty::ScaleX, 2.0f});
+    pattern.triggers.push_back({10, PatternTargetProperty::PositionX, 5.0f});
+
+    CompiledPattern compiled = pattern.compile();
+    ASSERT_TRUE(compiled.has_restarts);
+
+    EXPECT_TRUE(compiled.restarts[0]);
+    EXPECT_TRUE(compiled.restarts[4]);
+    EXPECT_FALSE(compiled.restarts[10]);
+
+    EXPECT_EQ(compiled.loop_start[2], 0);
+    EXPECT_EQ(compiled.loop_interval[2], 4);
+    EXPECT_EQ(compiled.loop_start[9], 4);
+    EXPECT_EQ(compiled.loop_interval[9], 12);
+}
+
 class PatternLibraryTest : public ::testing::Test {
 protected:
     PatternLibrary library;
@@ -195,5 +245,76 @@ TEST_F(PatternLibraryTest, FindPatternMutable) {
     EXPECT_EQ(library.find_pattern(id)->name, "Modified Name");
 }
 
+TEST_F(PatternLibraryTest, LookupsDoNotInvalidateCompiledPattern) {
+    std::string id = library.create_pattern("Cached");
+    library.find_pattern(id)->triggers.push_back({0, PatternTargetProperty::ScaleX, 2.0f});
+    ClipPatternReference ref;
+    ref.pattern_id = id;
+
+    const CompiledPattern* compiled = library.compiled_pattern(ref);
+    uint64_t revision = library.pattern_revision(ref);
+    ASSERT_NE(compiled, nullptr);
+
+    (void)library.find_pattern(id);
+    (void)library.find_pattern(library.handle_of(id));
+    EXPECT_EQ(library.pattern_revision(ref), revision);
+    EXPECT_EQ(library.compiled_pattern(ref), compiled);
+}
+
+TEST_F(PatternLibraryTest, MarkAndUpdateInvalidatePattern) {
+    std::string id = library.create_pattern("Edited");
+    ClipPatternReference ref;
+    ref.pattern_id = id;
+    uint64_t revision = library.pattern_revision(ref);
+
+    library.find_pattern(id)->length_subdivisions = 8;
+    library.mark_pattern_modified(id);
+    EXPECT_NE(library.pattern_revision(ref), revision);
+    revision = library.pattern_revision(ref);
+
+    Pattern state = *library.find_pattern(id);
+    state.id = "ignored";
+    state.name = "Replaced";
+    library.update_pattern(id, state);
+    EXPECT_NE(library.pattern_revision(ref), revision);
+    EXPECT_EQ(library.find_pattern(id)->name, "Replaced");
+    EXPECT_EQ(library.find_pattern(id)->id, id);
+}
+
+TEST_F(PatternLibraryTest, FindPatternByHandle) {
+    std::string first = library.create_pattern("First");
+    std::string second = library.create_pattern("Second");
+    PatternHandle handle = library.handle_of(second);
+
+    ASSERT_NE(library.find_pattern(handle), nullptr);
+    EXPECT_EQ(library.find_pattern(handle)->name, "Second");
+
+    library.remove_pattern(first);
+    ASSERT_NE(library.find_pattern(handle), nullptr);
+    EXPECT_EQ(library.find_pattern(handle)->name, "Second");
+
+    library.remove_pattern(second);
+    EXPECT_EQ(library.find_pattern(handle), nullptr);
+}
+
+TEST_F(PatternLibraryTest, ReferenceCachesHandle) {
+    std::string id = library.create_pattern("Cached");
+    ClipPatternReference ref;
+    ref.pattern_id = id;
+
+    ASSERT_NE(library.find_pattern(ref), nullptr);
+    EXPECT_EQ(ref.pattern_handle, library.handle_of(id));
+
+    library.clear();
+    EXPECT_EQ(library.find_pattern(ref), nullptr);
+
+    Pattern pattern;
+    pattern.id = id;
+    pattern.name = "Reloaded";
+    library.add_pattern(pattern);
+    ASSERT_NE(library.find_pattern(ref), nullptr);
+    EXPECT_EQ(library.find_pattern(ref)->name, "Reloaded");
+}
+
 } // namespace
 } // namespace furious
@@ -29,6 +29,8 @@ TEST_F(ProjectDataTest, DefaultValues) {
     EXPECT_DOUBLE_EQ(data.bpm, 120.0);
     EXPECT_EQ(data.grid_subdivision, NoteSubdivision::Quarter);
     EXPECT_DOUBLE_EQ(data.fps, 30.0);
+    EXPECT_EQ(data.output_width, 1920);
+    EXPECT_EQ(data.output_height, 1080);
     EXPECT_FALSE(data.metronome_enabled);
     EXPECT_TRUE(data.follow_playhead);
     EXPECT_FALSE(data.loop_enabled);
@@ -40,6 +42,8 @@ TEST_F(ProjectDataTest, SaveAndLoadRoundTrip) {
     original.bpm = 140.0;
     original.grid_subdivision = NoteSubdivision::Eighth;
     original.fps = 60.0;
+    original.output_width = 1280;
+    original.output_height = 720;
     original.metronome_enabled = true;
     original.audio_filepath = "/path/to/audio.wav";
 
@@ -52,6 +56,8 @@ TEST_F(ProjectDataTest, SaveAndLoadRoundTrip) {
     EXPECT_DOUBLE_EQ(loaded.bpm, original.bpm);
     EXPECT_EQ(loaded.grid_subdivision, original.grid_subdivision);
     EXPECT_DOUBLE_EQ(loaded.fps, original.fps);
+    EXPECT_EQ(loaded.output_width, original.output_width);
+    EXPECT_EQ(loaded.output_height, original.output_height);
     EXPECT_EQ(loaded.metronome_enabled, original.metronome_enabled);
     EXPECT_EQ(loaded.audio_filepath, original.audio_filepath);
 }
@@ -93,6 +99,18 @@ TEST_F(ProjectDataTest, GridSubdivisionRoundTrip) {
     }
 }
 
+TEST_F(ProjectDataTest, AudioSampleFormatRoundTrip) {
+    for (auto format : {SampleFormat::Float32, SampleFormat::Int16, SampleFormat::Float16}) {
+        ProjectData original;
+        original.audio_sample_format = format;
+        ASSERT_TRUE(original.save_to_file(test_file_.string()));
+
+        ProjectData loaded;
+        ASSERT_TRUE(ProjectData::load_from_file(test_file_.string(), loaded));
+        EXPECT_EQ(loaded.audio_sample_format, format);
+    }
+}
+
 TEST_F(ProjectDataTest, ClipTransformPropertiesRoundTrip) {
     ProjectData original;
 
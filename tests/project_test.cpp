@@ -45,3 +45,18 @@ TEST_F(ProjectTest, FpsCanBeSet) {
     project.set_fps(60.0);
     EXPECT_DOUBLE_EQ(project.fps(), 60.0);
 }
+
+TEST_F(ProjectTest, DefaultResolutionIs1080p) {
+    EXPECT_EQ(project.width(), 1920);
+    EXPECT_EQ(project.height(), 1080);
+}
+
+TEST_F(ProjectTest, ResolutionIsAtLeastOnePixel) {
+    project.set_resolution(1280, 720);
+    EXPECT_EQ(project.width(), 1280);
+    EXPECT_EQ(project.height(), 720);
+
+    project.set_resolution(0, -5);
+    EXPECT_EQ(project.width(), 1);
+    EXPECT_EQ(project.height(), 1);
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include "furious/scripting/script_cache.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace furious {
+namespace {
+
+class ScriptCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root = std::filesystem::temp_directory_path() / "furious_script_cache_test";
+        std::filesystem::remove_all(root);
+        cache = ScriptCache(root);
+        cache.set_format("Lua 5.4");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(root);
+    }
+
+    std::filesystem::path root;
+    ScriptCache cache{std::filesystem::path{}};
+};
+
+TEST_F(ScriptCacheTest, MissReturnsNothing) {
+    EXPECT_FALSE(cache.load("return 1").has_value());
+}
+
+TEST_F(ScriptCacheTest, StoreThenLoadReturnsBytecode) {
+    std::string bytecode("\x1bLua\0chunk", 10);
+    ASSERT_TRUE(cache.store("return 1", bytecode));
+
+    auto loaded = cache.load("return 1");
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(*loaded, bytecode);
+}
+
+TEST_F(ScriptCacheTest, EntriesAreKeyedBySourceAndFormat) {
+    ASSERT_TRUE(cache.store("return 1", "chunk"));
+    EXPECT_FALSE(cache.load("return 2").has_value());
+
+    cache.set_format("Lua 5.5");
+    EXPECT_FALSE(cache.load("return 1").has_value());
+}
+
+TEST_F(ScriptCacheTest, DisabledCacheDoesNothing) {
+    cache.set_enabled(false);
+    EXPECT_FALSE(cache.store("return 1", "chunk"));
+    EXPECT_FALSE(cache.load("return 1").has_value());
+}
+
+#ifndef _WIN32
+TEST(ScriptCacheDefaultTest, NoPerUserDirectoryDisablesTheCache) {
+    auto saved = [](const char* name) -> std::optional<std::string> {
+        const char* value = std::getenv(name);
+        return value ? std::optional<std::string>(value) : std::nullopt;
+    };
+    auto xdg = saved("XDG_CACHE_HOME");
+    auto home = saved("HOME");
+    unsetenv("XDG_CACHE_HOME");
+    unsetenv("HOME");
+
+    ScriptCache cache;
+    EXPECT_TRUE(cache.directory().empty());
+    EXPECT_FALSE(cache.store("return 1", "chunk"));
+
+    if (xdg) setenv("XDG_CACHE_HOME", xdg->c_str(), 1);
+    if (home) setenv("HOME", home->c_str(), 1);
+}
+#endif
+
+} // namespace
+} // namespace furious
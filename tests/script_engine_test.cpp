@@ -1,10 +1,33 @@
 #include "furious/scripting/script_engine.hpp"
+#include "furious/scripting/script_cache.hpp"
+#include "furious/core/project.hpp"
 #include "furious/core/tempo.hpp"
+#include "furious/core/timeline_data.hpp"
 #include <gtest/gtest.h>
+#include <chrono>
 #include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 
 using namespace furious;
 
+namespace {
+
+std::string write_effect_script(const std::string& id, const std::string& evaluate_body,
+                                const std::string& parameters = "") {
+    auto dir = std::filesystem::temp_directory_path() / ("furious_effect_" + id);
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / (id + ".lua"))
+        << "effect = { id = \"" << id << "\", name = \"" << id << "\", parameters = {"
+        << parameters << "} }\n"
+        << "function evaluate(context, params)\n" << evaluate_body << "\nend\n";
+    return dir.string();
+}
+
+} // namespace
+
 TEST(ScriptEngineTest, InitializeAndShutdown) {
     ScriptEngine engine;
     EXPECT_FALSE(engine.is_initialized());
@@ -129,3 +152,666 @@ TEST(ScriptEngineTest, EvaluateDisabledEffectSkipsIt) {
     EXPECT_FALSE(result.use_looped_frame);
 }
 
+
+TEST(ScriptEngineTest, ParamsFollowEffectEdits) {
+    ScriptEngine engine;
+    engine.initialize();
+    engine.add_effect_directory(write_effect_script("param_scale",
+        "context.result.scale_x = tonumber(params.amount) or 0\n"
+        "return context.result"));
+    engine.scan_effect_directories();
+
+    TimelineData data;
+    data.add_track("Track 1");
+    TimelineClip clip;
+    clip.id = "clip";
+    ClipEffect effect;
+    effect.effect_id = "param_scale";
+    effect.parameters["amount"] = "2";
+    clip.effects.push_back(effect);
+    data.add_clip(clip);
+    engine.set_timeline_data(&data);
+
+    TimelineClip* stored = data.find_clip("clip");
+    ASSERT_NE(stored, nullptr);
+    EffectContext context;
+    context.clip = stored;
+
+    EffectResult first = engine.evaluate_effects(stored->effects, context);
+    ASSERT_TRUE(first.scale_x.has_value());
+    EXPECT_FLOAT_EQ(*first.scale_x, 2.0f);
+
+    stored->effects[0].parameters["amount"] = "3";
+    EffectResult second = engine.evaluate_effects(stored->effects, context);
+    ASSERT_TRUE(second.scale_x.has_value());
+    EXPECT_FLOAT_EQ(*second.scale_x, 3.0f);
+}
+
+TEST(ScriptEngineTest, ReusedResultTableIsClearedBetweenCalls) {
+    ScriptEngine engine;
+    engine.initialize();
+    engine.add_effect_directory(write_effect_script("early_move",
+        "if context.clip_local_beats < 1 then context.result.position_x = 5 end\n"
+        "return context.result"));
+    engine.scan_effect_directories();
+
+    TimelineClip clip;
+    ClipEffect effect;
+    effect.effect_id = "early_move";
+    clip.effects.push_back(effect);
+
+    Tempo tempo(120.0);
+    EffectContext context;
+    context.clip = &clip;
+    context.tempo = &tempo;
+
+    context.clip_local_beats = 0.5;
+    EXPECT_TRUE(engine.evaluate_effects(clip.effects, context).position_x.has_value());
+
+    context.clip_local_beats = 2.0;
+    EXPECT_FALSE(engine.evaluate_effects(clip.effects, context).position_x.has_value());
+}
+
+TEST(EffectParameterTest, ParsesAgainstDeclaredType) {
+    EffectParameter number{"Amount", "number", "1.5", {}, EffectParameterType::Number};
+    EXPECT_DOUBLE_EQ(parse_effect_parameter(number, "2.25").number, 2.25);
+    EXPECT_DOUBLE_EQ(parse_effect_parameter(number, "junk").number, 1.5);
+
+    EffectParameter flag{"Loop", "bool", "false", {}, EffectParameterType::Bool};
+    EXPECT_TRUE(parse_effect_parameter(flag, "true").flag);
+    EXPECT_FALSE(parse_effect_parameter(flag, "maybe").flag);
+
+    EffectParameter choice{"Period", "enum", "1/4", {"1/8", "1/4", "1/2"}, EffectParameterType::Enum};
+    EXPECT_EQ(parse_effect_parameter(choice, "1/2").ordinal, 3);
+    EXPECT_EQ(parse_effect_parameter(choice, "bogus").ordinal, 2);
+}
+
+TEST(EffectParameterTest, ClipReferencesStayUnresolved) {
+    EffectParameter target{"Target X", "number", "@clip.position_x", {}, EffectParameterType::Number};
+
+    auto from_default = parse_effect_parameter(target, target.default_value);
+    ASSERT_TRUE(from_default.clip_reference.has_value());
+    EXPECT_EQ(*from_default.clip_reference, PatternTargetProperty::PositionX);
+
+    auto explicit_value = parse_effect_parameter(target, "12");
+    EXPECT_FALSE(explicit_value.clip_reference.has_value());
+    EXPECT_DOUBLE_EQ(explicit_value.number, 12.0);
+}
+
+TEST(ScriptEngineTest, DeclaredParametersReachScriptsTyped) {
+    ScriptEngine engine;
+    engine.initialize();
+    engine.add_effect_directory(write_effect_script("typed_params",
+        "local r = context.result\n"
+        "if type(params.amount) == 'number' then r.position_x = params.amount end\n"
+        "if params.mode == 2 then r.scale_x = 2 end\n"
+        "if params.on == true then r.rotation = 90 end\n"
+        "r.position_y = params.target\n"
+        "return r",
+        "{ name = 'amount', type = 'number', default = '0.5' },"
+        "{ name = 'mode', type = 'enum', default = 'a', values = { 'a', 'b' } },"
+        "{ name = 'on', type = 'bool', default = 'false' },"
+        "{ name = 'target', type = 'number', default = '@clip.position_y' }"));
+    engine.scan_effect_directories();
+
+    TimelineClip clip;
+    clip.position_y = 7.0f;
+    ClipEffect effect;
+    effect.effect_id = "typed_params";
+    effect.parameters["mode"] = "b";
+    effect.parameters["on"] = "true";
+    clip.effects.push_back(effect);
+
+    EffectContext context;
+    context.clip = &clip;
+    EffectResult result = engine.evaluate_effects(clip.effects, context);
+
+    ASSERT_TRUE(result.position_x.has_value());
+    EXPECT_FLOAT_EQ(*result.position_x, 0.5f);
+    ASSERT_TRUE(result.scale_x.has_value());
+    ASSERT_TRUE(result.rotation.has_value());
+    ASSERT_TRUE(result.position_y.has_value());
+    EXPECT_FLOAT_EQ(*result.position_y, 7.0f);
+}
+
+TEST(ScriptEngineTest, EffectGlobalsDoNotLeakBetweenScripts) {
+    auto dir = std::filesystem::temp_directory_path() / "furious_effect_isolated";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    for (const auto& [id, offset] : {std::pair{"first", 1}, std::pair{"second", 2}}) {
+        std::ofstream(dir / (std::string(id) + ".lua"))
+            << "effect = { id = \"" << id << "\", name = \"" << id << "\", parameters = {} }\n"
+            << "offset = " << offset << "\n"
+            << "function evaluate(context, params)\n"
+            << "context.result.position_x = offset\nreturn context.result\nend\n";
+    }
+
+    ScriptEngine engine;
+    engine.initialize();
+    engine.add_effect_directory(dir.string());
+    engine.scan_effect_directories();
+
+    TimelineClip clip;
+    EffectContext context;
+    context.clip = &clip;
+
+    ClipEffect first;
+    first.effect_id = "first";
+    ClipEffect second;
+    second.effect_id = "second";
+
+    EffectResult first_result = engine.evaluate_effects({first}, context);
+    EffectResult second_result = engine.evaluate_effects({second}, context);
+    ASSERT_TRUE(first_result.position_x.has_value());
+    ASSERT_TRUE(second_result.position_x.has_value());
+    EXPECT_FLOAT_EQ(*first_result.position_x, 1.0f);
+    EXPECT_FLOAT_EQ(*second_result.position_x, 2.0f);
+}
+
+TEST(ScriptEngineTest, BatchMatchesSingleEvaluation) {
+    ScriptEngine engine;
+    engine.initialize();
+    engine.add_effect_directory(write_effect_script("beat_move",
+        "context.result.position_x = context.clip_local_beats * 10\n"
+        "return context.result"));
+    engine.scan_effect_directories();
+
+    TimelineClip clip;
+    ClipEffect effect;
+    effect.effect_id = "beat_move";
+    clip.effects.push_back(effect);
+
+    std::vector<EffectJob> jobs(256);
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        jobs[i].effects = &clip.effects;
+        jobs[i].context.clip = &clip;
+        jobs[i].context.clip_local_beats = static_cast<double>(i) * 0.25;
+    }
+
+    std::vector<EffectResult> results;
+    engine.evaluate_effects_batch(jobs, results);
+
+    ASSERT_EQ(results.size(), jobs.size());
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        EffectResult single = engine.evaluate_effects(clip.effects, jobs[i].context);
+        ASSERT_TRUE(results[i].position_x.has_value());
+        EXPECT_FLOAT_EQ(*results[i].position_x, *single.position_x);
+    }
+}
+
+TEST(ScriptEngineTest, ClipsStayInOneStateAcrossBatches) {
+    ScriptEngine engine;
+    engine.initialize();
+    engine.add_effect_directory(write_effect_script("counter",
+        "calls = calls or {}\n"
+        "local id = context.clip.id\n"
+        "calls[id] = (calls[id] or 0) + 1\n"
+        "context.result.position_x = calls[id]\n"
+        "return context.result"));
+    engine.scan_effect_directories();
+
+    TimelineData data;
+    ClipEffect effect;
+    effect.effect_id = "counter";
+    for (int i = 0; i < 128; ++i) {
+        TimelineClip clip;
+        clip.id = "clip" + std::to_string(i);
+        clip.effects.push_back(effect);
+        data.add_clip(clip);
+    }
+    engine.set_timeline_data(&data);
+
+    std::vector<EffectJob> jobs(data.clips().size());
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        jobs[i].effects = &data.clips()[i].effects;
+        jobs[i].context.clip = &data.clips()[i];
+    }
+
+    std::vector<EffectResult> results;
+    for (int round = 1; round <= 3; ++round) {
+        engine.evaluate_effects_batch(jobs, results);
+        ASSERT_EQ(results.size(), jobs.size());
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            ASSERT_TRUE(results[i].position_x.has_value());
+            EXPECT_FLOAT_EQ(*results[i].position_x, static_cast<float>(round)) << "clip " << i;
+        }
+    }
+
+    EffectResult single = engine.evaluate_effects(jobs[5].context.clip->effects, jobs[5].context);
+    ASSERT_TRUE(single.position_x.has_value());
+    EXPECT_FLOAT_EQ(*single.position_x, 4.0f);
+}
+
+TEST(ScriptEngineTest, EffectsCannotChangeTheProject) {
+    Project project;
+    ScriptEngine engine;
+    engine.set_project(&project);
+    engine.initialize();
+    engine.add_effect_directory(write_effect_script("tempo_writer",
+        "if furious.project.set_bpm then furious.project.set_bpm(60) end\n"
+        "context.result.position_x = furious.project.bpm()\n"
+        "return context.result"));
+    engine.scan_effect_directories();
+    double bpm = project.tempo().bpm();
+
+    TimelineClip clip;
+    ClipEffect effect;
+    effect.effect_id = "tempo_writer";
+    EffectContext context;
+    context.clip = &clip;
+    EffectResult result = engine.evaluate_effects({effect}, context);
+
+    ASSERT_TRUE(result.position_x.has_value());
+    EXPECT_FLOAT_EQ(*result.position_x, static_cast<float>(bpm));
+    EXPECT_DOUBLE_EQ(project.tempo().bpm(), bpm);
+}
+
+TEST(ScriptEngineTest, ReloadPicksUpOnlyChangedScripts) {
+    std::string dir = write_effect_script("reloaded",
+        "context.result.position_x = 1\nreturn context.result");
+    auto script = std::filesystem::path(dir) / "reloaded.lua";
+
+    ScriptEngine engine;
+    engine.initialize();
+    engine.script_cache().set_directory(std::filesystem::path(dir) / "cache");
+    engine.add_effect_directory(dir);
+    engine.scan_effect_directories();
+    EXPECT_FALSE(engine.reload_changed_effects());
+
+    std::ofstream(script, std::ios::trunc)
+        << "effect = { id = \"reloaded\", name = \"reloaded\", parameters = {} }\n"
+        << "function evaluate(context, params)\n"
+        << "context.result.position_x = 2\nreturn context.result\nend\n";
+    std::filesystem::last_write_time(script,
+        std::filesystem::last_write_time(script) + std::chrono::seconds(5));
+    EXPECT_TRUE(engine.reload_changed_effects());
+
+    TimelineClip clip;
+    ClipEffect effect;
+    effect.effect_id = "reloaded";
+    EffectContext context;
+    context.clip = &clip;
+    EffectResult result = engine.evaluate_effects({effect}, context);
+    ASSERT_TRUE(result.position_x.has_value());
+    EXPECT_FLOAT_EQ(*result.position_x, 2.0f);
+    EXPECT_EQ(engine.available_effects().size(), 1u);
+
+    std::filesystem::remove(script);
+    EXPECT_TRUE(engine.reload_changed_effects());
+    EXPECT_EQ(engine.find_effect("reloaded"), nullptr);
+}
+
+TEST(ScriptEngineTest, CorruptCacheEntriesAreRebuiltFromSource) {
+    std::string dir = write_effect_script("cached",
+        "context.result.position_x = 3\nreturn context.result");
+    std::ifstream stream(std::filesystem::path(dir) / "cached.lua", std::ios::binary);
+    std::string source((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    ScriptEngine engine;
+    engine.initialize();
+    engine.script_cache().set_directory(std::filesystem::path(dir) / "cache");
+    ASSERT_TRUE(engine.script_cache().store(source, std::string("\x1bLua\x54\0trunc", 10)));
+    engine.add_effect_directory(dir);
+    engine.scan_effect_directories();
+
+    ASSERT_NE(engine.find_effect("cached"), nullptr);
+    auto entry = engine.script_cache().load(source);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_GT(entry->size(), 10u);
+
+    TimelineClip clip;
+    ClipEffect effect;
+    effect.effect_id = "cached";
+    EffectContext context;
+    context.clip = &clip;
+    EffectResult result = engine.evaluate_effects({effect}, context);
+    ASSERT_TRUE(result.position_x.has_value());
+    EXPECT_FLOAT_EQ(*result.position_x, 3.0f);
+}
+
+TEST(ScriptEngineTest, GarbageIsCollectedOnlyWhenAsked) {
+    ScriptEngine engine;
+    engine.initialize();
+    engine.add_effect_directory(write_effect_script("garbage",
+        "for i = 1, 20000 do local t = { i, i + 1, i + 2 } end\n"
+        "return context.result"));
+    engine.scan_effect_directories();
+
+    ScriptGcStats baseline = engine.collect_garbage(1.0, true);
+    EXPECT_GT(baseline.heap_bytes, 0u);
+
+    TimelineClip clip;
+    ClipEffect effect;
+    effect.effect_id = "garbage";
+    EffectContext context;
+    context.clip = &clip;
+    engine.evaluate_effects({effect}, context);
+
+    ScriptGcStats idle = engine.collect_garbage(1.0, true);
+    EXPECT_TRUE(idle.full_collection);
+    EXPECT_LT(idle.heap_bytes, baseline.heap_bytes * 2);
+}
+
+TEST(ScriptEngineTest, RunawayScriptIsAbortedAndLastResultReused) {
+    ScriptEngine engine;
+    engine.initialize();
+    engine.add_effect_directory(write_effect_script("runaway",
+        "if context.clip_local_beats > 1 then while true do end end\n"
+        "context.result.position_x = 4\nreturn context.result"));
+    engine.scan_effect_directories();
+    engine.set_instruction_budget(50000);
+
+    TimelineData data;
+    data.add_track("Track 1");
+    TimelineClip clip;
+    clip.id = "clip";
+    ClipEffect effect;
+    effect.effect_id = "runaway";
+    clip.effects.push_back(effect);
+    data.add_clip(clip);
+    engine.set_timeline_data(&data);
+
+    TimelineClip* stored = data.find_clip("clip");
+    ASSERT_NE(stored, nullptr);
+    EffectContext context;
+    context.clip = stored;
+
+    context.clip_local_beats = 0.5;
+    EffectResult good = engine.evaluate_effects(stored->effects, context);
+    ASSERT_TRUE(good.position_x.has_value());
+
+    context.clip_local_beats = 2.0;
+    EffectResult aborted = engine.evaluate_effects(stored->effects, context);
+    ASSERT_TRUE(aborted.position_x.has_value());
+    EXPECT_FLOAT_EQ(*aborted.position_x, 4.0f);
+
+    auto timings = engine.take_effect_timings();
+    ASSERT_EQ(timings.size(), 1u);
+    EXPECT_EQ(timings[0].effect_id, "runaway");
+    EXPECT_EQ(timings[0].calls, 2u);
+    EXPECT_EQ(timings[0].aborted, 1u);
+    EXPECT_TRUE(engine.find_effect("runaway")->slow);
+    EXPECT_TRUE(engine.take_effect_timings().empty());
+}
+
+TEST(ScriptEngineTest, SpanJobsUseEvaluateBatchWhenDefined) {
+    auto dir = std::filesystem::temp_directory_path() / "furious_effect_span";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "span.lua")
+        << "effect = { id = \"span\", name = \"span\", parameters = {} }\n"
+        << "function evaluate(context, params)\n"
+        << "context.result.rotation = context.clip_local_beats\nreturn context.result\nend\n"
+        << "function evaluate_batch(context, params, beats)\n"
+        << "for i = 1, #beats do context.results[i].rotation = beats[i] + 100 end\nend\n";
+    std::ofstream(dir / "plain.lua")
+        << "effect = { id = \"plain\", name = \"plain\", parameters = {} }\n"
+        << "function evaluate(context, params)\n"
+        << "context.result.position_x = context.current_beats\nreturn context.result\nend\n";
+
+    ScriptEngine engine;
+    engine.initialize();
+    engine.add_effect_directory(dir.string());
+    engine.scan_effect_directories();
+
+    TimelineClip clip;
+    clip.start_beat = 8.0;
+    ClipEffect span;
+    span.effect_id = "span";
+    ClipEffect plain;
+    plain.effect_id = "plain";
+    clip.effects = {span, plain};
+
+    EffectJob job;
+    job.effects = &clip.effects;
+    job.context.clip = &clip;
+    job.context.current_beats = clip.start_beat;
+    job.clip_local_beats = {0.0, 0.5, 1.0};
+
+    std::vector<EffectResult> results;
+    engine.evaluate_effects_batch({job}, results);
+
+    ASSERT_EQ(results.size(), 3u);
+    for (size_t i = 0; i < results.size(); ++i) {
+        ASSERT_TRUE(results[i].rotation.has_value());
+        ASSERT_TRUE(results[i].position_x.has_value());
+        EXPECT_FLOAT_EQ(*results[i].rotation, static_cast<float>(job.clip_local_beats[i] + 100));
+        EXPECT_FLOAT_EQ(*results[i].position_x, static_cast<float>(8.0 + job.clip_local_beats[i]));
+    }
+}
+
+TEST(ScriptEngineTest, SpanFallsBackAfterAnEarlierEffectMovesTheClip) {
+    auto dir = std::filesystem::temp_directory_path() / "furious_effect_span_chain";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "mover.lua")
+        << "effect = { id = \"mover\", name = \"mover\", parameters = {} }\n"
+        << "function evaluate(context, params)\n"
+        << "context.result.scale_x = context.clip_local_beats\nreturn context.result\nend\n";
+    std::ofstream(dir / "follower.lua")
+        << "effect = { id = \"follower\", name = \"follower\", parameters = {} }\n"
+        << "function evaluate(context, params)\n"
+        << "context.result.rotation = context.clip.scale_x\nreturn context.result\nend\n"
+        << "function evaluate_batch(context, params, beats)\n"
+        << "for i = 1, #beats do context.results[i].rotation = -1 end\nend\n";
+
+    ScriptEngine engine;
+    engine.initialize();
+    engine.add_effect_directory(dir.string());
+    engine.scan_effect_directories();
+
+    TimelineClip clip;
+    ClipEffect mover;
+    mover.effect_id = "mover";
+    ClipEffect follower;
+    follower.effect_id = "follower";
+    clip.effects = {mover, follower};
+
+    EffectJob job;
+    job.effects = &clip.effects;
+    job.context.clip = &clip;
+    job.clip_local_beats = {1.0, 2.0};
+
+    std::vector<EffectResult> results;
+    engine.evaluate_effects_batch({job}, results);
+
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_FLOAT_EQ(*results[0].rotation, 1.0f);
+    EXPECT_FLOAT_EQ(*results[1].rotation, 2.0f);
+}
+
+TEST(ScriptEngineTest, NativeEffectsAreListedAndShadowScripts) {
+    std::string dir = write_effect_script("lerp_transform",
+        "context.result.position_x = 999\nreturn context.result");
+
+    ScriptEngine engine;
+    engine.initialize();
+    engine.add_effect_directory(dir);
+    engine.scan_effect_directories();
+
+    const EffectInfo* info = engine.find_effect("lerp_transform");
+    ASSERT_NE(info, nullptr);
+    EXPECT_TRUE(info->native);
+    ASSERT_NE(engine.find_effect("auto_ytpmv"), nullptr);
+
+    TimelineClip clip;
+    clip.position_x = 4.0f;
+    ClipEffect effect;
+    effect.effect_id = "lerp_transform";
+    effect.parameters["Target X"] = "8";
+    Tempo tempo(120.0);
+    EffectContext context;
+    context.clip = &clip;
+    context.tempo = &tempo;
+    context.clip_local_beats = 0.5;
+
+    EffectResult result = engine.evaluate_effects({effect}, context);
+    ASSERT_TRUE(result.position_x.has_value());
+    EXPECT_FLOAT_EQ(*result.position_x, 6.0f);
+}
+
+TEST(ScriptEngineTest, PureEffectsAreEvaluatedOncePerFrame) {
+    auto dir = std::filesystem::temp_directory_path() / "furious_effect_pure";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "pure.lua")
+        << "effect = { id = \"pure\", name = \"pure\", pure = true, parameters = {} }\n"
+        << "calls = 0\n"
+        << "function evaluate(context, params)\n"
+        << "calls = calls + 1\n"
+        << "context.result.rotation = context.clip_local_beats\n"
+        << "context.result.scale_x = calls\nreturn context.result\nend\n";
+
+    Project project;
+    project.set_fps(10.0);
+    ScriptEngine engine;
+    engine.set_project(&project);
+    engine.initialize();
+    engine.add_effect_directory(dir.string());
+    engine.scan_effect_directories();
+    ASSERT_TRUE(engine.find_effect("pure")->pure);
+
+    TimelineData data;
+    data.add_track("Track 1");
+    TimelineClip clip;
+    clip.id = "clip";
+    ClipEffect effect;
+    effect.effect_id = "pure";
+    clip.effects.push_back(effect);
+    data.add_clip(clip);
+    engine.set_timeline_data(&data);
+
+    Tempo tempo(60.0);
+    EffectContext context;
+    context.clip = data.find_clip("clip");
+    context.tempo = &tempo;
+
+    // At 60 BPM and 10 fps a frame is a tenth of a beat.
+    context.clip_local_beats = 1.23;
+    EffectResult first = engine.evaluate_effects(context.clip->effects, context);
+    context.clip_local_beats = 1.27;
+    EffectResult same_frame = engine.evaluate_effects(context.clip->effects, context);
+    EXPECT_NEAR(*first.rotation, 1.2f, 1e-5);
+    EXPECT_FLOAT_EQ(*same_frame.scale_x, 1.0f);
+    EXPECT_FLOAT_EQ(*same_frame.rotation, *first.rotation);
+
+    context.clip_local_beats = 1.31;
+    EffectResult next_frame = engine.evaluate_effects(context.clip->effects, context);
+    EXPECT_FLOAT_EQ(*next_frame.scale_x, 2.0f);
+
+    data.find_clip("clip")->effects[0].parameters["amount"] = "2";
+    EffectResult edited = engine.evaluate_effects(context.clip->effects, context);
+    EXPECT_FLOAT_EQ(*edited.scale_x, 3.0f);
+
+    auto timings = engine.take_effect_timings();
+    ASSERT_EQ(timings.size(), 1u);
+    EXPECT_EQ(timings[0].calls, 3u);
+    EXPECT_EQ(timings[0].memo_hits, 1u);
+}
+
+TEST(ScriptEngineTest, ChangingTheFpsMissesThePureEffectCache) {
+    auto dir = std::filesystem::temp_directory_path() / "furious_effect_pure_fps";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "beat.lua")
+        << "effect = { id = \"beat\", name = \"beat\", pure = true, parameters = {} }\n"
+        << "function evaluate(context, params)\n"
+        << "context.result.rotation = context.clip_local_beats\n"
+        << "return context.result\nend\n";
+
+    Project project;
+    project.set_fps(10.0);
+    ScriptEngine engine;
+    engine.set_project(&project);
+    engine.initialize();
+    engine.add_effect_directory(dir.string());
+    engine.scan_effect_directories();
+
+    TimelineData data;
+    data.add_track("Track 1");
+    TimelineClip clip;
+    clip.id = "clip";
+    ClipEffect effect;
+    effect.effect_id = "beat";
+    clip.effects.push_back(effect);
+    data.add_clip(clip);
+    engine.set_timeline_data(&data);
+
+    // At 60 BPM a beat is a second: frame 12 starts at beat 1.2 at 10 fps
+    // and at beat 0.6 at 20 fps.
+    Tempo tempo(60.0);
+    EffectContext context;
+    context.clip = data.find_clip("clip");
+    context.tempo = &tempo;
+    context.clip_local_beats = 1.23;
+    EffectResult at_ten = engine.evaluate_effects(context.clip->effects, context);
+    EXPECT_NEAR(*at_ten.rotation, 1.2f, 1e-5);
+
+    project.set_fps(20.0);
+    context.clip_local_beats = 0.61;
+    EffectResult at_twenty = engine.evaluate_effects(context.clip->effects, context);
+    EXPECT_NEAR(*at_twenty.rotation, 0.6f, 1e-5);
+
+    auto timings = engine.take_effect_timings();
+    ASSERT_EQ(timings.size(), 1u);
+    EXPECT_EQ(timings[0].calls, 2u);
+    EXPECT_EQ(timings[0].memo_hits, 0u);
+}
+
+TEST(ScriptEngineTest, MovingAClipMissesThePureEffectCache) {
+    auto dir = std::filesystem::temp_directory_path() / "furious_effect_pure_placement";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "placement.lua")
+        << "effect = { id = \"placement\", name = \"placement\", pure = true, parameters = {} }\n"
+        << "function evaluate(context, params)\n"
+        << "context.result.position_x = context.clip.start_beat\n"
+        << "context.result.position_y = context.clip.track_index\n"
+        << "context.result.rotation = context.current_beats\n"
+        << "return context.result\nend\n";
+
+    Project project;
+    project.set_fps(10.0);
+    ScriptEngine engine;
+    engine.set_project(&project);
+    engine.initialize();
+    engine.add_effect_directory(dir.string());
+    engine.scan_effect_directories();
+
+    TimelineData data;
+    data.add_track("Track 1");
+    data.add_track("Track 2");
+    TimelineClip clip;
+    clip.id = "clip";
+    clip.start_beat = 4.0;
+    clip.duration_beats = 8.0;
+    ClipEffect effect;
+    effect.effect_id = "placement";
+    clip.effects.push_back(effect);
+    data.add_clip(clip);
+    engine.set_timeline_data(&data);
+
+    Tempo tempo(60.0);
+    EffectContext context;
+    context.clip = data.find_clip("clip");
+    context.tempo = &tempo;
+    context.clip_local_beats = 1.0;
+    context.current_beats = 5.0;
+
+    EffectResult before = engine.evaluate_effects(context.clip->effects, context);
+    EXPECT_FLOAT_EQ(*before.position_x, 4.0f);
+    EXPECT_FLOAT_EQ(*before.rotation, 5.0f);
+
+    data.set_clip_span("clip", 10.0, 8.0, 1);
+    context.clip = data.find_clip("clip");
+    context.current_beats = 11.0;
+    EffectResult moved = engine.evaluate_effects(context.clip->effects, context);
+    EXPECT_FLOAT_EQ(*moved.position_x, 10.0f);
+    EXPECT_FLOAT_EQ(*moved.position_y, 1.0f);
+    EXPECT_FLOAT_EQ(*moved.rotation, 11.0f);
+
+    auto timings = engine.take_effect_timings();
+    ASSERT_EQ(timings.size(), 1u);
+    EXPECT_EQ(timings[0].calls, 2u);
+    EXPECT_EQ(timings[0].memo_hits, 0u);
+}
@@ -0,0 +1,124 @@
+#include "furious/scripting/script_job.hpp"
+#include "furious/core/timeline_data.hpp"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+using namespace furious;
+
+namespace {
+
+std::string write_job_script(const std::string& name, const std::string& run_body) {
+    auto dir = std::filesystem::temp_directory_path() / "furious_jobs";
+    std::filesystem::create_directories(dir);
+    auto path = dir / (name + ".lua");
+    std::ofstream(path)
+        << "job = { name = \"" << name << "\" }\n"
+        << "function run(context)\n" << run_body << "\nend\n";
+    return path.string();
+}
+
+class ScriptJobTest : public ::testing::Test {
+protected:
+    TimelineData data;
+    ScriptJobRunner runner;
+
+    void SetUp() override {
+        data.add_track("Track 1");
+        runner.set_timeline_data(&data);
+    }
+
+    ScriptJobStatus run_to_end(double budget_ms, int* resumes = nullptr) {
+        ScriptJobStatus status = runner.status();
+        for (int i = 0; i < 100000 && status == ScriptJobStatus::Running; ++i) {
+            status = runner.resume(budget_ms);
+            if (resumes) ++*resumes;
+        }
+        return status;
+    }
+};
+
+} // namespace
+
+TEST_F(ScriptJobTest, EditsLandAsOneUndoableCommand) {
+    TimelineClip existing;
+    existing.id = "existing";
+    existing.source_id = "src";
+    data.add_clip(existing);
+
+    std::string path = write_job_script("fill",
+        "for i = 0, 15 do\n"
+        "  furious.timeline.add_clip{ source_id = 'src', start_beat = context.playhead_beats + i,"
+        " duration_beats = 0.5 }\n"
+        "end\n"
+        "furious.timeline.remove_clip('existing')");
+
+    ScriptJobContext context;
+    context.playhead_beats = 8.0;
+    ASSERT_TRUE(runner.start(path, context)) << runner.last_error();
+    EXPECT_EQ(runner.job_name(), "fill");
+    EXPECT_EQ(runner.take_command(), nullptr);
+
+    EXPECT_EQ(run_to_end(100.0), ScriptJobStatus::Finished);
+    EXPECT_EQ(data.clips().size(), 1u);
+
+    std::unique_ptr<Command> command = runner.take_command();
+    ASSERT_NE(command, nullptr);
+    EXPECT_EQ(runner.take_command(), nullptr);
+
+    CommandHistory history;
+    history.execute(std::move(command));
+    EXPECT_EQ(data.clips().size(), 16u);
+    EXPECT_EQ(data.find_clip("existing"), nullptr);
+    EXPECT_EQ(data.clips_at_beat(8.25).size(), 1u);
+
+    history.undo();
+    ASSERT_EQ(data.clips().size(), 1u);
+    EXPECT_NE(data.find_clip("existing"), nullptr);
+}
+
+TEST_F(ScriptJobTest, LongJobsYieldAcrossFrames) {
+    std::string path = write_job_script("slow",
+        "local x = 0\n"
+        "for i = 1, 2000000 do x = x + i end\n"
+        "furious.timeline.add_clip{ source_id = 'src', start_beat = 0 }");
+
+    ASSERT_TRUE(runner.start(path, {}));
+    int resumes = 0;
+    EXPECT_EQ(run_to_end(0.0, &resumes), ScriptJobStatus::Finished);
+    EXPECT_GT(resumes, 1);
+    EXPECT_NE(runner.take_command(), nullptr);
+}
+
+TEST_F(ScriptJobTest, ReadsSeeStagedEdits) {
+    std::string path = write_job_script("reads",
+        "local id = furious.timeline.add_clip{ source_id = 'src', start_beat = 2, duration_beats = 1 }\n"
+        "furious.timeline.modify_clip(id, { rotation = 45 })\n"
+        "assert(furious.timeline.clip(id).rotation == 45)\n"
+        "assert(#furious.timeline.clips_in_range(0, 4) == 1)\n"
+        "furious.timeline.remove_clip(id)\n"
+        "assert(furious.timeline.clip(id) == nil)");
+
+    ASSERT_TRUE(runner.start(path, {}));
+    EXPECT_EQ(run_to_end(100.0), ScriptJobStatus::Finished) << runner.last_error();
+    EXPECT_EQ(runner.take_command(), nullptr);
+}
+
+TEST_F(ScriptJobTest, FailedOrCancelledJobsLeaveNoEdits) {
+    std::string failing = write_job_script("failing",
+        "furious.timeline.add_clip{ source_id = 'src' }\n"
+        "furious.timeline.add_clip{ source_id = 'src', track_index = 5 }");
+
+    ASSERT_TRUE(runner.start(failing, {}));
+    EXPECT_EQ(run_to_end(100.0), ScriptJobStatus::Failed);
+    EXPECT_FALSE(runner.last_error().empty());
+    EXPECT_EQ(runner.take_command(), nullptr);
+
+    std::string endless = write_job_script("endless", "while true do end");
+    ASSERT_TRUE(runner.start(endless, {}));
+    EXPECT_EQ(runner.resume(1.0), ScriptJobStatus::Running);
+    EXPECT_FALSE(runner.start(endless, {}));
+    runner.cancel();
+    EXPECT_EQ(runner.status(), ScriptJobStatus::Idle);
+    EXPECT_EQ(runner.take_command(), nullptr);
+}
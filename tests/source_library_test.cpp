@@ -1,11 +1,26 @@
 #include "furious/video/source_library.hpp"
+#include "furious/audio/audio_buffer.hpp"
 #include "furious/core/media_source.hpp"
 #include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
 
 using namespace furious;
 
 class SourceLibraryTest : public ::testing::Test {
 protected:
+    void SetUp() override {
+        root = std::filesystem::temp_directory_path() / "furious_source_library_test";
+        std::filesystem::remove_all(root);
+        std::filesystem::create_directories(root);
+        library.audio_cache().set_directory(root / "cache");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(root);
+    }
+
+    std::filesystem::path root;
     SourceLibrary library;
 };
 
@@ -80,3 +95,95 @@ TEST_F(SourceLibraryTest, AddSourceDirect) {
     EXPECT_EQ(found->name, "My Video");
     EXPECT_EQ(found->width, 1920);
 }
+
+TEST_F(SourceLibraryTest, FindSourceByHandle) {
+    std::string first = library.add_source("/a.png");
+    std::string second = library.add_source("/b.png");
+    SourceHandle handle = library.handle_of(second);
+
+    ASSERT_NE(library.find_source(handle), nullptr);
+    EXPECT_EQ(library.find_source(handle)->id, second);
+
+    library.remove_source(first);
+    ASSERT_NE(library.find_source(handle), nullptr);
+    EXPECT_EQ(library.find_source(handle)->id, second);
+
+    library.clear();
+    EXPECT_EQ(library.find_source(handle), nullptr);
+}
+
+TEST_F(SourceLibraryTest, ClipCachesSourceHandle) {
+    std::string id = library.add_source("/image.png");
+    TimelineClip clip;
+    clip.source_id = id;
+
+    const MediaSource* found = library.find_source(clip);
+    ASSERT_NE(found, nullptr);
+    EXPECT_EQ(found->id, id);
+    EXPECT_EQ(clip.source_handle, library.handle_of(id));
+
+    clip.source_id = "missing";
+    clip.source_handle = {};
+    EXPECT_EQ(library.find_source(clip), nullptr);
+}
+
+TEST_F(SourceLibraryTest, WideningLossyAudioIsNotCached) {
+    std::string path = (root / "clip.mp4").string();
+    std::ofstream(path) << "not a media file";
+
+    MediaSource source;
+    source.id = "lossy";
+    source.filepath = path;
+    source.type = MediaType::Video;
+    source.audio_buffer = std::make_shared<const AudioBuffer>(
+        AudioBuffer(std::vector<float>{0.25f, -0.5f}, 44100, 2, SampleFormat::Int16));
+    library.add_source_direct(source);
+
+    library.set_sample_format(SampleFormat::Int16);
+    library.set_sample_format(SampleFormat::Float32);
+    EXPECT_TRUE(library.poll_reencoded_audio(true));
+
+    const MediaSource* found = library.find_source("lossy");
+    ASSERT_NE(found, nullptr);
+    ASSERT_NE(found->audio_buffer, nullptr);
+    EXPECT_EQ(found->audio_buffer->format(), SampleFormat::Float32);
+    EXPECT_EQ(library.audio_cache().load(path, SampleFormat::Float32, 44100, 2), nullptr);
+}
+
+TEST_F(SourceLibraryTest, FormatChangesSwapBuffersOnlyWhenPolled) {
+    MediaSource source;
+    source.id = "audio";
+    source.filepath = (root / "missing.mp4").string();
+    source.type = MediaType::Video;
+    auto original = std::make_shared<const AudioBuffer>(
+        AudioBuffer(std::vector<float>{0.25f, -0.5f}, 44100, 2, SampleFormat::Float32));
+    source.audio_buffer = original;
+    library.add_source_direct(source);
+
+    library.set_sample_format(SampleFormat::Int16);
+    EXPECT_TRUE(library.reencoding());
+    EXPECT_EQ(library.find_source("audio")->audio_buffer, original);
+
+    EXPECT_TRUE(library.poll_reencoded_audio(true));
+    EXPECT_FALSE(library.reencoding());
+    EXPECT_EQ(library.find_source("audio")->audio_buffer->format(), SampleFormat::Int16);
+    EXPECT_FALSE(library.poll_reencoded_audio());
+}
+
+TEST_F(SourceLibraryTest, BuffersReplacedDuringAReencodeAreKept) {
+    MediaSource source;
+    source.id = "audio";
+    source.filepath = (root / "missing.mp4").string();
+    source.type = MediaType::Video;
+    source.audio_buffer = std::make_shared<const AudioBuffer>(
+        AudioBuffer(std::vector<float>{0.25f, -0.5f}, 44100, 2, SampleFormat::Float32));
+    library.add_source_direct(source);
+
+    library.set_sample_format(SampleFormat::Int16);
+    auto replacement = std::make_shared<const AudioBuffer>(
+        AudioBuffer(std::vector<float>{0.5f, 0.5f}, 44100, 2, SampleFormat::Int16));
+    library.find_source("audio")->audio_buffer = replacement;
+
+    EXPECT_FALSE(library.poll_reencoded_audio(true));
+    EXPECT_EQ(library.find_source("audio")->audio_buffer, replacement);
+}
@@ -61,3 +61,11 @@ TEST_F(TempoTest, TimeToSubdivision) {
     EXPECT_EQ(tempo.time_to_subdivision(1.0, NoteSubdivision::Eighth), 4);
     EXPECT_EQ(tempo.time_to_subdivision(1.0, NoteSubdivision::Sixteenth), 8);
 }
+
+TEST_F(TempoTest, GenerationMovesWhenBpmChanges) {
+    uint64_t generation = tempo.generation();
+    tempo.set_bpm(120.0);
+    EXPECT_EQ(tempo.generation(), generation);
+    tempo.set_bpm(140.0);
+    EXPECT_NE(tempo.generation(), generation);
+}
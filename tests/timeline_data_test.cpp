@@ -306,3 +306,205 @@ TEST(TimelineClipTransformTest, IndependentScaleAxes) {
     EXPECT_FLOAT_EQ(clip.scale_x, 3.0f);  
     EXPECT_FLOAT_EQ(clip.scale_y, 0.25f);
 }
+
+class TimelineIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        data.add_track("Track 2");
+        data.add_track("Track 3");
+    }
+
+    std::vector<std::string> ids_at(double beat) {
+        std::vector<std::string> ids;
+        for (TimelineClip* clip : data.clips_at_beat(beat)) {
+            ids.push_back(clip->id);
+        }
+        return ids;
+    }
+
+    void add(const std::string& id, size_t track, double start, double duration) {
+        TimelineClip clip;
+        clip.id = id;
+        clip.track_index = track;
+        clip.start_beat = start;
+        clip.duration_beats = duration;
+        data.add_clip(clip);
+    }
+
+    TimelineData data;
+};
+
+TEST_F(TimelineIndexTest, PointQueryOrderedByTrackThenStart) {
+    add("c", 2, 0.0, 8.0);
+    add("b", 0, 2.0, 4.0);
+    add("a", 0, 0.0, 4.0);
+
+    EXPECT_EQ(ids_at(3.0), (std::vector<std::string>{"a", "b", "c"}));
+    EXPECT_EQ(ids_at(4.0), (std::vector<std::string>{"b", "c"}));
+    EXPECT_EQ(ids_at(8.0), std::vector<std::string>{});
+}
+
+TEST_F(TimelineIndexTest, LongClipBehindShortOnesIsFound) {
+    add("long", 0, 0.0, 100.0);
+    for (int i = 1; i < 50; ++i) {
+        add("short" + std::to_string(i), 0, static_cast<double>(i), 0.5);
+    }
+
+    EXPECT_EQ(ids_at(60.0), std::vector<std::string>{"long"});
+}
+
+TEST_F(TimelineIndexTest, SpanEditsAreReindexed) {
+    add("a", 0, 0.0, 4.0);
+    EXPECT_EQ(ids_at(1.0).size(), 1u);
+
+    data.set_clip_span("a", 10.0, 4.0, 1);
+
+    EXPECT_TRUE(ids_at(1.0).empty());
+    EXPECT_EQ(ids_at(11.0), std::vector<std::string>{"a"});
+    EXPECT_EQ(data.clips_on_track(1).size(), 1u);
+    EXPECT_TRUE(data.clips_on_track(0).empty());
+}
+
+TEST_F(TimelineIndexTest, SpanEditsThroughHeldPointerAreReindexed) {
+    add("a", 0, 0.0, 4.0);
+    TimelineClip* clip = data.find_clip("a");
+    EXPECT_EQ(ids_at(1.0).size(), 1u);
+
+    data.set_clip_span(clip->id, 20.0, 2.0, clip->track_index);
+    EXPECT_TRUE(ids_at(1.0).empty());
+    EXPECT_EQ(ids_at(21.0), std::vector<std::string>{"a"});
+}
+
+TEST_F(TimelineIndexTest, UpdateClipReindexesAndKeepsId) {
+    add("a", 0, 0.0, 4.0);
+    TimelineClip moved = *data.find_clip("a");
+    moved.id = "ignored";
+    moved.start_beat = 12.0;
+    moved.track_index = 2;
+    uint64_t generation = data.generation();
+
+    data.update_clip("a", moved);
+    EXPECT_NE(data.generation(), generation);
+    EXPECT_TRUE(ids_at(1.0).empty());
+    EXPECT_EQ(ids_at(13.0), std::vector<std::string>{"a"});
+    EXPECT_EQ(data.clips_on_track(2).size(), 1u);
+}
+
+TEST_F(TimelineIndexTest, MovingOneOfSeveralEqualStartsRemovesOnlyThatClip) {
+    add("a", 0, 4.0, 1.0);
+    add("b", 0, 4.0, 2.0);
+    add("c", 0, 4.0, 3.0);
+    EXPECT_EQ(ids_at(4.5).size(), 3u);
+
+    data.set_clip_span("b", 10.0, 2.0, 0);
+    EXPECT_EQ(ids_at(4.5), (std::vector<std::string>{"a", "c"}));
+    EXPECT_EQ(ids_at(5.5), std::vector<std::string>{"c"});
+    EXPECT_EQ(ids_at(11.0), std::vector<std::string>{"b"});
+}
+
+TEST_F(TimelineIndexTest, RemoveKeepsIndexConsistent) {
+    add("a", 0, 0.0, 4.0);
+    add("b", 0, 4.0, 4.0);
+    add("c", 0, 8.0, 4.0);
+    EXPECT_EQ(ids_at(5.0), std::vector<std::string>{"b"});
+
+    data.remove_clip("a");
+    EXPECT_EQ(ids_at(5.0), std::vector<std::string>{"b"});
+    EXPECT_EQ(ids_at(9.0), std::vector<std::string>{"c"});
+    EXPECT_TRUE(ids_at(1.0).empty());
+}
+
+TEST_F(TimelineIndexTest, RangeQueryFindsOverlaps) {
+    add("a", 0, 0.0, 4.0);
+    add("b", 1, 4.0, 4.0);
+    add("c", 2, 8.0, 4.0);
+
+    auto hits = data.clips_in_range(3.0, 8.0);
+    ASSERT_EQ(hits.size(), 2u);
+    EXPECT_EQ(hits[0]->id, "a");
+    EXPECT_EQ(hits[1]->id, "b");
+}
+
+TEST_F(TimelineIndexTest, FindAvailableTrackUsesIndex) {
+    add("a", 0, 0.0, 4.0);
+    add("b", 1, 2.0, 4.0);
+
+    EXPECT_EQ(data.find_available_track(1.0, 2.0), 2u);
+    EXPECT_EQ(data.find_available_track(4.0, 1.0), 0u);
+    EXPECT_EQ(data.find_available_track(6.0, 1.0), 0u);
+}
+
+TEST_F(TimelineIndexTest, MatchesLinearScanOnManyClips) {
+    for (int i = 0; i < 500; ++i) {
+        add("clip" + std::to_string(i), static_cast<size_t>(i % 3),
+            static_cast<double>((i * 37) % 211) * 0.25, 0.5 + static_cast<double>(i % 7));
+    }
+
+    for (double beat = 0.0; beat < 60.0; beat += 0.37) {
+        size_t expected = 0;
+        for (const auto& clip : data.clips()) {
+            if (clip.contains_beat(beat)) ++expected;
+        }
+        EXPECT_EQ(data.clips_at_beat(beat).size(), expected) << "beat " << beat;
+    }
+}
+
+TEST_F(TimelineIndexTest, RemovingAClipReleasesItsHandle) {
+    add("a", 0, 0.0, 4.0);
+    add("b", 1, 0.0, 4.0);
+
+    ClipHandle handle = data.handle_of(*data.find_clip("b"));
+    ASSERT_TRUE(handle.is_valid());
+    EXPECT_EQ(data.find_clip(handle)->id, "b");
+
+    TimelineClip copy = *data.find_clip("b");
+    EXPECT_EQ(data.handle_of(copy), handle);
+
+    data.remove_clip("a");
+    EXPECT_EQ(data.find_clip(handle)->id, "b");
+
+    data.remove_clip("b");
+    EXPECT_EQ(data.find_clip(handle), nullptr);
+
+    data.add_clip(copy);
+    ClipHandle readded = data.handle_of(*data.find_clip("b"));
+    EXPECT_NE(readded, handle);
+    EXPECT_EQ(data.find_clip(handle), nullptr);
+    EXPECT_EQ(data.find_clip(readded)->id, "b");
+}
+
+TEST_F(TimelineIndexTest, ReleasedHandleIndicesAreReused) {
+    for (int round = 0; round < 10; ++round) {
+        add("clip" + std::to_string(round), 0, 0.0, 4.0);
+        data.remove_clip("clip" + std::to_string(round));
+    }
+    add("last", 0, 0.0, 4.0);
+
+    EXPECT_EQ(data.handle_of(*data.find_clip("last")).index, 0u);
+}
+
+TEST_F(TimelineIndexTest, ClearRetiresClipHandles) {
+    add("a", 0, 0.0, 4.0);
+    ClipHandle handle = data.handle_of(data.clips()[0]);
+
+    data.clear();
+    add("a", 0, 0.0, 4.0);
+
+    EXPECT_EQ(data.find_clip(handle), nullptr);
+    EXPECT_NE(data.find_clip("a"), nullptr);
+}
+
+TEST_F(TimelineIndexTest, GenerationMovesOnlyWithEdits) {
+    add("a", 0, 0.0, 4.0);
+    uint64_t generation = data.generation();
+
+    EXPECT_EQ(data.clips_at_beat(1.0).size(), 1u);
+    EXPECT_EQ(data.generation(), generation);
+
+    data.set_clip_span("a", 8.0, 4.0, 0);
+    EXPECT_NE(data.generation(), generation);
+    generation = data.generation();
+
+    data.remove_clip("a");
+    EXPECT_NE(data.generation(), generation);
+}
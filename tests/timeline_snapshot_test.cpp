@@ -0,0 +1,118 @@
+#include "furious/core/timeline_data.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+
+using namespace furious;
+
+namespace {
+
+class TimelineSnapshotTest : public ::testing::Test {
+protected:
+    TimelineData data;
+
+    void add(const std::string& id, size_t track, double start, double duration) {
+        while (data.track_count() <= track) {
+            data.add_track();
+        }
+        TimelineClip clip;
+        clip.id = id;
+        clip.track_index = track;
+        clip.start_beat = start;
+        clip.duration_beats = duration;
+        data.add_clip(clip);
+    }
+};
+
+} // namespace
+
+TEST_F(TimelineSnapshotTest, NothingPublishedUntilAsked) {
+    add("a", 0, 0.0, 4.0);
+    EXPECT_EQ(data.snapshot(), nullptr);
+
+    data.publish_snapshot();
+    auto snapshot = data.snapshot();
+    ASSERT_NE(snapshot, nullptr);
+    EXPECT_EQ(snapshot->clips().size(), 1u);
+    EXPECT_EQ(snapshot->generation(), data.generation());
+
+    data.publish_snapshot();
+    EXPECT_EQ(data.snapshot(), snapshot);
+}
+
+TEST_F(TimelineSnapshotTest, SnapshotsDoNotSeeLaterEdits) {
+    add("a", 0, 0.0, 4.0);
+    data.publish_snapshot();
+    auto before = data.snapshot();
+
+    data.set_clip_span("a", 8.0, 4.0, 0);
+    add("b", 0, 4.0, 4.0);
+    data.publish_snapshot();
+    auto after = data.snapshot();
+
+    ASSERT_EQ(before->clips().size(), 1u);
+    EXPECT_DOUBLE_EQ(before->find_clip("a")->start_beat, 0.0);
+    EXPECT_EQ(before->find_clip("b"), nullptr);
+    EXPECT_DOUBLE_EQ(after->find_clip("a")->start_beat, 8.0);
+    EXPECT_NE(after->find_clip("b"), nullptr);
+}
+
+TEST_F(TimelineSnapshotTest, UnchangedClipsAreShared) {
+    add("a", 0, 0.0, 4.0);
+    add("b", 0, 4.0, 4.0);
+    data.publish_snapshot();
+    auto before = data.snapshot();
+
+    TimelineClip* b = data.find_clip("b");
+    b->rotation = 45.0f;
+    data.mark_modified();
+    data.publish_snapshot();
+    auto after = data.snapshot();
+
+    EXPECT_EQ(&after->tracks(), &before->tracks());
+    EXPECT_EQ(after->find_clip("a"), before->find_clip("a"));
+    EXPECT_NE(after->find_clip("b"), before->find_clip("b"));
+    EXPECT_FLOAT_EQ(after->find_clip("b")->rotation, 45.0f);
+}
+
+TEST_F(TimelineSnapshotTest, QueriesMatchTimelineData) {
+    add("late", 1, 2.0, 4.0);
+    add("early", 1, 0.0, 4.0);
+    add("top", 0, 1.0, 1.0);
+    data.publish_snapshot();
+    auto snapshot = data.snapshot();
+
+    auto at = snapshot->clips_at_beat(2.5);
+    ASSERT_EQ(at.size(), 2u);
+    EXPECT_EQ(at[0]->id, "early");
+    EXPECT_EQ(at[1]->id, "late");
+
+    auto range = snapshot->clips_in_range(0.0, 2.0);
+    ASSERT_EQ(range.size(), 2u);
+    EXPECT_EQ(range[0]->id, "top");
+    EXPECT_EQ(range[1]->id, "early");
+
+    ClipHandle handle = data.handle_of(*data.find_clip("late"));
+    EXPECT_EQ(snapshot->find_clip(handle)->id, "late");
+}
+
+TEST_F(TimelineSnapshotTest, ReadersRunWhileEditing) {
+    data.publish_snapshot();
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        while (!done.load()) {
+            auto snapshot = data.snapshot();
+            for (const auto& clip : snapshot->clips()) {
+                EXPECT_FALSE(clip->id.empty());
+            }
+        }
+    });
+
+    for (int i = 0; i < 200; ++i) {
+        add("clip" + std::to_string(i), 0, i, 1.0);
+        data.publish_snapshot();
+    }
+    done = true;
+    reader.join();
+    EXPECT_EQ(data.snapshot()->clips().size(), 200u);
+}
@@ -35,6 +35,8 @@ TEST_F(VideoDecoderTest, SeekAndDecodeWhenNotOpenFails) {
 class VideoEngineTest : public ::testing::Test {
 protected:
     VideoEngine engine;
+    HandleTable<ClipTag> clip_handles;
+    HandleTable<SourceTag> source_handles;
 };
 
 TEST_F(VideoEngineTest, InitializeAndShutdown) {
@@ -44,12 +46,12 @@ TEST_F(VideoEngineTest, InitializeAndShutdown) {
 
 TEST_F(VideoEngineTest, GetTextureForNonexistentClipReturnsZero) {
     engine.initialize();
-    EXPECT_EQ(engine.get_texture("nonexistent_clip"), 0u);
+    EXPECT_EQ(engine.get_texture(clip_handles.intern("nonexistent_clip")), 0u);
 }
 
 TEST_F(VideoEngineTest, RequestFrameForNonexistentSourceDoesNotCrash) {
     engine.initialize();
-    engine.request_frame("clip1", "nonexistent_source", 0.0);
+    engine.request_frame(clip_handles.intern("clip1"), source_handles.intern("nonexistent_source"), 0.0);
 }
 
 TEST_F(VideoEngineTest, RegisterSourceWithNonexistentVideo) {
@@ -58,8 +60,8 @@ TEST_F(VideoEngineTest, RegisterSourceWithNonexistentVideo) {
     source.id = "test-source";
     source.filepath = "/nonexistent/video.mp4";
     source.type = MediaType::Video;
-    engine.register_source(source);
-    EXPECT_EQ(engine.get_texture("clip1"), 0u);
+    engine.register_source(source_handles.intern(source.id), source);
+    EXPECT_EQ(engine.get_texture(clip_handles.intern("clip1")), 0u);
 }
 
 TEST_F(VideoEngineTest, SetPlaying) {